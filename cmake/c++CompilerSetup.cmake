@@ -18,7 +18,8 @@
 ################################################################################
 
 if(USE_OMP)
-  LIST(APPEND EXTRA_CXX_FLAGS -fopenmp)
+  LIST(APPEND EXTRA_CXX_FLAGS -fopenmp -D__USE_OPENMP__)
+  LIST(APPEND EXTRA_LINK_FLAGS -fopenmp)
 endif()
 
 if(USE_DYNSAMPLES)
@@ -94,10 +95,6 @@ if(NOT EXTRA_LINK_FLAGS STREQUAL "")
   endif()
 endif()
 
-if(USE_OMP)
-  cmessage(FATAL_ERROR "No OMP features currently enabled so this is a FATAL_ERROR to let you know that you don't gain anything with this declaration.")
-endif()
-
 
 if (VERBOSE)
   cmessage (STATUS "C++ Compiler      : ${CXX_COMPILER_NAME}")
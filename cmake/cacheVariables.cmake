@@ -138,7 +138,7 @@ CheckAndSetDefault(NEED_PYTHIA8 FALSE)
 CheckAndSetDefault(NEED_ROOTEVEGEN FALSE)
 CheckAndSetDefault(NEED_ROOTPYTHIA6 FALSE)
 
-CheckAndSetDefaultCache(USE_OMP FALSE BOOL "Whether to enable multicore features (there currently are none...). <FALSE>")
+CheckAndSetDefaultCache(USE_OMP FALSE BOOL "Whether to enable multicore features (parallel covariance chi2). <FALSE>")
 
 CheckAndSetDefaultCache(USE_DYNSAMPLES FALSE BOOL "Whether to enable the dynamic sample loader. <FALSE>")
 
@@ -40,6 +40,7 @@ ANL_CC1npip_Evt_1Dppi_nu::ANL_CC1npip_Evt_1Dppi_nu(nuiskey samplekey) {
   fSettings.DefineAllowedSpecies("numu");
   fSettings.SetEnuRange(0.0, 1.5);
   FinaliseSampleSettings();
+  SetPreselection(14);
 
   // Scaling Setup ---------------------------------------------------
   // ScaleFactor automatically setup for DiffXSec/cm2/Nucleon
@@ -44,6 +44,7 @@ ANL_CC1pi0_Evt_1DcosmuStar_nu::ANL_CC1pi0_Evt_1DcosmuStar_nu(nuiskey samplekey)
   fSettings.DefineAllowedSpecies("numu");
 
   FinaliseSampleSettings();
+  SetPreselection(14);
 
   // Scaling Setup ---------------------------------------------------
   // ScaleFactor automatically setup for DiffXSec/cm2/Nucleon
@@ -56,6 +57,7 @@ ANL_CC1pi0_Evt_1DcosmuStar_nu::ANL_CC1pi0_Evt_1DcosmuStar_nu(nuiskey samplekey)
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fFitPhaseSafe = false;
 
 };
 
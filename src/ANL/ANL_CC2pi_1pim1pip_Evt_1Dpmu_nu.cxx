@@ -61,6 +61,7 @@ ANL_CC2pi_1pim1pip_Evt_1Dpmu_nu::ANL_CC2pi_1pim1pip_Evt_1Dpmu_nu(nuiskey samplek
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fFitPhaseSafe = false;
 
 };
 
@@ -39,6 +39,8 @@ ArgoNeuT_CCInc_XSec_1Dpmu_antinu::ArgoNeuT_CCInc_XSec_1Dpmu_antinu(nuiskey sampl
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fThreadSafe = true;
+  fSingleBinFill = true;
 
 };
 
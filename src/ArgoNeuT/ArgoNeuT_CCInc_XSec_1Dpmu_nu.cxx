@@ -57,6 +57,8 @@ ArgoNeuT_CCInc_XSec_1Dpmu_nu::ArgoNeuT_CCInc_XSec_1Dpmu_nu(nuiskey samplekey) {
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fThreadSafe = true;
+  fSingleBinFill = true;
 
 };
 
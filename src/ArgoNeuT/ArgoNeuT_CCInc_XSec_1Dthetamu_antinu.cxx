@@ -39,6 +39,8 @@ ArgoNeuT_CCInc_XSec_1Dthetamu_antinu::ArgoNeuT_CCInc_XSec_1Dthetamu_antinu(nuisk
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fThreadSafe = true;
+  fSingleBinFill = true;
 
 };
 
@@ -40,6 +40,8 @@ ArgoNeuT_CCInc_XSec_1Dthetamu_nu::ArgoNeuT_CCInc_XSec_1Dthetamu_nu(nuiskey sampl
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fThreadSafe = true;
+  fSingleBinFill = true;
 
 };
 
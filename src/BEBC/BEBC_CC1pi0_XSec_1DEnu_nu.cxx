@@ -45,6 +45,7 @@ BEBC_CC1pi0_XSec_1DEnu_nu::BEBC_CC1pi0_XSec_1DEnu_nu(nuiskey samplekey) {
   fSettings.SetDataInput(  FitPar::GetDataBase() + "/BEBC/theses/BEBC_theses_CC1pi0_W14.txt");
 
   FinaliseSampleSettings();
+  SetPreselection(14);
 
   // Scaling Setup ---------------------------------------------------
   // ScaleFactor automatically setup for DiffXSec/cm2/Nucleon
@@ -42,6 +42,7 @@ void SetPar(std::string const &name, bool val) { Get().SetConfig(name, val); }
 void SetPar(std::string const &name, int val) { Get().SetConfig(name, val); }
 void SetPar(std::string const &name, float val) { Get().SetConfig(name, val); }
 void SetPar(std::string const &name, double val) { Get().SetConfig(name, val); }
+const ConfigSnapshot &GetSnapshot() { return Get().GetSnapshot(); }
 }
 
 namespace FitPar {
@@ -62,6 +63,10 @@ nuisconfig::nuisconfig() {
       (GeneralUtils::GetTopLevelDir() + "/parameters/config.xml");
   std::cout << "[ NUISANCE ]: Loading DEFAULT settings from : " << filename;
 
+  fVersion = 1;
+  fNDOMReads = 0;
+  fSnapshot.version = 0;
+
   // Create XML Engine
   fXML = new TXMLEngine;
   fXML->SetSkipComments(true);
@@ -171,6 +176,7 @@ void nuisconfig::LoadXMLSettings(std::string const &filename,
     // Get Next Child
     child = fXML->GetNext(child);
   }
+  fVersion++;
   std::cout << " -> DONE." << std::endl;
 }
 
@@ -361,16 +367,20 @@ void nuisconfig::PrintXML(XMLNodePointer_t node, int indent) {
 }
 
 XMLNodePointer_t nuisconfig::CreateNode(std::string const &name) {
+  fVersion++;
   return fXML->NewChild(fMainNode, 0, name.c_str());
 }
 
 XMLNodePointer_t nuisconfig::CreateNode(XMLNodePointer_t node,
                                         std::string const &name) {
+  fVersion++;
   return fXML->NewChild(node, 0, name.c_str());
 }
 
 XMLNodePointer_t nuisconfig::GetNode(XMLNodePointer_t node,
                                      std::string const &type) {
+  fNDOMReads++;
+
   /// Loop over all children
   XMLNodePointer_t child = fXML->GetChild(node);
   while (child != 0) {
@@ -451,6 +461,7 @@ void nuisconfig::RemoveIdenticalNodes() {
 void nuisconfig::RemoveNode(XMLNodePointer_t node) {
   std::cout << "[INFO]: Removing node: " << fXML->GetNodeName(node)
             << std::endl;
+  fVersion++;
   fXML->FreeAllAttr(node);
   fXML->CleanNode(node);
   fXML->FreeNode(node);
@@ -487,6 +498,8 @@ XMLNodePointer_t nuisconfig::GetNode(std::string const &type) {
 
 std::vector<XMLNodePointer_t> nuisconfig::GetNodes(XMLNodePointer_t node,
                                                    std::string const &type) {
+  fNDOMReads++;
+
   // Create new vector for nodes
   std::vector<XMLNodePointer_t> nodelist;
 
@@ -512,6 +525,8 @@ std::vector<XMLNodePointer_t> nuisconfig::GetNodes(std::string const &type) {
 
 void nuisconfig::Set(XMLNodePointer_t node, std::string const &name,
                      std::string const &val) {
+  fVersion++;
+
   // Remove and re-add attribute
   if (fXML->HasAttr(node, name.c_str())) {
     fXML->FreeAttr(node, name.c_str());
@@ -569,6 +584,7 @@ void nuisconfig::SetD(XMLNodePointer_t node, std::string const &name,
 bool nuisconfig::Has(XMLNodePointer_t node, std::string const &name) {
   // If node empty return empty
   if (node == 0) return false;
+  fNDOMReads++;
 
   // Search attributes
   XMLAttrPointer_t attr = fXML->GetFirstAttr(node);
@@ -592,6 +608,7 @@ bool nuisconfig::Has(XMLNodePointer_t node, std::string const &name) {
 std::string nuisconfig::Get(XMLNodePointer_t node, std::string const &name) {
   // If node empty return empty
   if (node == 0) return "";
+  fNDOMReads++;
 
   // Get Attribute from child with name
   XMLAttrPointer_t attr = fXML->GetFirstAttr(node);
@@ -684,6 +701,8 @@ std::vector<std::string> nuisconfig::GetAllKeysForNode(XMLNodePointer_t node) {
 }
 
 XMLNodePointer_t nuisconfig::GetConfigNode(std::string const &name) {
+  fNDOMReads++;
+
   // Loop over children and look for name
   XMLNodePointer_t child = fXML->GetChild(fMainNode);
   while (child != 0) {
@@ -815,3 +834,35 @@ std::string nuisconfig::GetParDIR(std::string const &parName) {
 
   return outstr;
 };
+
+const ConfigSnapshot &nuisconfig::GetSnapshot(void) {
+  if (fSnapshot.version != fVersion) BuildSnapshot();
+  return fSnapshot;
+}
+
+void nuisconfig::BuildSnapshot(void) {
+  fSnapshot.EventManager = GetConfigB("EventManager");
+  fSnapshot.SignalReconfigures = GetConfigB("SignalReconfigures");
+  fSnapshot.FullEventOnSignalReconfigure =
+      GetConfigB("FullEventOnSignalReconfigure");
+  fSnapshot.addmcerror = GetConfigB("addmcerror");
+  fSnapshot.saveshapescaling = GetConfigB("saveshapescaling");
+  fSnapshot.UseShapeCovar = GetConfigB("UseShapeCovar");
+
+  // Logging overrides are looked up per file and function name
+  fSnapshot.logging.clear();
+  std::vector<XMLNodePointer_t> confignodes = GetNodes("config");
+  for (size_t i = 0; i < confignodes.size(); i++) {
+    XMLAttrPointer_t attr = fXML->GetFirstAttr(confignodes[i]);
+    while (attr != 0) {
+      std::string name = fXML->GetAttrName(attr);
+      if (!name.compare(0, 8, "logging.")) {
+        fSnapshot.logging[name] =
+            GeneralUtils::StrToInt(fXML->GetAttrValue(attr));
+      }
+      attr = fXML->GetNextAttr(attr);
+    }
+  }
+
+  fSnapshot.version = fVersion;
+}
@@ -25,6 +25,22 @@
 #include "TFile.h"
 #include "TXMLEngine.h"
 
+/// Typed copy of the config values read while evaluating the likelihood. \n
+/// Rebuilt by nuisconfig::GetSnapshot only after the XML config has been
+/// edited, so hot code can keep a const reference instead of searching the DOM.
+struct ConfigSnapshot {
+  unsigned int version;  ///< nuisconfig version this was built from
+
+  bool EventManager;
+  bool SignalReconfigures;
+  bool FullEventOnSignalReconfigure;
+  bool addmcerror;
+  bool saveshapescaling;
+  bool UseShapeCovar;
+
+  std::map<std::string, int> logging;  ///< All "logging.*" keys
+};
+
 /// NUISANCE Global Settings Class
 class nuisconfig {
  public:
@@ -154,13 +170,29 @@ class nuisconfig {
 
   std::string GetParDIR(std::string const &parName);
 
+  /// Typed snapshot of the hot path config values, rebuilt if the config
+  /// changed since the last call
+  const ConfigSnapshot &GetSnapshot(void);
+
+  /// Incremented every time the XML config is edited
+  unsigned int GetVersion(void) { return fVersion; };
+
+  /// Number of DOM searches made so far, used to check hot code avoids them
+  unsigned long GetNDOMReads(void) { return fNDOMReads; };
+
   TFile *out;
 
  private:
+  void BuildSnapshot(void);
+
   XMLNodePointer_t fMainNode;             ///< Main XML Parent Node
   TXMLEngine *fXML;                       ///< ROOT XML Engine
   std::vector<XMLDocPointer_t> fXMLDocs;  ///< List of all XML document inputs
 
+  unsigned int fVersion;     ///< Config edit counter
+  unsigned long fNDOMReads;  ///< DOM search counter
+  ConfigSnapshot fSnapshot;  ///< Last built snapshot
+
  protected:
   static nuisconfig *m_nuisconfigInstance;
 };
@@ -182,6 +214,8 @@ void SetPar(std::string const &name, bool val);
 void SetPar(std::string const &name, int val);
 void SetPar(std::string const &name, float val);
 void SetPar(std::string const &name, double val);
+
+const ConfigSnapshot &GetSnapshot();
 }
 
 namespace FitPar {
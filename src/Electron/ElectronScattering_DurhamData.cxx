@@ -70,6 +70,7 @@ ElectronScattering_DurhamData::ElectronScattering_DurhamData(
 
   // Finish up
   FinaliseMeasurement();
+  fFitPhaseSafe = false;
 };
 
 //********************************************************************
@@ -0,0 +1,414 @@
+#include "BinSplineResponse.h"
+
+// Total number of global bins (including under/overflow) for any dimension
+static int GetNCells(TH1* hist) {
+  int ncells = hist->GetNbinsX() + 2;
+  if (hist->GetDimension() > 1) ncells *= (hist->GetNbinsY() + 2);
+  if (hist->GetDimension() > 2) ncells *= (hist->GetNbinsZ() + 2);
+  return ncells;
+}
+
+//***************************************************
+BinSplineResponse::BinSplineResponse(FitWeight* rw) {
+//***************************************************
+  fRW = rw;
+  fWriter = new SplineWriter(rw);
+  fNBins = 0;
+  fNCoeff = 0;
+  fBaseFilled = false;
+}
+
+//***************************************************
+BinSplineResponse::~BinSplineResponse() {
+//***************************************************
+  if (fWriter) delete fWriter;
+}
+
+//***************************************************
+void BinSplineResponse::AddSpline(nuiskey splkey) {
+//***************************************************
+  fWriter->AddSpline(splkey);
+}
+
+//***************************************************
+void BinSplineResponse::AddSample(MeasurementBase* exp) {
+//***************************************************
+
+  // Only the first MC histogram enters the likelihood
+  std::vector<TH1*> mclist = exp->GetMCList();
+  if (mclist.empty() or !mclist[0]) {
+    THROW("Sample " << exp->GetName() << " has no MC histogram for bin responses.");
+  }
+
+  fSamples.push_back(exp);
+  fSampleHists.push_back(mclist[0]);
+  fSampleOffsets.push_back(fNBins);
+  fNBins += GetNCells(mclist[0]);
+}
+
+//***************************************************
+void BinSplineResponse::SetupSplineSet() {
+//***************************************************
+
+  fWriter->SetupSplineSet();
+  fNCoeff = fWriter->GetNPars();
+  fNominalVals = fWriter->fParVect[0];
+
+  fSetContents.clear();
+  fSetContents.resize(GetNSets());
+
+  fSplineFallback.assign(GetNSplines(), false);
+  fSplineDeviation.assign(GetNSplines(), 0.0);
+
+  fSplineOffsets.clear();
+  int off = 0;
+  for (int i = 0; i < GetNSplines(); i++) {
+    fSplineOffsets.push_back(off);
+    off += fWriter->fAllSplines[i].GetNPar();
+  }
+}
+
+//***************************************************
+void BinSplineResponse::ConfigureSet(int iset) {
+//***************************************************
+  fWriter->ReconfigureSet(iset);
+}
+
+//***************************************************
+void BinSplineResponse::GetRawContents(int isample, std::vector<double>& vals,
+                                       std::vector<double>& errs) {
+//***************************************************
+
+  TH1* hist = fSampleHists[isample];
+  double norm = fRW->GetSampleNorm(fSamples[isample]->GetName());
+  int ncells = GetNCells(hist);
+
+  for (int i = 0; i < ncells; i++) {
+    vals.push_back(hist->GetBinContent(i) * norm);
+    errs.push_back(hist->GetBinError(i) * norm);
+  }
+}
+
+//***************************************************
+void BinSplineResponse::FillSet(int iset) {
+//***************************************************
+
+  std::vector<double> errs;
+  fSetContents[iset].clear();
+  for (size_t i = 0; i < fSamples.size(); i++) {
+    GetRawContents(i, fSetContents[iset], errs);
+  }
+}
+
+//***************************************************
+void BinSplineResponse::FitResponses() {
+//***************************************************
+
+  LOG(FIT) << "Fitting " << fNBins << " bin response sets with "
+           << fNCoeff << " coefficients each." << std::endl;
+
+  int nsets = GetNSets();
+  fCoeff.assign(fNBins * fNCoeff, 0.0);
+  if (!fNCoeff) return;
+
+  double* weights = new double[nsets];
+  for (int i = 0; i < fNBins; i++) {
+
+    // Bins with no nominal prediction have no response
+    double nom = fSetContents[0][i];
+    if (nom == 0.0) continue;
+
+    weights[0] = 1.0;
+    for (int j = 1; j < nsets; j++) {
+      weights[j] = fSetContents[j][i] / nom;
+    }
+
+    fWriter->FitSplinesForEvent(weights, &fCoeff[i * fNCoeff]);
+  }
+  delete[] weights;
+}
+
+//***************************************************
+std::vector<int> BinSplineResponse::GetSplineDialPos(int ispline) {
+//***************************************************
+
+  std::vector<int> pos;
+  std::vector<std::string> splitnames =
+    GeneralUtils::ParseToStr(fWriter->fSpline[ispline], ";");
+  for (size_t i = 0; i < splitnames.size(); i++) {
+    pos.push_back(fRW->GetDialPos(splitnames[i]));
+  }
+  return pos;
+}
+
+//***************************************************
+std::vector<std::vector<double> > BinSplineResponse::GetValidationSets(int ispline) {
+//***************************************************
+
+  // Use midpoints between neighbouring knots so no set lies on the grid
+  std::vector<int> pos = GetSplineDialPos(ispline);
+  std::vector<std::vector<double> > points =
+    SplineUtils::GetSplitDialPoints(fWriter->fPoints[ispline]);
+
+  std::vector<std::vector<double> > sets;
+  for (size_t i = 0; i + 1 < points.size(); i++) {
+    std::vector<double> vals = fNominalVals;
+    for (size_t j = 0; j < pos.size(); j++) {
+      vals[pos[j]] = 0.5 * (points[i][j] + points[i + 1][j]);
+    }
+    sets.push_back(vals);
+  }
+
+  return sets;
+}
+
+//***************************************************
+std::vector<double> BinSplineResponse::GetCombinedValidationSet() {
+//***************************************************
+
+  std::vector<double> vals = fNominalVals;
+  for (int i = 0; i < GetNSplines(); i++) {
+    if (fSplineFallback[i]) continue;
+
+    std::vector<std::vector<double> > sets = GetValidationSets(i);
+    if (sets.empty()) continue;
+
+    std::vector<int> pos = GetSplineDialPos(i);
+    for (size_t j = 0; j < pos.size(); j++) {
+      vals[pos[j]] = sets[0][pos[j]];
+    }
+  }
+
+  return vals;
+}
+
+//***************************************************
+double BinSplineResponse::CompareToPrediction() {
+//***************************************************
+
+  // Current RW dial values passed to every spline
+  std::vector<std::string> names = fRW->GetDialNames();
+  std::vector<double> vals = fRW->GetDialValues();
+  fDialMap.clear();
+  for (size_t i = 0; i < names.size(); i++) {
+    fDialMap[names[i]] = vals[i];
+  }
+  fWriter->Reconfigure(fDialMap);
+
+  std::vector<double> full;
+  std::vector<double> errs;
+  for (size_t i = 0; i < fSamples.size(); i++) {
+    GetRawContents(i, full, errs);
+  }
+
+  double maxdev = 0.0;
+  for (int i = 0; i < fNBins; i++) {
+    double nom = fSetContents[0][i];
+    double pred = nom;
+    if (fNCoeff) pred *= fWriter->CalcWeight(&fCoeff[i * fNCoeff]);
+
+    if (full[i] == 0.0 and pred == 0.0) continue;
+
+    double dev = fabs(pred - full[i]) / std::max(fabs(full[i]), fabs(pred));
+    if (dev > maxdev) maxdev = dev;
+  }
+
+  return maxdev;
+}
+
+//***************************************************
+void BinSplineResponse::SetValidation(int ispline, double maxdev, double tolerance) {
+//***************************************************
+  fSplineDeviation[ispline] = maxdev;
+  fSplineFallback[ispline] = (maxdev > tolerance);
+}
+
+//***************************************************
+void BinSplineResponse::SetupFallbackDials() {
+//***************************************************
+
+  int ndials = fRW->GetDialNames().size();
+
+  // A dial shared between a good and a bad spline cannot be split,
+  // so any spline touching a fallback dial also falls back.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    std::vector<bool> isfallback(ndials, false);
+    for (int i = 0; i < GetNSplines(); i++) {
+      if (!fSplineFallback[i]) continue;
+      std::vector<int> pos = GetSplineDialPos(i);
+      for (size_t j = 0; j < pos.size(); j++) isfallback[pos[j]] = true;
+    }
+
+    for (int i = 0; i < GetNSplines(); i++) {
+      if (fSplineFallback[i]) continue;
+      std::vector<int> pos = GetSplineDialPos(i);
+      for (size_t j = 0; j < pos.size(); j++) {
+        if (isfallback[pos[j]]) {
+          fSplineFallback[i] = true;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  // Dials covered by a good spline use bin responses
+  std::vector<bool> isresponse(ndials, false);
+  for (int i = 0; i < GetNSplines(); i++) {
+    if (fSplineFallback[i]) continue;
+    std::vector<int> pos = GetSplineDialPos(i);
+    for (size_t j = 0; j < pos.size(); j++) isresponse[pos[j]] = true;
+  }
+
+  // Norm dials are applied to the prediction directly, everything
+  // else without a good spline needs the full event loop.
+  std::vector<int> enums = fRW->GetDialEnums();
+  fResponseDials.clear();
+  fFallbackDials.clear();
+  for (int i = 0; i < ndials; i++) {
+    if (isresponse[i]) {
+      fResponseDials.push_back(i);
+    } else if (Reweight::GetDialType(enums[i]) != kNORM) {
+      fFallbackDials.push_back(i);
+    }
+  }
+
+  // Zero fallback spline coefficients so they evaluate to 1.0
+  for (int i = 0; i < GetNSplines(); i++) {
+    if (!fSplineFallback[i]) continue;
+    int npar = fWriter->fAllSplines[i].GetNPar();
+    for (int j = 0; j < fNBins; j++) {
+      for (int k = 0; k < npar; k++) {
+        fCoeff[j * fNCoeff + fSplineOffsets[i] + k] = 0.0;
+      }
+    }
+  }
+
+  fBaseFilled = false;
+}
+
+//***************************************************
+void BinSplineResponse::PrintReport(double combineddev) {
+//***************************************************
+
+  LOG(FIT) << "Bin response validation against full event reweighting : "
+           << std::endl;
+  for (int i = 0; i < GetNSplines(); i++) {
+    LOG(FIT) << " -> " << std::left << std::setw(40) << fWriter->fSpline[i]
+             << " : max dev = " << std::setw(12) << fSplineDeviation[i]
+             << (fSplineFallback[i] ? " FALLBACK" : " RESPONSE") << std::endl;
+  }
+
+  if (combineddev >= 0.0) {
+    LOG(FIT) << " -> All response dials combined : max dev = " << combineddev
+             << std::endl;
+  }
+
+  std::vector<std::string> names = fRW->GetDialNames();
+  for (size_t i = 0; i < fFallbackDials.size(); i++) {
+    LOG(FIT) << " -> Dial " << names[fFallbackDials[i]]
+             << " uses full event reweighting." << std::endl;
+  }
+  LOG(FIT) << "Using " << fResponseDials.size() << " bin response dials, "
+           << fFallbackDials.size() << " fallback dials over " << fNBins
+           << " bins." << std::endl;
+}
+
+//***************************************************
+bool BinSplineResponse::NeedsBaseUpdate() {
+//***************************************************
+
+  if (!fBaseFilled) return true;
+
+  std::vector<double> vals = fRW->GetDialValues();
+  for (size_t i = 0; i < fFallbackDials.size(); i++) {
+    if (vals[fFallbackDials[i]] != fBaseDialVals[i]) return true;
+  }
+  return false;
+}
+
+//***************************************************
+void BinSplineResponse::ConfigureBase() {
+//***************************************************
+
+  fSavedVals = fRW->GetDialValues();
+
+  std::vector<double> vals = fSavedVals;
+  for (size_t i = 0; i < fResponseDials.size(); i++) {
+    vals[fResponseDials[i]] = fNominalVals[fResponseDials[i]];
+  }
+
+  fBaseDialVals.clear();
+  for (size_t i = 0; i < fFallbackDials.size(); i++) {
+    fBaseDialVals.push_back(fSavedVals[fFallbackDials[i]]);
+  }
+
+  fRW->SetAllDials(&vals[0], vals.size());
+}
+
+//***************************************************
+void BinSplineResponse::FillBase() {
+//***************************************************
+
+  fBaseContent.clear();
+  fBaseError.clear();
+  for (size_t i = 0; i < fSamples.size(); i++) {
+    GetRawContents(i, fBaseContent, fBaseError);
+  }
+
+  // Full reconfigure leaves each sample scaled by its current norm
+  fSampleNorms.clear();
+  for (size_t i = 0; i < fSamples.size(); i++) {
+    fSampleNorms.push_back(fRW->GetSampleNorm(fSamples[i]->GetName()));
+  }
+  fBaseFilled = true;
+}
+
+//***************************************************
+void BinSplineResponse::RestoreDials() {
+//***************************************************
+  fRW->SetAllDials(&fSavedVals[0], fSavedVals.size());
+}
+
+//***************************************************
+void BinSplineResponse::Predict() {
+//***************************************************
+
+  // Pass current response dial values to the splines
+  std::vector<std::string> names = fRW->GetDialNames();
+  std::vector<double> vals = fRW->GetDialValues();
+  fDialMap.clear();
+  for (size_t i = 0; i < fResponseDials.size(); i++) {
+    fDialMap[names[fResponseDials[i]]] = vals[fResponseDials[i]];
+  }
+  fWriter->Reconfigure(fDialMap);
+
+  for (size_t i = 0; i < fSamples.size(); i++) {
+    TH1* hist = fSampleHists[i];
+    int ncells = GetNCells(hist);
+    int off = fSampleOffsets[i];
+
+    // All bins of a sample are evaluated in one batch
+    fWeights.assign(ncells, 1.0);
+    if (fNCoeff) {
+      fWriter->CalcWeights(&fCoeff[off * fNCoeff], ncells, fNCoeff, &fWeights[0]);
+    }
+
+    for (int j = 0; j < ncells; j++) {
+      double w = fWeights[j];
+      hist->SetBinContent(j, fBaseContent[off + j] * w / fSampleNorms[i]);
+      hist->SetBinError(j, fBaseError[off + j] * w / fSampleNorms[i]);
+    }
+
+    // Let the sample update its own norm so fCurrentNorm stays in sync
+    std::string name = fSamples[i]->GetName();
+    if (fRW->DialIncluded(name + "_norm") and
+        fRW->GetSampleNorm(name) != fSampleNorms[i]) {
+      fSamples[i]->Renormalise();
+      fSampleNorms[i] = fRW->GetSampleNorm(name);
+    }
+  }
+}
@@ -0,0 +1,132 @@
+#ifndef _BIN_SPLINE_RESPONSE_H_
+#define _BIN_SPLINE_RESPONSE_H_
+/*!
+ *  \addtogroup FCN
+ *  @{
+ */
+
+#include <vector>
+#include <string>
+
+#include "TH1.h"
+
+#include "MeasurementBase.h"
+#include "SplineWriter.h"
+
+/// Bin level response functions for the final MC histograms of each sample.
+///
+/// At setup the samples are fully reconfigured at every knot of the
+/// SplineWriter parameter grid and each bin's weight relative to nominal is
+/// fitted with the same spline forms used for event splines. During the fit
+/// the MC prediction is then nominal * prod(bin responses), which costs
+/// O(bins x dials) instead of O(events x dials).
+///
+/// Splines that fail validation against full event reweighting, and dials
+/// with no spline at all, are treated as fallback dials. The nominal histograms
+/// are rebuilt by a full reconfigure whenever a fallback dial changes.
+/// Sample norm dials are applied analytically through Renormalise.
+class BinSplineResponse {
+public:
+
+  BinSplineResponse(FitWeight* rw);
+  ~BinSplineResponse();
+
+  /// Add spline definitions to the knot grid
+  void AddSpline(nuiskey splkey);
+
+  /// Register a sample whose first MC histogram will be predicted
+  void AddSample(MeasurementBase* exp);
+
+  /// Build the knot parameter sets. Call once all splines are added.
+  void SetupSplineSet();
+
+  inline int GetNSets() { return fWriter->GetNWeights(); };
+  inline int GetNSplines() { return fWriter->fAllSplines.size(); };
+
+  /// Set the RW engine dials to knot set iset
+  void ConfigureSet(int iset);
+
+  /// Record the current sample histograms for knot set iset
+  void FillSet(int iset);
+
+  /// Fit the bin response splines from the recorded knot sets
+  void FitResponses();
+
+  /// Off-knot dial sets used to validate spline ispline
+  std::vector<std::vector<double> > GetValidationSets(int ispline);
+
+  /// Compare the current (fully reweighted) histograms against the
+  /// bin response prediction at the same dial values.
+  /// Returns the max relative deviation over bins.
+  double CompareToPrediction();
+
+  /// Off-knot dial set moving every non-fallback spline at once,
+  /// used to check the responses factorise.
+  std::vector<double> GetCombinedValidationSet();
+
+  /// Store the validation result for spline ispline. Splines deviating
+  /// by more than tolerance are marked as fallback.
+  void SetValidation(int ispline, double maxdev, double tolerance);
+
+  /// Collect the dials that must be handled by full event reweighting
+  void SetupFallbackDials();
+
+  /// Print validation report. combineddev < 0 if not checked.
+  void PrintReport(double combineddev = -1.0);
+
+  /// Check whether any fallback dial has changed since the last base fill
+  bool NeedsBaseUpdate();
+
+  /// Set RW dials for a base fill : fallback dials at current values,
+  /// response dials at nominal
+  void ConfigureBase();
+
+  /// Record the current histograms as the base for predictions
+  void FillBase();
+
+  /// Restore RW dials to the values saved in ConfigureBase
+  void RestoreDials();
+
+  /// Write the bin response prediction into the sample histograms
+  void Predict();
+
+  inline int GetNFallbackDials() { return fFallbackDials.size(); };
+
+private:
+
+  /// Raw histogram contents, undoing the sample norm scaling
+  void GetRawContents(int isample, std::vector<double>& vals, std::vector<double>& errs);
+
+  /// Positions in the RW dial list of the dials spline ispline depends on
+  std::vector<int> GetSplineDialPos(int ispline);
+
+  FitWeight* fRW;
+  SplineWriter* fWriter;
+
+  std::vector<MeasurementBase*> fSamples;
+  std::vector<TH1*> fSampleHists;
+  std::vector<int> fSampleOffsets; ///< Offset of each sample in flat bin arrays
+  int fNBins;
+  int fNCoeff;
+
+  std::vector< std::vector<double> > fSetContents; ///< [set][bin] raw contents
+  std::vector<float> fCoeff;                         ///< [bin*fNCoeff + coeff]
+  std::vector<double> fBaseContent;
+  std::vector<double> fBaseError;
+  std::vector<double> fSampleNorms;  ///< Norm each sample histogram currently carries
+
+  std::vector<double> fNominalVals;
+  std::vector<double> fSavedVals;
+  std::vector<bool> fSplineFallback;
+  std::vector<double> fSplineDeviation;
+  std::vector<int> fSplineOffsets;     ///< Offset of each spline in a bin's coefficients
+  std::vector<int> fFallbackDials;     ///< Positions of fallback dials in RW dial list
+  std::vector<double> fBaseDialVals;   ///< Fallback dial values used in the last base fill
+  std::vector<int> fResponseDials;     ///< Positions of dials handled by bin responses
+  std::map<std::string, double> fDialMap;
+  std::vector<double> fWeights;        ///< Batched bin weights for one sample
+  bool fBaseFilled;
+};
+
+/*! @} */
+#endif
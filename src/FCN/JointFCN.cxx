@@ -1,6 +1,10 @@
 #include "JointFCN.h"
 #include <stdio.h>
 #include "FitUtils.h"
+#include "OpenMPWrapper.h"
+#include "RVersion.h"
+#include "TROOT.h"
+#include "ModeNormEngine.h"
 
 
 //***************************************************
@@ -21,9 +25,21 @@ JointFCN::JointFCN(TFile* outfile) {
 
   fIterationTree = false;
   fDialVals = NULL;
+  fSampleLikes = NULL;
   fNDials = 0;
 
   fUsingEventManager = FitPar::Config().GetParB("EventManager");
+  fUseBinResponses = FitPar::Config().GetParB("bin_responses");
+  fBinResponse = NULL;
+  fUseGradient = false;
+  fParallelSamples = FitPar::Config().GetParB("parallel_samples");
+  fUseFitPhase = FitPar::Config().GetParB("fit_phase");
+  fFitPhase = false;
+  fUseDeltaUpdates = FitPar::Config().GetParB("delta_updates");
+  fDeltaCheckEvery = FitPar::Config().GetParI("delta_updates_check");
+  fDeltaReady = false;
+  fDeltaCount = 0;
+  fDeltaNCells = 0;
   fOutputDir->cd();
 }
 
@@ -43,9 +59,21 @@ JointFCN::JointFCN(std::vector<nuiskey> samplekeys, TFile* outfile) {
 
   fIterationTree = false;
   fDialVals = NULL;
+  fSampleLikes = NULL;
   fNDials = 0;
 
   fUsingEventManager = FitPar::Config().GetParB("EventManager");
+  fUseBinResponses = FitPar::Config().GetParB("bin_responses");
+  fBinResponse = NULL;
+  fUseGradient = false;
+  fParallelSamples = FitPar::Config().GetParB("parallel_samples");
+  fUseFitPhase = FitPar::Config().GetParB("fit_phase");
+  fFitPhase = false;
+  fUseDeltaUpdates = FitPar::Config().GetParB("delta_updates");
+  fDeltaCheckEvery = FitPar::Config().GetParI("delta_updates_check");
+  fDeltaReady = false;
+  fDeltaCount = 0;
+  fDeltaNCells = 0;
   fOutputDir->cd();
 }
 
@@ -69,6 +97,7 @@ JointFCN::~JointFCN() {
   if (fIterationTree) DestroyIterationTree();
   if (fDialVals) delete fDialVals;
   if (fSampleLikes) delete fSampleLikes;
+  if (fBinResponse) delete fBinResponse;
 };
 
 //***************************************************
@@ -216,6 +245,9 @@ void JointFCN::FillIterationTree(FitWeight* rw) {
 double JointFCN::DoEval(const double* x) {
   //***************************************************
 
+  // Plain likelihood call, display histograms are rebuilt in Write
+  SetFitPhase(fUseFitPhase);
+
   // WEIGHT ENGINE
   fDialChanged = FitBase::GetRW()->HasRWDialChanged(x);
   FitBase::GetRW()->UpdateWeightEngine(x);
@@ -228,7 +260,11 @@ double JointFCN::DoEval(const double* x) {
   }
 
   // SORT SAMPLES
-  ReconfigureSamples();
+  if (fUseBinResponses) {
+    ReconfigureBinResponses();
+  } else {
+    ReconfigureSamples();
+  }
 
   // GET TEST STAT
   fLikelihood = GetLikelihood();
@@ -297,13 +333,33 @@ double JointFCN::GetLikelihood() {
            << " : "
            << "-2logL" << std::endl;
 
-  // Loop and add up likelihoods in an uncorrelated way
+  // Sample likelihoods are independent, thread safe ones run concurrently
+  int nsamples = fSampleVect.size();
+  fSampleLikeVect.resize(nsamples);
+  bool parallel = UseParallelSamples();
+  bool adddir = TH1::AddDirectoryStatus();
+  if (parallel) TH1::AddDirectory(kFALSE);
+
+#ifdef __USE_OPENMP__
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+  for (int i = 0; i < nsamples; i++) {
+    if (!fSampleVect[i]->IsThreadSafe()) continue;
+    fSampleLikeVect[i] = fSampleVect[i]->GetLikelihood();
+  }
+
+  TH1::AddDirectory(adddir);
+  for (int i = 0; i < nsamples; i++) {
+    if (fSampleVect[i]->IsThreadSafe()) continue;
+    fSampleLikeVect[i] = fSampleVect[i]->GetLikelihood();
+  }
+
+  // Loop and add up likelihoods in sample order so the total is reproducible
   double like = 0.0;
   int count = 0;
-  for (MeasListConstIter iter = fSamples.begin(); iter != fSamples.end();
-       iter++) {
-    MeasurementBase* exp = *iter;
-    double newlike = exp->GetLikelihood();
+  for (int i = 0; i < nsamples; i++) {
+    MeasurementBase* exp = fSampleVect[i];
+    double newlike = fSampleLikeVect[i];
     int ndof = exp->GetNDOF();
     // Save seperate likelihoods
     if (fIterationTree) {
@@ -345,6 +401,60 @@ double JointFCN::GetLikelihood() {
   return like;
 };
 
+//***************************************************
+bool JointFCN::UseParallelSamples() {
+  //***************************************************
+
+  if (!fParallelSamples or omp_get_max_threads() < 2) return false;
+
+  // Build the config snapshot here so samples only ever read it
+  Config::GetSnapshot();
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 0, 0)
+  // Guards ROOT's global object lists while samples create histograms
+  ROOT::EnableThreadSafety();
+  return true;
+#else
+  // ROOT 5 has no lock for its global object lists, stay serial
+  return false;
+#endif
+}
+
+//***************************************************
+void JointFCN::ConvertSampleEventRates() {
+  //***************************************************
+
+  int nsamples = fSampleVect.size();
+  bool parallel = UseParallelSamples();
+  bool adddir = TH1::AddDirectoryStatus();
+  if (parallel) TH1::AddDirectory(kFALSE);
+
+#ifdef __USE_OPENMP__
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+  for (int i = 0; i < nsamples; i++) {
+    if (!fSampleVect[i]->IsThreadSafe()) continue;
+    fSampleVect[i]->ConvertEventRates();
+  }
+
+  TH1::AddDirectory(adddir);
+  for (int i = 0; i < nsamples; i++) {
+    if (fSampleVect[i]->IsThreadSafe()) continue;
+    fSampleVect[i]->ConvertEventRates();
+  }
+}
+
+//***************************************************
+void JointFCN::SetFitPhase(bool fitphase) {
+//***************************************************
+
+  fFitPhase = fitphase;
+  for (MeasListConstIter iter = fSamples.begin(); iter != fSamples.end();
+       iter++) {
+    (*iter)->SetFitPhase(fitphase);
+  }
+}
+
 void JointFCN::LoadSamples(std::vector<nuiskey> samplekeys) {
   LOG(MIN) << "Loading Samples : " << samplekeys.size() << std::endl;
   for (size_t i = 0; i < samplekeys.size(); i++) {
@@ -368,6 +478,7 @@ void JointFCN::LoadSamples(std::vector<nuiskey> samplekeys) {
       throw;
     } else {
       fSamples.push_back(NewLoadedSample);
+      fSampleVect.push_back(NewLoadedSample);
     }
   }
 }
@@ -397,10 +508,11 @@ void JointFCN::ReconfigureSamples(bool fullconfig) {
   // std::endl;
   // Event Manager Reconf
   if (fUsingEventManager) {
-    if (!fullconfig and fMCFilled)
-      ReconfigureFastUsingManager();
-    else
+    if (!fullconfig and fMCFilled) {
+      if (!ReconfigureDeltaUsingManager()) ReconfigureFastUsingManager();
+    } else {
       ReconfigureUsingManager();
+    }
 
   } else {
     // Loop over all Measurement Classes
@@ -438,17 +550,376 @@ void JointFCN::ReconfigureSamples(bool fullconfig) {
 //***************************************************
 void JointFCN::ReconfigureSignal() {
 //***************************************************
+  SetFitPhase(false);
   ReconfigureSamples(false);
 }
 
 //***************************************************
 void JointFCN::ReconfigureAllEvents() {
   //***************************************************
+  SetFitPhase(false);
   FitBase::GetRW()->Reconfigure();
   FitBase::EvtManager().ResetWeightFlags();
   ReconfigureSamples(true);
 }
 
+//***************************************************
+void JointFCN::ReconfigureBinResponseSamples(bool fullconfig) {
+//***************************************************
+  UInt_t curiter = fCurIter;
+  FitBase::GetRW()->Reconfigure(true);
+  FitBase::EvtManager().ResetWeightFlags();
+
+  // Samples fall back to a full loop themselves if their signal cache is empty
+  fDialChanged = true;
+  ReconfigureSamples(fullconfig or !fMCFilled);
+  fCurIter = curiter;
+}
+
+//***************************************************
+void JointFCN::SetupBinResponses() {
+//***************************************************
+
+  LOG(FIT) << "Setting up bin level response functions." << std::endl;
+  int timestart = time(NULL);
+
+  FitWeight* rw = FitBase::GetRW();
+  std::vector<double> startvals = rw->GetDialValues();
+  fBinResponse = new BinSplineResponse(rw);
+
+  // Knot grid uses the same spline definitions as nuissplines
+  std::vector<nuiskey> splinekeys = Config::QueryKeys("spline");
+  for (size_t i = 0; i < splinekeys.size(); i++) {
+    fBinResponse->AddSpline(splinekeys[i]);
+  }
+  fBinResponse->SetupSplineSet();
+
+  // Nominal fill so every sample has its histograms ready
+  ReconfigureBinResponseSamples();
+  for (MeasListConstIter iter = fSamples.begin(); iter != fSamples.end();
+       iter++) {
+    fBinResponse->AddSample(*iter);
+  }
+
+  // Fill every knot set with a full reconfigure
+  int nsets = fBinResponse->GetNSets();
+  for (int i = 0; i < nsets; i++) {
+    LOG(FIT) << "Filling bin response knot set " << i + 1 << "/" << nsets
+             << std::endl;
+    fBinResponse->ConfigureSet(i);
+    ReconfigureBinResponseSamples();
+    fBinResponse->FillSet(i);
+  }
+  fBinResponse->FitResponses();
+
+  // Validate each spline off the knot grid against full reweighting
+  double tolerance = FitPar::Config().GetParD("bin_response_tolerance");
+  if (tolerance <= 0.0) tolerance = 0.01;
+
+  for (int i = 0; i < fBinResponse->GetNSplines(); i++) {
+    std::vector<std::vector<double> > sets = fBinResponse->GetValidationSets(i);
+    double maxdev = 0.0;
+    for (size_t j = 0; j < sets.size(); j++) {
+      rw->SetAllDials(&sets[j][0], sets[j].size());
+      ReconfigureBinResponseSamples();
+      maxdev = std::max(maxdev, fBinResponse->CompareToPrediction());
+    }
+    fBinResponse->SetValidation(i, maxdev, tolerance);
+  }
+  fBinResponse->SetupFallbackDials();
+
+  // Check the remaining responses factorise when moved together
+  std::vector<double> combined = fBinResponse->GetCombinedValidationSet();
+  rw->SetAllDials(&combined[0], combined.size());
+  ReconfigureBinResponseSamples();
+  double combineddev = fBinResponse->CompareToPrediction();
+  fBinResponse->PrintReport(combineddev);
+  if (combineddev > tolerance) {
+    ERR(WRN) << "Combined bin response deviation " << combineddev
+             << " exceeds tolerance " << tolerance
+             << ". Dial responses may not factorise." << std::endl;
+  }
+
+  // Return to starting dials. Base histograms are filled on first use.
+  rw->SetAllDials(&startvals[0], startvals.size());
+  FitBase::EvtManager().ResetWeightFlags();
+
+  LOG(FIT) << "Time taken SetupBinResponses() : " << time(NULL) - timestart
+           << std::endl;
+}
+
+//***************************************************
+void JointFCN::ReconfigureBinResponses() {
+//***************************************************
+
+  int starttime = time(NULL);
+  LOG(REC) << "Starting bin response reconfigure iter. " << fCurIter
+           << std::endl;
+
+  if (!fBinResponse) SetupBinResponses();
+
+  // Fallback dials changed so rebuild base with response dials at nominal
+  if (fBinResponse->NeedsBaseUpdate()) {
+    LOG(REC) << "Rebuilding bin response base histograms." << std::endl;
+    fBinResponse->ConfigureBase();
+    ReconfigureBinResponseSamples(false);
+    fBinResponse->FillBase();
+    fBinResponse->RestoreDials();
+    FitBase::EvtManager().ResetWeightFlags();
+  }
+
+  fBinResponse->Predict();
+
+  // Loop over pulls and update
+  for (PullListConstIter iter = fPulls.begin(); iter != fPulls.end(); iter++) {
+    ParamPull* pull = *iter;
+    pull->Reconfigure();
+  }
+
+  fMCFilled = true;
+  LOG(MIN) << "Finished bin response reconfigure iter. " << fCurIter << " in "
+           << time(NULL) - starttime << "s" << std::endl;
+
+  fCurIter++;
+}
+
+//***************************************************
+bool JointFCN::SetupGradient() {
+//***************************************************
+
+  fUseGradient = false;
+  FitWeight* rw = FitBase::GetRW();
+
+  // Gradient pass runs over the in memory spline cache of the fast loop
+  if (!fUsingEventManager or !FitPar::Config().GetParB("SignalReconfigures") or
+      fUseBinResponses) {
+    LOG(FIT) << "Analytic gradient needs EventManager and SignalReconfigures "
+             << "without bin_responses." << std::endl;
+    return false;
+  }
+
+  if (fInputList.empty()) {
+    fInputList = GetInputList();
+    fSubSampleList = GetSubSampleList();
+  }
+  if (!fIsAllSplines) {
+    LOG(FIT) << "Analytic gradient needs all inputs to be splines." << std::endl;
+    return false;
+  }
+
+  // Only spline and sample norm dials have a known weight derivative
+  std::vector<std::string> names = rw->GetDialNames();
+  std::vector<int> enums = rw->GetDialEnums();
+  for (size_t i = 0; i < enums.size(); i++) {
+    int type = Reweight::GetDialType(enums[i]);
+    if (type != kSPLINEPARAMETER and type != kNORM) {
+      LOG(FIT) << "No analytic gradient for dial " << names[i] << std::endl;
+      return false;
+    }
+  }
+
+  // Samples are filled per subsample so joint samples are not supported
+  MeasListConstIter iterSam = fSamples.begin();
+  for (; iterSam != fSamples.end(); iterSam++) {
+    MeasurementBase* exp = (*iterSam);
+    std::vector<MeasurementBase*> subsamples = exp->GetSubSamples();
+    if (subsamples.size() != 1 or subsamples[0] != exp or
+        !exp->HasLikelihoodGradient()) {
+      LOG(FIT) << "No analytic gradient for sample " << exp->GetName() << std::endl;
+      return false;
+    }
+  }
+
+  fGradNormDials.clear();
+  for (size_t i = 0; i < fSubSampleList.size(); i++) {
+    MeasurementBase* exp = fSubSampleList[i];
+    std::string normname = exp->GetName() + "_norm";
+    fGradNormDials.push_back(rw->DialIncluded(normname) ? rw->GetDialPos(normname) : -1);
+  }
+
+  // Spline dimensions follow every RW dial whose comma separated names match
+  fGradSlotDials.clear();
+  size_t nslots = 0;
+  for (size_t i = 0; i < fInputList.size(); i++) {
+    SplineReader* reader = fInputList[i]->FirstBaseEvent()->fSplineRead;
+    if (!reader or !reader->HasGradient()) {
+      LOG(FIT) << "No analytic gradient for spline forms in "
+               << fInputList[i]->GetName() << std::endl;
+      return false;
+    }
+
+    std::vector<std::string> slots = reader->GetGradSlotNames();
+    std::vector<int> slotdials(slots.size(), -1);
+    for (size_t j = 0; j < slots.size(); j++) {
+      for (size_t k = 0; k < names.size(); k++) {
+        std::vector<std::string> allnames = GeneralUtils::ParseToStr(names[k], ",");
+        if (std::find(allnames.begin(), allnames.end(), slots[j]) != allnames.end()) {
+          slotdials[j] = k;
+        }
+      }
+    }
+    fGradSlotDials.push_back(slotdials);
+    nslots = std::max(nslots, slots.size());
+  }
+  fGradSlots.resize(nslots);
+
+  fUseGradient = true;
+  return true;
+}
+
+//***************************************************
+double JointFCN::DoEvalGradient(const double* x, double* grad) {
+//***************************************************
+
+  double like = DoEval(x);
+  CalcGradient(grad);
+  return like;
+}
+
+//***************************************************
+void JointFCN::CalcGradient(double* grad) {
+//***************************************************
+
+  FitWeight* rw = FitBase::GetRW();
+  int ndials = rw->GetDialNames().size();
+  for (int i = 0; i < ndials; i++) grad[i] = 0.0;
+
+  if (!fUseGradient or fSignalEventFlags.empty()) {
+    THROW("JointFCN::CalcGradient called without a gradient setup "
+          "or signal event cache.");
+  }
+
+  // dL/dMC for every sample, norm derivatives come back directly
+  size_t nsamples = fSubSampleList.size();
+  fGradDLDMC.resize(nsamples);
+  fGradRaw.resize(nsamples);
+  fGradDeriv.resize(nsamples);
+  for (size_t i = 0; i < nsamples; i++) {
+    double dldnorm = 0.0;
+    fSubSampleList[i]->GetLikelihoodGradient(fGradDLDMC[i], dldnorm);
+    if (fGradNormDials[i] >= 0) grad[fGradNormDials[i]] += dldnorm;
+
+    int ncells = fGradDLDMC[i].size();
+    fGradRaw[i].assign(ncells, 0.0);
+    fGradDeriv[i].assign(ncells * ndials, 0.0);
+  }
+
+  // Single pass over the signal events accumulating filled weights and
+  // weight derivatives per bin, in the same order as the fast loop.
+  int sigcount = 0;
+  int splinecount = 0;
+  for (size_t iinput = 0; iinput < fInputList.size(); iinput++) {
+    InputHandlerBase* curinput = fInputList[iinput];
+    BaseFitEvt* curevent = curinput->FirstBaseEvent();
+    SplineReader* reader = curevent->fSplineRead;
+    std::vector<int>& slotdials = fGradSlotDials[iinput];
+
+    for (int i = 0; i < curinput->GetNEvents(); i++, sigcount++) {
+      if (!fSignalEventFlags[sigcount]) continue;
+
+      const float* coeff = fSignalEventSplines.empty() ? NULL :
+        &fSignalEventSplines[0] + fSignalEventSplineOffsets[splinecount];
+      double w = 0.0;
+      if (curevent->fSplineMask) {
+        w = reader->CalcWeightGradient(&fSignalEventSplineMasks[fSignalEventMaskOffsets[splinecount]],
+                                       coeff, &fGradSlots[0]);
+      } else {
+        w = reader->CalcWeightGradient(coeff, &fGradSlots[0]);
+      }
+      w *= curevent->InputWeight;
+
+      std::vector<bool>& samsig = fSampleSignalFlags[splinecount];
+      std::vector<MeasurementVariableBox*>& boxes = fSignalEventBoxes[splinecount];
+      size_t ibox = 0;
+      for (size_t isam = 0; isam < nsamples; isam++) {
+        if (!samsig[isam]) continue;
+
+        int bin = fSubSampleList[isam]->GetLikelihoodBin(boxes[ibox++]);
+        if (bin < 0 or bin >= (int)fGradRaw[isam].size()) continue;
+
+        fGradRaw[isam][bin] += w;
+        double* deriv = &fGradDeriv[isam][bin * ndials];
+        for (size_t j = 0; j < slotdials.size(); j++) {
+          if (slotdials[j] < 0) continue;
+          deriv[slotdials[j]] += fGradSlots[j] * curevent->InputWeight;
+        }
+      }
+      splinecount++;
+    }
+  }
+
+  // ConvertEventRates is linear per bin, so a relative change of the
+  // filled weight is the same relative change of the MC.
+  for (size_t isam = 0; isam < nsamples; isam++) {
+    for (size_t bin = 0; bin < fGradRaw[isam].size(); bin++) {
+      if (fGradRaw[isam][bin] == 0.0) continue;
+
+      double g = fGradDLDMC[isam][bin] / fGradRaw[isam][bin];
+      if (g == 0.0) continue;
+
+      double* deriv = &fGradDeriv[isam][bin * ndials];
+      for (int k = 0; k < ndials; k++) grad[k] += g * deriv[k];
+    }
+  }
+
+  for (PullListConstIter iter = fPulls.begin(); iter != fPulls.end(); iter++) {
+    ParamPull* pull = *iter;
+    pull->AddLikelihoodGradient(grad);
+  }
+}
+
+//***************************************************
+bool JointFCN::CheckGradient(const double* x, double tolerance) {
+//***************************************************
+
+  if (!fUseGradient) return false;
+
+  int ndials = FitBase::GetRW()->GetDialNames().size();
+  std::vector<std::string> names = FitBase::GetRW()->GetDialNames();
+
+  // Don't let the check show up as fit iterations
+  bool savetree = fIterationTree;
+  UInt_t saveiter = fCurIter;
+  fIterationTree = false;
+
+  std::vector<double> grad(ndials);
+  std::vector<double> vals(x, x + ndials);
+  DoEvalGradient(x, &grad[0]);
+
+  LOG(FIT) << "Checking analytic gradient against finite differences" << std::endl;
+  bool pass = true;
+  for (int i = 0; i < ndials; i++) {
+    double step = 1E-2 * std::max(1.0, fabs(x[i]));
+
+    vals[i] = x[i] + step;
+    double up = DoEval(&vals[0]);
+    vals[i] = x[i] - step;
+    double down = DoEval(&vals[0]);
+    vals[i] = x[i];
+
+    double numgrad = (up - down) / (2.0 * step);
+    double diff = fabs(grad[i] - numgrad);
+    bool ok = diff <= tolerance * std::max(1.0, std::max(fabs(grad[i]), fabs(numgrad)));
+
+    LOG(FIT) << " -> " << std::left << std::setw(40) << names[i] << " : "
+             << grad[i] << " : " << numgrad << (ok ? "" : " FAILED") << std::endl;
+    pass = pass and ok;
+  }
+
+  // Leave the samples at x
+  DoEval(x);
+  fIterationTree = savetree;
+  fCurIter = saveiter;
+
+  if (!pass) {
+    ERR(WRN) << "Analytic gradient does not match finite differences, "
+             << "falling back to numerical derivatives." << std::endl;
+    fUseGradient = false;
+  }
+
+  return pass;
+}
+
 std::vector<InputHandlerBase*> JointFCN::GetInputList() {
   std::vector<InputHandlerBase*> InputList;
   fIsAllSplines = true;
@@ -505,7 +976,7 @@ void JointFCN::ReconfigureUsingManager() {
   }
 
   // If we are siving signal, reset all containers.
-  bool savesignal = (FitPar::Config().GetParB("SignalReconfigures"));
+  bool savesignal = (FitPar::Config().GetSnapshot().SignalReconfigures);
 
   if (savesignal) {
     // Reset all of our event signal vectors
@@ -513,6 +984,11 @@ void JointFCN::ReconfigureUsingManager() {
     fSignalEventFlags.clear();
     fSampleSignalFlags.clear();
     fSignalEventSplines.clear();
+    fSignalEventSplineMasks.clear();
+    fSignalEventSplineOffsets.clear();
+    fSignalEventMaskOffsets.clear();
+    fSignalEventModes.clear();
+    fDeltaReady = false;
   }
 
   // Make sure we have a list of inputs
@@ -557,6 +1033,14 @@ void JointFCN::ReconfigureUsingManager() {
 
     // Start event loop iterating until we get a NULL pointer.
     while (curevent) {
+      // Events no sample can accept are left undecoded by the input
+      if (!curevent->fPreselected) {
+        if (savesignal) fSignalEventFlags.push_back(false);
+        curevent = curinput->NextNuisanceEvent();
+        i++;
+        continue;
+      }
+
       // Get Event Weight
       curevent->RWWeight = FitBase::GetRW()->CalcWeight(curevent);
       curevent->Weight = curevent->RWWeight * curevent->InputWeight;
@@ -616,6 +1100,7 @@ void JointFCN::ReconfigureUsingManager() {
 
         // If its Signal tally up fills
         if (signal) {
+          curmeas->CheckPreselection(curevent);
           fillcount++;
         }
 
@@ -644,30 +1129,32 @@ void JointFCN::ReconfigureUsingManager() {
       if (savesignal and foundsignal) {
         fSignalEventBoxes.push_back(signalboxes);
         fSampleSignalFlags.push_back(signalbitset);
+        fSignalEventModes.push_back(curevent->Mode);
       }
 
       // If all inputs are splines we can save the spline coefficients
       // for fast in memory reconfigures later.
       if (fIsAllSplines and savesignal and foundsignal) {
-        // Make temp vector to push back with
-        std::vector<float> coeff;
-        for (size_t l = 0; l < (UInt_t)curevent->fSplineRead->GetNPar(); l++) {
-          coeff.push_back(curevent->fSplineCoeff[l]);
+        // Push back to flat signal event splines. Offsets kept in sync with
+        // fSignalEventBoxes size. Packed events only store their mask
+        // and the coefficients of splines with a response.
+        fSignalEventSplineOffsets.push_back(fSignalEventSplines.size());
+        fSignalEventMaskOffsets.push_back(fSignalEventSplineMasks.size());
+        if (curevent->fSplineMask) {
+          int nwords = curevent->fSplineRead->GetNMaskWords();
+          int ncoeff = curevent->fSplineRead->GetNPacked(curevent->fSplineMask);
+          fSignalEventSplineMasks.insert(fSignalEventSplineMasks.end(),
+                                         curevent->fSplineMask,
+                                         curevent->fSplineMask + nwords);
+          fSignalEventSplines.insert(fSignalEventSplines.end(),
+                                     curevent->fSplineCoeff,
+                                     curevent->fSplineCoeff + ncoeff);
+        } else {
+          int ncoeff = curevent->fSplineRead->GetNPar();
+          fSignalEventSplines.insert(fSignalEventSplines.end(),
+                                     curevent->fSplineCoeff,
+                                     curevent->fSplineCoeff + ncoeff);
         }
-
-        // Push back to signal event splines. Kept in sync with
-        // fSignalEventBoxes size.
-        // int splinecount = fSignalEventSplines.size();
-        fSignalEventSplines.push_back(coeff);
-
-        // if (splinecount % 1000 == 0) {
-        // std::cout << "Pushed Back Coeff " << splinecount << " : ";
-        // for (size_t l = 0; l < fSignalEventSplines[splinecount].size(); l++)
-        // {
-        // std::cout << " " << fSignalEventSplines[splinecount][l];
-        // }
-        // std::cout << std::endl;
-        // }
       }
 
       // Clean up vectors once done with this event
@@ -687,13 +1174,15 @@ void JointFCN::ReconfigureUsingManager() {
 
   // End of Event Loop ===============================
 
+  // Every sample has now seen all of its events, see CheckPreselection
+  for (size_t i = 0; i < fSubSampleList.size(); i++) {
+    MeasurementBase* curmeas = fSubSampleList[i];
+    if (curmeas->GetInput()) curmeas->GetInput()->SetPreselectionChecked(curmeas);
+  }
+
   // Now event loop is finished loop over all Measurements
   // Converting Binned events to XSec Distributions
-  iterSam = fSamples.begin();
-  for (; iterSam != fSamples.end(); iterSam++) {
-    MeasurementBase* exp = (*iterSam);
-    exp->ConvertEventRates();
-  }
+  ConvertSampleEventRates();
 
   // Print out statements on approximate memory usage for profiling.
   LOG(REC) << "Filled " << fillcount << " signal events." << std::endl;
@@ -706,10 +1195,12 @@ void JointFCN::ReconfigureUsingManager() {
     LOG(REC) << " -> Saved " << fillcount
              << " signal boxes for faster access. (~" << mem << " MB)"
              << std::endl;
-    if (fIsAllSplines and !fSignalEventSplines.empty()) {
-      int splmem = sizeof(float) * fSignalEventSplines.size() *
-                   fSignalEventSplines[0].size() * 1E-6;
-      LOG(REC) << " -> Saved " << fillcount << " " << fSignalEventSplines.size()
+    if (fIsAllSplines and !fSignalEventSplineOffsets.empty()) {
+      int splmem = (sizeof(float) * fSignalEventSplines.size() +
+                    sizeof(UInt_t) * fSignalEventSplineMasks.size() +
+                    sizeof(size_t) * fSignalEventSplineOffsets.size() +
+                    sizeof(size_t) * fSignalEventMaskOffsets.size()) * 1E-6;
+      LOG(REC) << " -> Saved " << fSignalEventSplineOffsets.size()
                << " spline sets into memory. (~" << splmem << " MB)"
                << std::endl;
     }
@@ -762,14 +1253,12 @@ void JointFCN::ReconfigureFastUsingManager() {
   }
 
   bool fFillNuisanceEvent =
-    FitPar::Config().GetParB("FullEventOnSignalReconfigure");
+    FitPar::Config().GetSnapshot().FullEventOnSignalReconfigure;
 
   // Setup fast vector iterators.
   std::vector<bool>::iterator inpsig_iter = fSignalEventFlags.begin();
   std::vector<std::vector<MeasurementVariableBox*> >::iterator box_iter =
     fSignalEventBoxes.begin();
-  std::vector<std::vector<float> >::iterator spline_iter =
-    fSignalEventSplines.begin();
   std::vector<std::vector<bool> >::iterator samsig_iter =
     fSampleSignalFlags.begin();
   int splinecount = 0;
@@ -799,7 +1288,6 @@ void JointFCN::ReconfigureFastUsingManager() {
 
   inp_iter = fInputList.begin();
   inpsig_iter = fSignalEventFlags.begin();
-  spline_iter = fSignalEventSplines.begin();
 
   // Loop over all signal flags
   // For each valid signal flag add one to splinecount
@@ -822,14 +1310,14 @@ void JointFCN::ReconfigureFastUsingManager() {
             curevent = curinput->GetNuisanceEvent(i);
           else
             curevent = curinput->GetBaseEvent(i);
+
+          curevent->RWWeight = FitBase::GetRW()->CalcWeight(curevent);
+          curevent->Weight = curevent->RWWeight * curevent->InputWeight;
+          rwweight = curevent->Weight;
         } else {
-          curevent->fSplineCoeff = &fSignalEventSplines[splinecount][0];
+          rwweight = CalcSignalEventWeight(iinput, splinecount);
         }
 
-        curevent->RWWeight = FitBase::GetRW()->CalcWeight(curevent);
-        curevent->Weight = curevent->RWWeight * curevent->InputWeight;
-        rwweight = curevent->Weight;
-
         coreeventweights[splinecount] = rwweight;
         if (countwidth && ((splinecount % countwidth) == 0)) {
           LOG(REC) << "Processed " << splinecount
@@ -850,7 +1338,6 @@ void JointFCN::ReconfigureFastUsingManager() {
 
   // Reset Iterators
   inpsig_iter = fSignalEventFlags.begin();
-  spline_iter = fSignalEventSplines.begin();
   box_iter = fSignalEventBoxes.begin();
   samsig_iter = fSampleSignalFlags.begin();
   int nsplineweights = splinecount;
@@ -891,7 +1378,6 @@ void JointFCN::ReconfigureFastUsingManager() {
     // Iterate over the main signal event containers.
     samsig_iter++;
     box_iter++;
-    spline_iter++;
     splinecount++;
   }
   // End of Fast Event Loop ===================
@@ -900,11 +1386,7 @@ void JointFCN::ReconfigureFastUsingManager() {
 
   // Now loop over all Measurements
   // Convert Binned events
-  iterSam = fSamples.begin();
-  for (; iterSam != fSamples.end(); iterSam++) {
-    MeasurementBase* exp = (*iterSam);
-    exp->ConvertEventRates();
-  }
+  ConvertSampleEventRates();
 
   // Cleanup coreeventweights
   if (fIsAllSplines) {
@@ -917,10 +1399,345 @@ void JointFCN::ReconfigureFastUsingManager() {
            << time(NULL) - timestart << std::endl;
 }
 
+//***************************************************
+double JointFCN::CalcSignalEventWeight(int iinput, int ievt) {
+//***************************************************
+
+  // Point the shared base event at the cached spline coefficients
+  BaseFitEvt* curevent = fInputList[iinput]->FirstBaseEvent();
+  size_t off = fSignalEventSplineOffsets[ievt];
+  curevent->fSplineCoeff = fSignalEventSplines.empty() ? NULL : &fSignalEventSplines[0] + off;
+  if (curevent->fSplineMask) {
+    curevent->fSplineMask = &fSignalEventSplineMasks[fSignalEventMaskOffsets[ievt]];
+  }
+
+  // Mode norm dials read the mode from the shared base event
+  curevent->Mode = fSignalEventModes[ievt];
+
+  curevent->RWWeight = FitBase::GetRW()->CalcWeight(curevent);
+  curevent->Weight = curevent->RWWeight * curevent->InputWeight;
+  return curevent->Weight;
+}
+
+//***************************************************
+bool JointFCN::SetupDeltaUpdates() {
+//***************************************************
+
+  fDeltaReady = false;
+  FitWeight* rw = FitBase::GetRW();
+  std::vector<std::string> names = rw->GetDialNames();
+  std::vector<int> enums = rw->GetDialEnums();
+  int ndials = names.size();
+  int nevents = fSignalEventBoxes.size();
+
+  // Flat likelihood histogram cells of every subsample
+  fDeltaSampleOffsets.clear();
+  fDeltaNCells = 0;
+  std::vector<int> samplecells;
+  for (size_t i = 0; i < fSubSampleList.size(); i++) {
+    std::vector<TH1*> mclist = fSubSampleList[i]->GetMCList();
+    TArrayD* cells = mclist.empty() ? NULL : dynamic_cast<TArrayD*>(mclist[0]);
+    if (!cells) {
+      LOG(FIT) << "No delta updates for sample "
+               << fSubSampleList[i]->GetName() << std::endl;
+      return false;
+    }
+    fDeltaSampleOffsets.push_back(fDeltaNCells);
+    samplecells.push_back(cells->GetSize());
+    fDeltaNCells += cells->GetSize();
+  }
+
+  // Input of each cached signal event
+  fDeltaEventInputs.clear();
+  int sigcount = 0;
+  for (size_t iinput = 0; iinput < fInputList.size(); iinput++) {
+    for (int i = 0; i < fInputList[iinput]->GetNEvents(); i++, sigcount++) {
+      if (fSignalEventFlags[sigcount]) fDeltaEventInputs.push_back(iinput);
+    }
+  }
+  if ((int)fDeltaEventInputs.size() != nevents or
+      (int)fSignalEventModes.size() != nevents) {
+    LOG(FIT) << "No delta updates, signal cache does not match the inputs." << std::endl;
+    return false;
+  }
+
+  // Cells each event fills, in the same order as the fast loop
+  fDeltaCellOffsets.clear();
+  fDeltaCells.clear();
+  for (int ievt = 0; ievt < nevents; ievt++) {
+    fDeltaCellOffsets.push_back(fDeltaCells.size());
+    std::vector<MeasurementVariableBox*>& boxes = fSignalEventBoxes[ievt];
+    size_t ibox = 0;
+    for (size_t isam = 0; isam < fSubSampleList.size(); isam++) {
+      if (!fSampleSignalFlags[ievt][isam]) continue;
+      int bin = fSubSampleList[isam]->GetLikelihoodBin(boxes[ibox++]);
+      if (bin < 0 or bin >= samplecells[isam]) {
+        LOG(FIT) << "No delta updates for sample "
+                 << fSubSampleList[isam]->GetName() << std::endl;
+        return false;
+      }
+      fDeltaCells.push_back(fDeltaSampleOffsets[isam] + bin);
+    }
+  }
+  fDeltaCellOffsets.push_back(fDeltaCells.size());
+
+  // Spline and mode norm dials act on known events, anything else on all
+  std::map<int, int> modedials;
+  fDeltaDialAll.assign(ndials, false);
+  for (int k = 0; k < ndials; k++) {
+    int type = Reweight::GetDialType(enums[k]);
+    if (type == kMODENORM) {
+      modedials[Reweight::RemoveDialType(enums[k])] = k;
+    } else if (type != kSPLINEPARAMETER and type != kNORM) {
+      fDeltaDialAll[k] = true;
+    }
+  }
+
+  // Spline dimensions follow every RW dial whose comma separated names match
+  std::vector<std::vector<std::vector<int> > > splinedials(fInputList.size());
+  for (size_t iinput = 0; iinput < fInputList.size(); iinput++) {
+    SplineReader* reader = fInputList[iinput]->FirstBaseEvent()->fSplineRead;
+    if (!reader) {
+      LOG(FIT) << "No delta updates for input "
+               << fInputList[iinput]->GetName() << std::endl;
+      return false;
+    }
+
+    splinedials[iinput].resize(reader->fAllSplines.size());
+    for (size_t i = 0; i < reader->fAllSplines.size(); i++) {
+      std::vector<std::string>& splitnames = reader->fAllSplines[i].fSplitNames;
+      for (int k = 0; k < ndials; k++) {
+        std::vector<std::string> allnames = GeneralUtils::ParseToStr(names[k], ",");
+        for (size_t j = 0; j < splitnames.size(); j++) {
+          if (std::find(allnames.begin(), allnames.end(), splitnames[j]) != allnames.end()) {
+            splinedials[iinput][i].push_back(k);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  // Group events by the set of dials their weight responds to
+  std::map<std::vector<int>, int> groupids;
+  fDeltaGroupEvents.clear();
+  fDeltaDialGroups.assign(ndials, std::vector<int>());
+  for (int ievt = 0; ievt < nevents; ievt++) {
+    int iinput = fDeltaEventInputs[ievt];
+    BaseFitEvt* curevent = fInputList[iinput]->FirstBaseEvent();
+    SplineReader* reader = curevent->fSplineRead;
+
+    const float* coeff = fSignalEventSplines.empty() ? NULL :
+      &fSignalEventSplines[0] + fSignalEventSplineOffsets[ievt];
+    const UInt_t* mask = NULL;
+    if (curevent->fSplineMask) {
+      mask = &fSignalEventSplineMasks[fSignalEventMaskOffsets[ievt]];
+    }
+
+    std::vector<int> dials;
+    for (size_t i = 0; i < reader->fAllSplines.size(); i++) {
+      bool response = false;
+      if (mask) {
+        response = mask[i / 32] & (1u << (i % 32));
+      } else if (coeff) {
+        int npar = reader->fAllSplines[i].GetNPar();
+        for (int j = 0; j < npar and !response; j++) {
+          response = (coeff[reader->fCoeffOffsets[i] + j] != 0.0);
+        }
+      }
+      if (response) {
+        dials.insert(dials.end(), splinedials[iinput][i].begin(),
+                     splinedials[iinput][i].end());
+      }
+    }
+
+    std::map<int, int>::iterator modeiter =
+      modedials.find(ModeNormEngine::ModeToDial(abs(fSignalEventModes[ievt])));
+    if (modeiter != modedials.end()) dials.push_back(modeiter->second);
+
+    std::sort(dials.begin(), dials.end());
+    dials.erase(std::unique(dials.begin(), dials.end()), dials.end());
+
+    std::map<std::vector<int>, int>::iterator groupiter = groupids.find(dials);
+    int group;
+    if (groupiter == groupids.end()) {
+      group = fDeltaGroupEvents.size();
+      groupids[dials] = group;
+      fDeltaGroupEvents.push_back(std::vector<int>());
+      for (size_t k = 0; k < dials.size(); k++) {
+        fDeltaDialGroups[dials[k]].push_back(group);
+      }
+    } else {
+      group = groupiter->second;
+    }
+    fDeltaGroupEvents[group].push_back(ievt);
+  }
+
+  // Each group keeps a full set of sumw and sumw2 bin sums, cap them at ~32 MB
+  int ngroups = fDeltaGroupEvents.size();
+  double nsums = double(ngroups) * double(fDeltaNCells);
+  if (nsums > 2E6) {
+    LOG(FIT) << "No delta updates, " << ngroups << " response groups over "
+             << fDeltaNCells << " bins is too large." << std::endl;
+    return false;
+  }
+  fDeltaSumw.assign(ngroups * fDeltaNCells, 0.0);
+  fDeltaSumw2.assign(ngroups * fDeltaNCells, 0.0);
+  fDeltaTotal.assign(2 * fDeltaNCells, 0.0);
+  fDeltaDialVals.clear();
+  fDeltaCount = 0;
+  fDeltaReady = true;
+
+  LOG(FIT) << "Delta updates : " << nevents << " signal events in "
+           << ngroups << " response groups." << std::endl;
+  return true;
+}
+
+//***************************************************
+bool JointFCN::ReconfigureDeltaUsingManager() {
+//***************************************************
+
+  // Only the likelihood histograms can be rebuilt from bin sums
+  if (!fUseDeltaUpdates or !fFitPhase or !fIsAllSplines or
+      fSignalEventBoxes.empty()) {
+    return false;
+  }
+
+  if (!fDeltaReady and !SetupDeltaUpdates()) {
+    LOG(FIT) << "Delta updates disabled, using fast reconfigures." << std::endl;
+    fUseDeltaUpdates = false;
+    return false;
+  }
+
+  LOG(REC) << " -> Doing DELTA using manager" << std::endl;
+  int timestart = time(NULL);
+
+  // Groups responding to a dial that moved since the last update
+  std::vector<double> dialvals = FitBase::GetRW()->GetDialValues();
+  int ngroups = fDeltaGroupEvents.size();
+  std::vector<bool> update(ngroups, dialvals.size() != fDeltaDialVals.size());
+  for (size_t k = 0; k < fDeltaDialVals.size() and k < dialvals.size(); k++) {
+    if (dialvals[k] == fDeltaDialVals[k]) continue;
+    if (fDeltaDialAll[k]) {
+      update.assign(ngroups, true);
+      break;
+    }
+    for (size_t j = 0; j < fDeltaDialGroups[k].size(); j++) {
+      update[fDeltaDialGroups[k][j]] = true;
+    }
+  }
+  fDeltaDialVals = dialvals;
+
+  // Tell each fSplineRead in BaseFitEvent to reconf next weight calc
+  for (size_t iinput = 0; iinput < fInputList.size(); iinput++) {
+    fInputList[iinput]->FirstBaseEvent()->fSplineRead->SetNeedsReconfigure(true);
+  }
+
+  // Group sums are rebuilt rather than adjusted so rounding never accumulates
+  int nreweighted = 0;
+  for (int g = 0; g < ngroups; g++) {
+    if (!update[g]) continue;
+    double* sumw = &fDeltaSumw[g * fDeltaNCells];
+    double* sumw2 = &fDeltaSumw2[g * fDeltaNCells];
+    std::fill(sumw, sumw + fDeltaNCells, 0.0);
+    std::fill(sumw2, sumw2 + fDeltaNCells, 0.0);
+
+    std::vector<int>& events = fDeltaGroupEvents[g];
+    for (size_t i = 0; i < events.size(); i++) {
+      int ievt = events[i];
+      double w = CalcSignalEventWeight(fDeltaEventInputs[ievt], ievt);
+      for (size_t c = fDeltaCellOffsets[ievt]; c < fDeltaCellOffsets[ievt + 1]; c++) {
+        sumw[fDeltaCells[c]] += w;
+        sumw2[fDeltaCells[c]] += w * w;
+      }
+    }
+    nreweighted += events.size();
+  }
+
+  // Sum the groups into the likelihood histograms
+  std::fill(fDeltaTotal.begin(), fDeltaTotal.end(), 0.0);
+  double* total = &fDeltaTotal[0];
+  double* total2 = &fDeltaTotal[fDeltaNCells];
+  for (int g = 0; g < ngroups; g++) {
+    const double* sumw = &fDeltaSumw[g * fDeltaNCells];
+    const double* sumw2 = &fDeltaSumw2[g * fDeltaNCells];
+    for (int c = 0; c < fDeltaNCells; c++) {
+      total[c] += sumw[c];
+      total2[c] += sumw2[c];
+    }
+  }
+
+  for (size_t isam = 0; isam < fSubSampleList.size(); isam++) {
+    int off = fDeltaSampleOffsets[isam];
+    if (!fSubSampleList[isam]->SetLikelihoodBins(total + off, total2 + off)) {
+      LOG(FIT) << "No delta updates for sample " << fSubSampleList[isam]->GetName()
+               << ", using fast reconfigures." << std::endl;
+      fUseDeltaUpdates = false;
+      fDeltaReady = false;
+      return false;
+    }
+  }
+
+  ConvertSampleEventRates();
+
+  LOG(REC) << "Reweighted " << nreweighted << "/" << fSignalEventBoxes.size()
+           << " signal events." << std::endl;
+  LOG(REC) << "Time taken ReconfigureDeltaUsingManager() : "
+           << time(NULL) - timestart << std::endl;
+
+  // Compare against a full refill after setup and then periodically
+  if (fDeltaCount == 0 or (fDeltaCheckEvery > 0 and fDeltaCount >= fDeltaCheckEvery)) {
+    fDeltaCount = 0;
+    if (!CheckDeltaUpdates()) {
+      fUseDeltaUpdates = false;
+      fDeltaReady = false;
+    }
+  }
+  fDeltaCount++;
+
+  return true;
+}
+
+//***************************************************
+bool JointFCN::CheckDeltaUpdates() {
+//***************************************************
+
+  std::vector<double> likedelta;
+  MeasListConstIter iterSam = fSamples.begin();
+  for (; iterSam != fSamples.end(); iterSam++) {
+    likedelta.push_back((*iterSam)->GetLikelihood());
+  }
+
+  // Samples are left with the fast refill either way
+  ReconfigureFastUsingManager();
+
+  bool pass = true;
+  size_t count = 0;
+  for (iterSam = fSamples.begin(); iterSam != fSamples.end(); iterSam++, count++) {
+    double likefull = (*iterSam)->GetLikelihood();
+    if (fabs(likefull - likedelta[count]) > 1E-6 * std::max(1.0, fabs(likefull))) {
+      ERR(WRN) << "Delta update likelihood for " << (*iterSam)->GetName()
+               << " differs from a full refill : " << likedelta[count]
+               << " vs " << likefull << std::endl;
+      pass = false;
+    }
+  }
+
+  if (!pass) ERR(WRN) << "Disabling delta updates." << std::endl;
+  return pass;
+}
+
 //***************************************************
 void JointFCN::Write() {
 //***************************************************
 
+  // Samples last reconfigured by DoEval skipped their display histograms
+  if (fFitPhase) {
+    LOG(MIN) << "Rebuilding sample histograms before writing.." << std::endl;
+    SetFitPhase(false);
+    ReconfigureBinResponseSamples();
+  }
+
   // Save a likelihood/ndof plot
   LOG(MIN) << "Writing likelihood plot.." << std::endl;
   std::vector<double> likes;
@@ -34,6 +34,7 @@
 #include "NuisKey.h"
 #include "MeasurementVariableBox.h"
 #include "MeasurementVariableBox1D.h"
+#include "BinSplineResponse.h"
 
 using namespace FitUtils;
 using namespace FitBase;
@@ -117,6 +118,23 @@ public:
   //! Reconfigure Fast looping over duplicate inputs
   void ReconfigureFastUsingManager();
 
+  //! Build bin level response functions from full reconfigures on the knot grid
+  void SetupBinResponses();
+
+  //! Predict MC histograms from bin responses, falling back to a
+  //! full reconfigure when non-factorisable dials change.
+  void ReconfigureBinResponses();
+
+  //! Check every sample and pull supports an analytic gradient and map
+  //! spline dimensions onto RW dials. Returns false if not supported.
+  bool SetupGradient();
+
+  //! Likelihood and its gradient with respect to the RW dials at x
+  double DoEvalGradient(const double* x, double* grad);
+
+  //! Compare the analytic gradient at x against central finite differences
+  bool CheckGradient(const double* x, double tolerance);
+
 
   /// Throws data according to current stats
   void ThrowDataToy();
@@ -154,7 +172,10 @@ private:
 
   bool fUsingEventManager; //!< Flag for doing joint comparisons
 
-  std::vector< std::vector<float> > fSignalEventSplines;
+  std::vector< float > fSignalEventSplines;         //!< Flat coefficients for all signal events
+  std::vector< UInt_t > fSignalEventSplineMasks;    //!< Flat response masks if packed splines used
+  std::vector< size_t > fSignalEventSplineOffsets;  //!< Start of each signal event's coefficients
+  std::vector< size_t > fSignalEventMaskOffsets;    //!< Start of each signal event's mask, packed events only
   std::vector< std::vector<MeasurementVariableBox*> > fSignalEventBoxes;
   std::vector< bool > fSignalEventFlags;
   std::vector< std::vector<bool> > fSampleSignalFlags;
@@ -163,6 +184,73 @@ private:
   std::vector<MeasurementBase*> fSubSampleList;
   bool fIsAllSplines;
 
+  bool fUseBinResponses;               //!< Flag for bin level response prediction
+  BinSplineResponse* fBinResponse;     //!< Bin level response functions
+
+  //! Reconfigure at the current RW dials without counting an iteration. Not
+  //! fullconfig replays the cached signal events once the MC has been filled.
+  void ReconfigureBinResponseSamples(bool fullconfig = true);
+
+  //! Whether thread safe samples are finalised concurrently
+  bool UseParallelSamples();
+
+  //! ConvertEventRates for every sample, thread safe ones in parallel
+  void ConvertSampleEventRates();
+
+  bool fParallelSamples;                    //!< Config parallel_samples
+
+  //! Tell every sample whether only likelihood histograms are needed
+  void SetFitPhase(bool fitphase);
+
+  bool fUseFitPhase;  //!< Config fit_phase
+  bool fFitPhase;     //!< Samples hold likelihood histograms only
+
+  //! Group the cached signal events by the dials their weight responds to
+  //! and record the likelihood bins each one fills. False if unsupported.
+  bool SetupDeltaUpdates();
+
+  //! Fit phase fast reconfigure that only reweights the events of response
+  //! groups whose dials changed since the last call. False if the normal
+  //! fast loop has to be used instead.
+  bool ReconfigureDeltaUsingManager();
+
+  //! Current weight of cached signal event ievt of input iinput
+  double CalcSignalEventWeight(int iinput, int ievt);
+
+  //! Compare the delta updated likelihoods against a normal fast refill
+  bool CheckDeltaUpdates();
+
+  bool fUseDeltaUpdates;    //!< Config delta_updates
+  int  fDeltaCheckEvery;    //!< Config delta_updates_check
+  bool fDeltaReady;         //!< Delta update cache matches the signal cache
+  int  fDeltaCount;         //!< Delta updates since the last check
+  int  fDeltaNCells;        //!< Likelihood bins over all subsamples
+  std::vector<int> fSignalEventModes;      //!< Mode of each cached signal event
+  std::vector<int> fDeltaEventInputs;      //!< Input of each cached signal event
+  std::vector<int> fDeltaSampleOffsets;    //!< First cell of each subsample
+  std::vector<size_t> fDeltaCellOffsets;   //!< First entry of each event in fDeltaCells
+  std::vector<int> fDeltaCells;            //!< Cells filled by each cached signal event
+  std::vector< std::vector<int> > fDeltaGroupEvents;  //!< [group] cached signal events
+  std::vector< std::vector<int> > fDeltaDialGroups;   //!< [dial] groups responding to it
+  std::vector<bool> fDeltaDialAll;         //!< Dial reweights every event
+  std::vector<double> fDeltaSumw;          //!< [group * fDeltaNCells + cell]
+  std::vector<double> fDeltaSumw2;         //!< [group * fDeltaNCells + cell]
+  std::vector<double> fDeltaTotal;         //!< Summed groups, sumw then sumw2
+  std::vector<double> fDeltaDialVals;      //!< Dials of the last delta update
+  std::vector<MeasurementBase*> fSampleVect; //!< fSamples in order, for indexed loops
+  std::vector<double> fSampleLikeVect;       //!< Per sample likelihoods before reduction
+
+  //! Gradient of the current likelihood from one pass over the cached
+  //! signal event splines. Requires a DoEval at the same dials first.
+  void CalcGradient(double* grad);
+
+  bool fUseGradient;                   //!< Analytic gradient set up
+  std::vector<int> fGradNormDials;     //!< RW dial of each subsample norm, -1 if none
+  std::vector< std::vector<int> > fGradSlotDials; //!< [input][spline slot] RW dial, -1 if none
+  std::vector<double> fGradSlots;      //!< Slot derivatives for one event
+  std::vector< std::vector<double> > fGradDLDMC;   //!< [subsample][bin] MC * dL/dMC
+  std::vector< std::vector<double> > fGradRaw;     //!< [subsample][bin] filled weight
+  std::vector< std::vector<double> > fGradDeriv;   //!< [subsample][bin * ndials + dial]
 
   std::vector< int > fIterationCount;
   std::vector< double > fCurrentValues;
@@ -5,10 +5,12 @@
 *  @{  
 */
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include "FitLogger.h"
 #include "JointFCN.h"
+#include "Math/IFunction.h"
 
 
 //! Wrapper for JointFCN to make ROOT minimization behave sensibly.
@@ -78,5 +80,77 @@ class MinimizerFCN{
   
   JointFCN* fFCN;
 };
+
+//! Analytic gradient wrapper for JointFCN. Only valid once
+//! JointFCN::SetupGradient has succeeded.
+class MinimizerGradFCN : public ROOT::Math::IMultiGradFunction {
+ public:
+
+  // Construct from function and number of dials
+  MinimizerGradFCN(JointFCN* f, unsigned int ndim){
+    fFCN = f;
+    fNDim = ndim;
+  };
+
+  // Destroy (Doesn't delete FCN)
+  ~MinimizerGradFCN(){
+  };
+
+  // Copies share the same FCN
+  inline ROOT::Math::IBaseFunctionMultiDim* Clone() const
+  {
+    return new MinimizerGradFCN(fFCN, fNDim);
+  };
+
+  inline unsigned int NDim() const
+  {
+    return fNDim;
+  };
+
+  // Full gradient from a single pass over the signal events
+  inline void Gradient(const double* x, double* grad) const
+  {
+    FillGradient(x);
+    std::copy(fGrad.begin(), fGrad.end(), grad);
+  };
+
+  inline void FdF(const double* x, double& f, double* df) const
+  {
+    f = fFCN->DoEvalGradient(x, df);
+    fGradX.assign(x, x + fNDim);
+    fGrad.assign(df, df + fNDim);
+  };
+
+ private:
+
+  inline double DoEval(const double* x) const
+  {
+    return fFCN->DoEval(x);
+  };
+
+  // Single components are read from the gradient at the last x
+  inline double DoDerivative(const double* x, unsigned int icoord) const
+  {
+    FillGradient(x);
+    return fGrad[icoord];
+  };
+
+  // Only runs the pass over the signal events when x has moved
+  inline void FillGradient(const double* x) const
+  {
+    if (fGradX.size() == fNDim and std::equal(x, x + fNDim, fGradX.begin())) {
+      return;
+    }
+    fGrad.resize(fNDim);
+    fFCN->DoEvalGradient(x, &fGrad[0]);
+    fGradX.assign(x, x + fNDim);
+  };
+
+  JointFCN* fFCN;
+  unsigned int fNDim;
+  mutable std::vector<double> fGradX; //!< x of the cached gradient
+  mutable std::vector<double> fGrad;  //!< gradient at fGradX
+};
+
 /*! @} */
 #endif // _MINIMIZER_FCN_H_
@@ -26,6 +26,7 @@ FNAL_CC1ppim_XSec_1DEnu_antinu::FNAL_CC1ppim_XSec_1DEnu_antinu(nuiskey samplekey
   fSettings.SetDataInput(  FitPar::GetDataBase() + "FNAL/CC1ppim_on_p/FNAL_CC1ppim_on_p_Enu.csv");
 
   FinaliseSampleSettings();
+  SetPreselection(-14);
 
   // Scaling Setup ---------------------------------------------------
   // ScaleFactor for shape
@@ -17,12 +17,17 @@
 *    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
 *******************************************************************************/
 #include "JointMeas1D.h"
+#include "OpenMPWrapper.h"
+#include "RVersion.h"
 
 
 //********************************************************************
 JointMeas1D::JointMeas1D(void) {
 //********************************************************************
 
+  // Chi2 setups take masked forms of covar from the sample cache
+  fChi2Eval.SetCovarianceCache(&fCovarCache);
+
   // XSec Scalings
   fScaleFactor = -1.0;
   fCurrentNorm = 1.0;
@@ -39,6 +44,7 @@ JointMeas1D::JointMeas1D(void) {
 
   // Covar
   covar = NULL;
+  fCovarGen = 0;
   fFullCovar = NULL;
 
   fCovar  = NULL;
@@ -72,6 +78,7 @@ JointMeas1D::JointMeas1D(void) {
 
   // Extra Histograms
   fMCHist_Modes = NULL;
+  fFluxUnfoldScale = 0.0;
 
   for (std::vector<MeasurementBase*>::const_iterator iter = fSubChain.begin();
        iter != fSubChain.end(); iter++) {
@@ -87,6 +94,10 @@ JointMeas1D::JointMeas1D(void) {
 
   fIsJoint = true;
 
+  // Subsamples are finalised through the parent, keep these serial
+  fThreadSafe = false;
+  fParallelSubSamples = FitPar::Config().GetParB("parallel_subsamples");
+
 }
 
 
@@ -350,6 +361,7 @@ void JointMeas1D::SetCovarFromDiagonal(TH1D* data) {
     fFullCovar = StatUtils::MakeDiagonalCovarMatrix(data);
     covar      = StatUtils::GetInvert(fFullCovar);
     fDecomp    = StatUtils::GetDecomp(fFullCovar);
+    fCovarGen++;
   } else {
     ERR(FTL) << "No data input provided to set diagonal covar from!" << std::endl;
 
@@ -372,6 +384,7 @@ void JointMeas1D::SetCovarFromTextFile(std::string covfile, int dim) {
   
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -394,6 +407,7 @@ void JointMeas1D::SetCovarFromMultipleTextFiles(std::string covfiles, int dim) {
   }
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -406,6 +420,7 @@ void JointMeas1D::SetCovarFromRootFile(std::string covfile, std::string histname
   fFullCovar = StatUtils::GetCovarFromRootFile(covfile, histname);
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -417,6 +432,7 @@ void JointMeas1D::SetCovarInvertFromTextFile(std::string covfile, int dim) {
   covar       = StatUtils::GetCovarFromTextFile(covfile, dim);
   fFullCovar  = StatUtils::GetInvert(covar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -428,6 +444,7 @@ void JointMeas1D::SetCovarInvertFromRootFile(std::string covfile, std::string hi
   covar      = StatUtils::GetCovarFromRootFile(covfile, histname);
   fFullCovar = StatUtils::GetInvert(covar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -456,6 +473,7 @@ void JointMeas1D::SetCorrelationFromTextFile(std::string covfile, int dim) {
   // Fill other covars.
   covar   = StatUtils::GetInvert(fFullCovar);
   fDecomp = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete correlation;
 }
@@ -488,6 +506,7 @@ void JointMeas1D::SetCorrelationFromMultipleTextFiles(std::string corrfiles, int
   }
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -516,6 +535,7 @@ void JointMeas1D::SetCorrelationFromRootFile(std::string covfile, std::string hi
   // Fill other covars.
   covar   = StatUtils::GetInvert(fFullCovar);
   fDecomp = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete correlation;
 }
@@ -548,6 +568,7 @@ void JointMeas1D::SetCholDecompFromTextFile(std::string covfile, int dim) {
   fFullCovar  = new TMatrixDSym(dim, trans->GetMatrixArray(), "");
   covar       = StatUtils::GetInvert(fFullCovar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete temp;
   delete trans;
@@ -568,6 +589,7 @@ void JointMeas1D::SetCholDecompFromRootFile(std::string covfile, std::string his
   fFullCovar  = new TMatrixDSym(temp->GetNrows(), trans->GetMatrixArray(), "");
   covar       = StatUtils::GetInvert(fFullCovar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete temp;
   delete trans;
@@ -583,9 +605,15 @@ void JointMeas1D::ScaleData(double scale) {
 //********************************************************************
 void JointMeas1D::ScaleCovar(double scale) {
 //********************************************************************
+  bool cached = fCovarCache.IsSetup(fCovarGen);
+  if (cached) fCovarCache.Scale(scale);
   (*fFullCovar) *= scale;
   (*covar) *= 1.0 / scale;
   (*fDecomp) *= sqrt(scale);
+
+  // The cache was rescaled in step, only the chi2 setup is stale
+  fCovarGen++;
+  if (cached) fCovarCache.SetGeneration(fCovarGen);
 }
 
 
@@ -601,6 +629,7 @@ void JointMeas1D::SetBinMask(std::string maskfile) {
   fMaskHist =
     new TH1I((fSettings.GetName() + "_BINMASK").c_str(),
              (fSettings.GetName() + "_BINMASK; Bin; Mask?").c_str(), nbins, 0, nbins);
+  fCovarGen++;
   std::string line;
   std::ifstream mask(maskfile.c_str(), ifstream::in);
 
@@ -660,6 +689,11 @@ void JointMeas1D::FinaliseMeasurement() {
     fDecomp = StatUtils::GetDecomp(fFullCovar);
   }
 
+  // Keep the full forms so later masking, rescaling and throws reuse them
+  // Samples may have set their matrices directly before finalising
+  fCovarGen++;
+  fCovarCache.Setup(fCovarGen, fFullCovar, covar, fDecomp);
+
   // Push the diagonals of fFullCovar onto the data histogram
   // Comment out until scaling is used consistently...
   StatUtils::SetDataErrorFromCov(fDataHist, fFullCovar, 1E-38);
@@ -867,6 +901,11 @@ void JointMeas1D::SetSmearingMatrix(std::string smearfile, int truedim,
     }
     row++;
   }
+
+  // Mostly band diagonal, so apply it from a sparse copy
+  fSmearCSR.Setup(fSmearMatrix);
+  LOG(SAM) << "Smearing matrix has " << fSmearCSR.GetNNonZero() << "/"
+           << truedim * recodim << " non-zero elements" << std::endl;
   return;
 }
 
@@ -881,24 +920,11 @@ void JointMeas1D::ApplySmearingMatrix() {
     return;
   }
 
-  TH1D* unsmeared = (TH1D*)fMCHist->Clone();
-  TH1D* smeared = (TH1D*)fMCHist->Clone();
-  smeared->Reset();
+  if (!fSmearCSR.IsSetup()) fSmearCSR.Setup(fSmearMatrix);
 
-  // Loop over reconstructed bins
+  // Each reco bin sums the contributions from all true bins
   // true = row; reco = column
-  for (int rbin = 0; rbin < fSmearMatrix->GetNcols(); ++rbin) {
-    // Sum up the constributions from all true bins
-    double rBinVal = 0;
-
-    // Loop over true bins
-    for (int tbin = 0; tbin < fSmearMatrix->GetNrows(); ++tbin) {
-      rBinVal +=
-        (*fSmearMatrix)(tbin, rbin) * unsmeared->GetBinContent(tbin + 1);
-    }
-    smeared->SetBinContent(rbin + 1, rBinVal);
-  }
-  fMCHist = (TH1D*)smeared->Clone();
+  fSmearCSR.Apply(fMCHist);
 
   return;
 }
@@ -911,9 +937,13 @@ void JointMeas1D::ResetAll() {
 //********************************************************************
 
   fMCHist->Reset();
-  fMCFine->Reset();
   fMCStat->Reset();
 
+  // Display only histograms are left as they are during a fit
+  if (fFitPhase) return;
+
+  fMCFine->Reset();
+
   return;
 };
 
@@ -923,44 +953,67 @@ void JointMeas1D::FillHistograms() {
 
   if (Signal) {
     fMCHist->Fill(fXVar, Weight);
-    fMCFine->Fill(fXVar, Weight);
     fMCStat->Fill(fXVar, 1.0);
 
+    if (fFitPhase) return;
+    fMCFine->Fill(fXVar, Weight);
+
     if (fMCHist_Modes) fMCHist_Modes->Fill(Mode, fXVar, Weight);
   }
 
   return;
 };
 
+//********************************************************************
+void JointMeas1D::SetupFluxUnfolding() {
+//********************************************************************
+
+  fFluxUnfoldScale = fScaleFactor;
+  fFluxUnfoldFactors = PlotUtils::GetFluxUnfoldedFactors(
+      fMCHist, GetFluxHistogram(), GetEventHistogram(), fScaleFactor);
+
+  fFluxUnfoldFineFactors.clear();
+  if (fMCFine) {
+    fFluxUnfoldFineFactors = PlotUtils::GetFluxUnfoldedFactors(
+        fMCFine, GetFluxHistogram(), GetEventHistogram(), fScaleFactor);
+  }
+}
+
 //********************************************************************
 void JointMeas1D::ScaleEvents() {
 //********************************************************************
 
   LOG(FIT) << "Scaling JointMeas1D" << std::endl;
 
+  // Display only histograms are left unscaled during a fit
+  TH1D* fine = fFitPhase ? NULL : fMCFine;
+  TrueModeStack* modes = fFitPhase ? NULL : fMCHist_Modes;
+
   // Fill MCWeighted;
-  for (int i = 0; i < fMCHist->GetNbinsX(); i++) {
+  for (int i = 0; !fFitPhase and i < fMCHist->GetNbinsX(); i++) {
     fMCWeighted->SetBinContent(i + 1, fMCHist->GetBinContent(i + 1));
     fMCWeighted->SetBinError(i + 1,   fMCHist->GetBinError(i + 1));
   }
 
 
   // Setup Stat ratios for MC and MC Fine
-  double* statratio     = new double[fMCHist->GetNbinsX()];
+  fStatRatio.resize(fMCHist->GetNbinsX());
   for (int i = 0; i < fMCHist->GetNbinsX(); i++) {
     if (fMCHist->GetBinContent(i + 1) != 0) {
-      statratio[i] = fMCHist->GetBinError(i + 1) / fMCHist->GetBinContent(i + 1);
+      fStatRatio[i] = fMCHist->GetBinError(i + 1) / fMCHist->GetBinContent(i + 1);
     } else {
-      statratio[i] = 0.0;
+      fStatRatio[i] = 0.0;
     }
   }
 
-  double* statratiofine = new double[fMCFine->GetNbinsX()];
-  for (int i = 0; i < fMCFine->GetNbinsX(); i++) {
-    if (fMCFine->GetBinContent(i + 1) != 0) {
-      statratiofine[i] = fMCFine->GetBinError(i + 1) / fMCFine->GetBinContent(i + 1);
-    } else {
-      statratiofine[i] = 0.0;
+  if (fine) {
+    fStatRatioFine.resize(fine->GetNbinsX());
+    for (int i = 0; i < fine->GetNbinsX(); i++) {
+      if (fine->GetBinContent(i + 1) != 0) {
+        fStatRatioFine[i] = fine->GetBinError(i + 1) / fine->GetBinContent(i + 1);
+      } else {
+        fStatRatioFine[i] = 0.0;
+      }
     }
   }
 
@@ -970,19 +1023,21 @@ void JointMeas1D::ScaleEvents() {
     double datamcratio = fDataHist->Integral() / fMCHist->Integral();
 
     fMCHist->Scale(datamcratio);
-    fMCFine->Scale(datamcratio);
+    if (fine) fine->Scale(datamcratio);
 
-    if (fMCHist_Modes) fMCHist_Modes->Scale(datamcratio);
+    if (modes) modes->Scale(datamcratio);
 
     // Scaling for XSec as function of Enu
   } else if (fIsEnu1D) {
 
-    PlotUtils::FluxUnfoldedScaling(fMCHist, GetFluxHistogram(),
-                                   GetEventHistogram(), fScaleFactor,
-                                   fNEvents);
-    PlotUtils::FluxUnfoldedScaling(fMCFine, GetFluxHistogram(),
-                                   GetEventHistogram(), fScaleFactor,
-                                   fNEvents);
+    // Unfolding factors only depend on the binning and flux
+    if (fFluxUnfoldFactors.size() != (size_t)fMCHist->GetSize() or
+        fFluxUnfoldScale != fScaleFactor) {
+      SetupFluxUnfolding();
+    }
+
+    PlotUtils::ScaleByBinFactors(fMCHist, fFluxUnfoldFactors);
+    if (fine) PlotUtils::ScaleByBinFactors(fine, fFluxUnfoldFineFactors);
 
 
     // if (fMCHist_Modes) {
@@ -994,26 +1049,22 @@ void JointMeas1D::ScaleEvents() {
     // Any other differential scaling
   } else {
     fMCHist->Scale(fScaleFactor, "width");
-    fMCFine->Scale(fScaleFactor, "width");
+    if (fine) fine->Scale(fScaleFactor, "width");
 
-    if (fMCHist_Modes) fMCHist_Modes->Scale(fScaleFactor, "width");
+    if (modes) modes->Scale(fScaleFactor, "width");
   }
 
 
   // Proper error scaling - ROOT Freaks out with xsec weights sometimes
   for (int i = 0; i < fMCStat->GetNbinsX(); i++) {
-    fMCHist->SetBinError(i + 1, fMCHist->GetBinContent(i + 1) * statratio[i]);
+    fMCHist->SetBinError(i + 1, fMCHist->GetBinContent(i + 1) * fStatRatio[i]);
   }
 
-  for (int i = 0; i < fMCFine->GetNbinsX(); i++) {
-    fMCFine->SetBinError(i + 1, fMCFine->GetBinContent(i + 1) * statratiofine[i]);
+  for (int i = 0; fine and i < fine->GetNbinsX(); i++) {
+    fine->SetBinError(i + 1, fine->GetBinContent(i + 1) * fStatRatioFine[i]);
   }
 
 
-  // Clean up
-  delete statratio;
-  delete statratiofine;
-
   return;
 };
 
@@ -1024,7 +1075,7 @@ void JointMeas1D::ApplyNormScale(double norm) {
   fCurrentNorm = norm;
 
   fMCHist->Scale(1.0 / norm);
-  fMCFine->Scale(1.0 / norm);
+  if (!fFitPhase) fMCFine->Scale(1.0 / norm);
 
   return;
 };
@@ -1072,13 +1123,15 @@ double JointMeas1D::GetLikelihood() {
   double stat = 0.;
   if (fIsChi2) {
 
-    if (fIsRawEvents) {
-      stat = StatUtils::GetChi2FromEventRate(fDataHist, fMCHist, fMaskHist);
-    } else if (fIsDiag) {
-      stat = StatUtils::GetChi2FromDiag(fDataHist, fMCHist, fMaskHist);
-    } else if (!fIsDiag and !fIsRawEvents) {
-      stat = StatUtils::GetChi2FromCov(fDataHist, fMCHist, covar, fMaskHist);
+    int type = Chi2Evaluator::kChi2Cov;
+    if (fIsRawEvents) type = Chi2Evaluator::kChi2EventRate;
+    else if (fIsDiag) type = Chi2Evaluator::kChi2Diag;
+
+    // Masking and covariance packing are only redone when they change
+    if (!fChi2Eval.IsSetup(type, fCovarGen)) {
+      fChi2Eval.Setup(type, fCovarGen, fDataHist, covar, fMaskHist);
     }
+    stat = fChi2Eval.Eval(fDataHist, fMCHist);
 
   }
 
@@ -1091,7 +1144,7 @@ double JointMeas1D::GetLikelihood() {
   }
 
   // Return to normal scaling
-  if (fIsShape and !FitPar::Config().GetParB("saveshapescaling")) {
+  if (fIsShape and !FitPar::Config().GetSnapshot().saveshapescaling) {
     fMCHist->Scale(1. / scaleF);
     fMCFine->Scale(1. / scaleF);
   }
@@ -1150,24 +1203,32 @@ void JointMeas1D::SetFakeDataValues(std::string fakeOption) {
 
   // Make a new covariance for fake data hist.
   int nbins = fDataHist->GetNbinsX();
-  double alpha_i = 0.0;
-  double alpha_j = 0.0;
+  std::vector<double> alpha(nbins, 0.0);
+  for (int i = 0; i < nbins; i++) {
+    alpha[i] = fDataHist->GetBinContent(i + 1) / tempdata->GetBinContent(i + 1);
+  }
 
   for (int i = 0; i < nbins; i++) {
     for (int j = 0; j < nbins; j++) {
-      alpha_i = fDataHist->GetBinContent(i + 1) / tempdata->GetBinContent(i + 1);
-      alpha_j = fDataHist->GetBinContent(j + 1) / tempdata->GetBinContent(j + 1);
-
-      (*fFullCovar)(i, j) = alpha_i * alpha_j * (*fFullCovar)(i, j);
+      (*fFullCovar)(i, j) = alpha[i] * alpha[j] * (*fFullCovar)(i, j);
     }
   }
 
-  // Setup Covariances
+  // Setup Covariances, rescaling the cached forms rather than reinverting
   if (covar) delete covar;
-  covar   = StatUtils::GetInvert(fFullCovar);
-
   if (fDecomp) delete fDecomp;
-  fDecomp = StatUtils::GetInvert(fFullCovar);
+  if (fCovarCache.IsSetup(fCovarGen)) {
+    fCovarCache.ScaleBins(alpha);
+    covar   = (TMatrixDSym*) fCovarCache.GetInverse()->Clone();
+    fDecomp = (TMatrixDSym*) fCovarCache.GetDecomp()->Clone();
+  } else {
+    covar   = StatUtils::GetInvert(fFullCovar);
+    fDecomp = StatUtils::GetDecomp(fFullCovar);
+  }
+  fCovarGen++;
+  fCovarCache.Setup(fCovarGen, fFullCovar, covar, fDecomp);
+  fChi2Eval.Reset();
+  fThrower.Reset();
 
   delete tempdata;
 
@@ -1204,8 +1265,10 @@ void JointMeas1D::ThrowCovariance() {
   // Take a fDecomposition and use it to throw the current dataset.
   // Requires fDataTrue also be set incase used repeatedly.
 
-  if (fDataHist) delete fDataHist;
-  fDataHist = StatUtils::ThrowHistogram(fDataTrue, fFullCovar);
+  // Toys are thrown in batches and copied into fDataHist in place.
+  if (!fDataTrue) fDataTrue = (TH1D*) fDataHist->Clone();
+  if (!fThrower.IsSetup(fFullCovar)) SetupThrower();
+  fThrower.FillHistogram(fDataHist, fDataTrue, fThrower.NextToy());
 
   return;
 };
@@ -1214,8 +1277,23 @@ void JointMeas1D::ThrowCovariance() {
 void JointMeas1D::ThrowDataToy(){
 //********************************************************************
   if (!fDataTrue) fDataTrue = (TH1D*) fDataHist->Clone();
-  if (fMCHist) delete fMCHist;
-  fMCHist = StatUtils::ThrowHistogram(fDataTrue, fFullCovar);
+  if (!fThrower.IsSetup(fFullCovar)) SetupThrower();
+  fThrower.FillHistogram(fMCHist, fDataTrue, fThrower.NextToy());
+}
+
+//********************************************************************
+void JointMeas1D::SetupThrower() {
+//********************************************************************
+
+  // Covariance rows are the bins of fDataTrue
+  std::vector<int> bins;
+  for (int i = 0; i < fDataTrue->GetNbinsX(); i++) bins.push_back(i + 1);
+
+  if (fCovarCache.IsSetup(fCovarGen)) {
+    fThrower.SetupDecomp(fFullCovar, fCovarCache.GetDecomp(), bins);
+  } else {
+    fThrower.Setup(fFullCovar, bins);
+  }
 }
 
 
@@ -1632,15 +1710,117 @@ double JointMeas1D::TotalIntegratedFlux(std::string intOpt, double low,
 void JointMeas1D::Reconfigure() {
 //********************************************************************
 
+  ReconfigureSubSamples(false);
+  ConvertEventRates();
+  return;
+}
+
+//********************************************************************
+void JointMeas1D::ReconfigureFast() {
+//********************************************************************
+
+  ReconfigureSubSamples(true);
+  ConvertEventRates();
+  return;
+}
+
+//********************************************************************
+void JointMeas1D::SetupSubInputs() {
+//********************************************************************
+
+  fSubInputGroups.clear();
+  fSubInputSafe.clear();
+
+  // Plain subsamples on the same input handler share one event pass
   for (std::vector<MeasurementBase*>::const_iterator expIter =
          fSubChain.begin();
        expIter != fSubChain.end(); expIter++) {
     MeasurementBase* exp = *expIter;
-    exp->Reconfigure();
+    bool plain = (exp->GetSubSamples().size() == 1 and
+                  exp->GetSubSamples()[0] == exp);
+
+    size_t group = fSubInputGroups.size();
+    for (size_t i = 0; plain and i < fSubInputGroups.size(); i++) {
+      MeasurementBase* first = fSubInputGroups[i][0];
+      if (first->GetInput() == exp->GetInput() and
+          first->GetSubSamples()[0] == first) {
+        group = i;
+        break;
+      }
+    }
+
+    if (group == fSubInputGroups.size()) {
+      fSubInputGroups.push_back(std::vector<MeasurementBase*>());
+      fSubInputSafe.push_back(true);
+    }
+    fSubInputGroups[group].push_back(exp);
+    fSubInputSafe[group] = fSubInputSafe[group] and exp->IsThreadSafe();
   }
+}
 
-  ConvertEventRates();
-  return;
+//********************************************************************
+bool JointMeas1D::UseParallelSubSamples() {
+//********************************************************************
+
+  if (!fParallelSubSamples or omp_get_max_threads() < 2) return false;
+  if (fSubInputGroups.size() < 2 or !fRW->IsThreadSafe()) return false;
+
+  // Build the config snapshot here so samples only ever read it
+  Config::GetSnapshot();
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 0, 0)
+  // Guards ROOT's global object lists while samples create histograms
+  ROOT::EnableThreadSafety();
+  return true;
+#else
+  // ROOT 5 has no lock for its global object lists, stay serial
+  return false;
+#endif
+}
+
+//********************************************************************
+void JointMeas1D::ReconfigureSubInput(size_t group, bool fast) {
+//********************************************************************
+
+  std::vector<MeasurementBase*>& samples = fSubInputGroups[group];
+
+  // Signal replays are cheap enough to keep per sample
+  if (samples.size() == 1 or fast) {
+    for (size_t i = 0; i < samples.size(); i++) {
+      if (fast) samples[i]->ReconfigureFast();
+      else samples[i]->Reconfigure();
+    }
+    return;
+  }
+
+  MeasurementBase::ReconfigureSharedInput(samples);
+}
+
+//********************************************************************
+void JointMeas1D::ReconfigureSubSamples(bool fast) {
+//********************************************************************
+
+  if (fSubInputGroups.empty()) SetupSubInputs();
+
+  // Groups on different inputs are independent until MakePlots
+  int ngroups = fSubInputGroups.size();
+  bool parallel = UseParallelSubSamples();
+  bool adddir = TH1::AddDirectoryStatus();
+  if (parallel) TH1::AddDirectory(kFALSE);
+
+#ifdef __USE_OPENMP__
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+  for (int i = 0; i < ngroups; i++) {
+    if (!parallel or !fSubInputSafe[i]) continue;
+    ReconfigureSubInput(i, fast);
+  }
+
+  TH1::AddDirectory(adddir);
+  for (int i = 0; i < ngroups; i++) {
+    if (parallel and fSubInputSafe[i]) continue;
+    ReconfigureSubInput(i, fast);
+  }
 }
 
 //********************************************************************
@@ -1652,6 +1832,7 @@ void JointMeas1D::ConvertEventRates() {
          fSubChain.begin();
        expIter != fSubChain.end(); expIter++) {
     MeasurementBase* exp = static_cast<MeasurementBase*>(*expIter);
+    exp->FlushHistograms();
     exp->ScaleEvents();
   }
 
@@ -1679,7 +1860,7 @@ void JointMeas1D::MakePlots() {
       MeasurementBase* exp = static_cast<MeasurementBase*>(*expIter);
 
       this->fMCHist->Add(exp->GetMCList().at(0));
-      this->fMCFine->Add(exp->GetFineList().at(0));
+      if (!fFitPhase) this->fMCFine->Add(exp->GetFineList().at(0));
     }
 
     return;
@@ -1695,11 +1876,11 @@ void JointMeas1D::MakePlots() {
 
       if (sample == 0) {
         this->fMCHist->Add(exp->GetMCList().at(0));
-        this->fMCFine->Add(exp->GetFineList().at(0));
+        if (!fFitPhase) this->fMCFine->Add(exp->GetFineList().at(0));
 
       } else if (sample == 1) {
         this->fMCHist->Divide(exp->GetMCList().at(0));
-        this->fMCFine->Divide(exp->GetFineList().at(0));
+        if (!fFitPhase) this->fMCFine->Divide(exp->GetFineList().at(0));
 
       } else {
         break;
@@ -1969,6 +2150,18 @@ std::vector<MeasurementBase*> JointMeas1D::GetSubSamples() {
   return exps;
 }
 
+//********************************************************************
+void JointMeas1D::SetFitPhase(bool fitphase) {
+//********************************************************************
+
+  fFitPhase = fitphase and fFitPhaseSafe;
+  for (std::vector<MeasurementBase*>::const_iterator expIter =
+         fSubChain.begin();
+       expIter != fSubChain.end(); expIter++) {
+    (*expIter)->SetFitPhase(fitphase);
+  }
+}
+
 
 
 
@@ -2093,6 +2286,7 @@ void JointMeas1D::SetCovarMatrix(std::string covarFile) {
 
   TDecompSVD LU = TDecompSVD(*this->covar);
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   return;
 };
@@ -2157,6 +2351,7 @@ void JointMeas1D::SetCovarMatrixFromText(std::string covarFile, int dim,
   // Now need to multiply by the scaling factor
   // If the covariance
   (*this->covar) *= 1. / (scale);
+  fCovarGen++;
 
   return;
 };
@@ -2213,6 +2408,7 @@ void JointMeas1D::SetCovarMatrixFromCorrText(std::string corrFile, int dim) {
   TDecompSVD LU = TDecompSVD(*this->covar);
   delete this->covar;
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   return;
 };
@@ -2255,6 +2451,7 @@ void JointMeas1D::SetCovarFromDataFile(std::string covarFile,
 
   TDecompSVD LU = TDecompSVD(*this->covar);
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   TDecompChol LUChol = TDecompChol(*fDecomp);
   LUChol.Decompose();
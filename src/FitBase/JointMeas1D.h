@@ -56,6 +56,10 @@
 #include "MeasurementBase.h"
 #include "PlotUtils.h"
 #include "StatUtils.h"
+#include "Chi2Evaluator.h"
+#include "MVNThrower.h"
+#include "CovarianceCache.h"
+#include "SmearingMatrix.h"
 
 
 //********************************************************************
@@ -416,6 +420,9 @@ public:
   /// so that the likelihood is calculated between data and thrown data
   virtual void ThrowDataToy(void);
 
+  /// \brief Setup fThrower for fFullCovar, reusing the cached decomposition
+  void SetupThrower(void);
+
   /*
     Access Functions
   */
@@ -563,6 +570,16 @@ virtual std::vector<TH1*> GetFineList(void);
   /// Call reconfigure on every sub sample
   virtual void Reconfigure();
 
+  /// Call the signal only reconfigure on every sub sample
+  virtual void ReconfigureFast();
+
+  /// \brief Reconfigure the sub samples, one pass per shared input
+  ///
+  /// Groups on different inputs run concurrently when parallel_subsamples is
+  /// set, every group is thread safe and the reweight engines allow it.
+  /// Sub samples in a group share each FitEvent and must not modify it.
+  void ReconfigureSubSamples(bool fast);
+
   /// Stitch the sub sample plots together to make a final fMCHist after
   /// reconfigure has been called
   virtual void MakePlots();
@@ -571,6 +588,9 @@ virtual std::vector<TH1*> GetFineList(void);
   virtual std::vector<MeasurementBase*> GetSubSamples();
   virtual void ConvertEventRates();
 
+  /// Set the fit phase on this sample and every sub sample
+  virtual void SetFitPhase(bool fitphase);
+
   /*
     Access Functions
   */
@@ -610,12 +630,39 @@ protected:
 
   TH1I* fMaskHist;   ///< Mask histogram for neglecting specific bins
   TMatrixD* fSmearMatrix;   ///< Smearing matrix (note, this is not symmetric)
+  SmearingMatrix fSmearCSR; ///< Sparse copy of fSmearMatrix used to apply it
 
   TrueModeStack* fMCHist_Modes; ///< Optional True Mode Stack
 
+  /// \brief Compute the flux unfolding factors for fMCHist and fMCFine
+  void SetupFluxUnfolding(void);
+
+  std::vector<double> fStatRatio;      ///< Per bin MC stat error / content
+  std::vector<double> fStatRatioFine;  ///< Per bin fine MC stat error / content
+  std::vector<double> fFluxUnfoldFactors;     ///< fMCHist flux unfolding factors
+  std::vector<double> fFluxUnfoldFineFactors; ///< fMCFine flux unfolding factors
+  double fFluxUnfoldScale; ///< fScaleFactor the unfolding factors were built with
+
+  /// \brief Group fSubChain by shared input handler
+  void SetupSubInputs(void);
+
+  /// \brief Whether ReconfigureSubSamples can run groups concurrently
+  bool UseParallelSubSamples(void);
+
+  /// \brief Reconfigure every sub sample in one input group
+  void ReconfigureSubInput(size_t group, bool fast);
+
+  std::vector<std::vector<MeasurementBase*> > fSubInputGroups; ///< fSubChain grouped by input
+  std::vector<bool> fSubInputSafe; ///< Group can be reconfigured concurrently
+  bool fParallelSubSamples;        ///< Config parallel_subsamples
+
 
   // Statistical
   TMatrixDSym* covar;       ///< Inverted Covariance
+  int fCovarGen;            ///< Bumped whenever covar, fFullCovar or fMaskHist change
+  Chi2Evaluator fChi2Eval; ///< Cached chi2 setup for covar and fMaskHist
+  MVNThrower fThrower;     ///< Cached decomposition of fFullCovar for toys
+  CovarianceCache fCovarCache; ///< Full, inverted and masked forms of fFullCovar
   TMatrixDSym* fFullCovar;  ///< Full Covariance
   TMatrixDSym* fDecomp;     ///< Decomposed Covariance
   TMatrixDSym* fCorrel;     ///< Correlation Matrix
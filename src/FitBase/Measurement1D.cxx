@@ -23,6 +23,9 @@
 Measurement1D::Measurement1D(void) {
 //********************************************************************
 
+  // Chi2 setups take masked forms of covar from the sample cache
+  fChi2Eval.SetCovarianceCache(&fCovarCache);
+
   // XSec Scalings
   fScaleFactor = -1.0;
   fCurrentNorm = 1.0;
@@ -39,6 +42,7 @@ Measurement1D::Measurement1D(void) {
 
   // Covar
   covar = NULL;
+  fCovarGen = 0;
   fFullCovar = NULL;
   fShapeCovar = NULL;
 
@@ -75,6 +79,13 @@ Measurement1D::Measurement1D(void) {
   // Extra Histograms
   fMCHist_Modes = NULL;
 
+  // Fill accumulators are setup at the first fill
+  fMCFillModes = NULL;
+  fFluxUnfoldScale = 0.0;
+  fMCStatSlot = -1;
+  fMCModeSlot = -1;
+  fMCNModes = 0;
+
 }
 
 //********************************************************************
@@ -226,6 +237,7 @@ void Measurement1D::SetCovarFromDiagonal(TH1D* data) {
     fFullCovar = StatUtils::MakeDiagonalCovarMatrix(data);
     covar      = StatUtils::GetInvert(fFullCovar);
     fDecomp    = StatUtils::GetDecomp(fFullCovar);
+    fCovarGen++;
   } else {
     ERR(FTL) << "No data input provided to set diagonal covar from!" << std::endl;
 
@@ -251,6 +263,7 @@ void Measurement1D::SetCovarFromTextFile(std::string covfile, int dim) {
   fFullCovar = StatUtils::GetCovarFromTextFile(covfile, dim);
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -274,6 +287,7 @@ void Measurement1D::SetCovarFromMultipleTextFiles(std::string covfiles, int dim)
   }
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -286,6 +300,7 @@ void Measurement1D::SetCovarFromRootFile(std::string covfile, std::string histna
   fFullCovar = StatUtils::GetCovarFromRootFile(covfile, histname);
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -301,6 +316,7 @@ void Measurement1D::SetCovarInvertFromTextFile(std::string covfile, int dim) {
   covar       = StatUtils::GetCovarFromTextFile(covfile, dim);
   fFullCovar  = StatUtils::GetInvert(covar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -312,6 +328,7 @@ void Measurement1D::SetCovarInvertFromRootFile(std::string covfile, std::string
   covar      = StatUtils::GetCovarFromRootFile(covfile, histname);
   fFullCovar = StatUtils::GetInvert(covar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -340,6 +357,7 @@ void Measurement1D::SetCorrelationFromTextFile(std::string covfile, int dim) {
   // Fill other covars.
   covar   = StatUtils::GetInvert(fFullCovar);
   fDecomp = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete correlation;
 }
@@ -370,6 +388,7 @@ void Measurement1D::SetCorrelationFromMultipleTextFiles(std::string corrfiles, i
   }
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -398,6 +417,7 @@ void Measurement1D::SetCorrelationFromRootFile(std::string covfile, std::string
   // Fill other covars.
   covar   = StatUtils::GetInvert(fFullCovar);
   fDecomp = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete correlation;
 }
@@ -421,6 +441,7 @@ void Measurement1D::SetCholDecompFromTextFile(std::string covfile, int dim) {
   fFullCovar  = new TMatrixDSym(dim, trans->GetMatrixArray(), "");
   covar       = StatUtils::GetInvert(fFullCovar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete temp;
   delete trans;
@@ -441,6 +462,7 @@ void Measurement1D::SetCholDecompFromRootFile(std::string covfile, std::string h
   fFullCovar  = new TMatrixDSym(temp->GetNrows(), trans->GetMatrixArray(), "");
   covar       = StatUtils::GetInvert(fFullCovar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete temp;
   delete trans;
@@ -479,9 +501,15 @@ void Measurement1D::ScaleDataErrors(double scale) {
 //********************************************************************
 void Measurement1D::ScaleCovar(double scale) {
 //********************************************************************
+  bool cached = fCovarCache.IsSetup(fCovarGen);
+  if (cached) fCovarCache.Scale(scale);
   (*fFullCovar) *= scale;
   (*covar) *= 1.0 / scale;
   (*fDecomp) *= sqrt(scale);
+
+  // The cache was rescaled in step, only the chi2 setup is stale
+  fCovarGen++;
+  if (cached) fCovarCache.SetGeneration(fCovarGen);
 }
 
 
@@ -497,6 +525,7 @@ void Measurement1D::SetBinMask(std::string maskfile) {
   fMaskHist =
     new TH1I((fSettings.GetName() + "_BINMASK").c_str(),
              (fSettings.GetName() + "_BINMASK; Bin; Mask?").c_str(), nbins, 0, nbins);
+  fCovarGen++;
   std::string line;
   std::ifstream mask(maskfile.c_str(), ifstream::in);
 
@@ -565,14 +594,25 @@ void Measurement1D::FinaliseMeasurement() {
   // Comment this out until the covariance/data scaling is consistent!
   StatUtils::SetDataErrorFromCov(fDataHist, fFullCovar, 1E-38);
 
-  // If shape only, set covar and fDecomp using the shape-only matrix (if set)
-  if (fIsShape && fShapeCovar and FitPar::Config().GetParB("UseShapeCovar")){
+  // If shape only, set covar using the shape-only matrix (if set).
+  // fDecomp stays the decomposition of fFullCovar already made above.
+  bool shapeswap = (fIsShape and fShapeCovar and
+                    FitPar::Config().GetSnapshot().UseShapeCovar);
+  if (shapeswap) {
     if (covar) delete covar;
     covar = StatUtils::GetInvert(fShapeCovar);
-    if (fDecomp) delete fDecomp;
-    fDecomp = StatUtils::GetDecomp(fFullCovar);
   }
 
+  // Keep the full forms so later masking, rescaling and throws reuse them.
+  // Seeded after the shape swap, as covar is then no longer the inverse of
+  // fFullCovar and the cache builds its own. Samples may also have set
+  // their matrices directly before finalising.
+  fCovarGen++;
+  fCovarCache.Setup(fCovarGen, fFullCovar, shapeswap ? NULL : covar, fDecomp);
+
+  // The chi2 must then mask the shape-only covar, not the cached full forms
+  fChi2Eval.SetCovarianceCache(shapeswap ? NULL : &fCovarCache);
+
   // Setup fMCHist from data
   fMCHist = (TH1D*)fDataHist->Clone();
   fMCHist->SetNameTitle((fSettings.GetName() + "_MC").c_str(),
@@ -735,6 +775,12 @@ void Measurement1D::SetFitOptions(std::string opt) {
   if (opt.find("NORM") != std::string::npos) fAddNormPen = true;
   if (opt.find("MASK") != std::string::npos) fIsMask = true;
 
+  // Closed form norm for FREE Gaussian/Poisson chi2s, the penalty term
+  // and MC errors in the covariance would need an iterative solution.
+  fProfileNorm = (fIsFree and !fAddNormPen and
+                  FitPar::Config().GetParB("profile_sample_norms") and
+                  (fIsDiag or fIsRawEvents or !FitPar::Config().GetSnapshot().addmcerror));
+
   return;
 };
 
@@ -775,6 +821,11 @@ void Measurement1D::SetSmearingMatrix(std::string smearfile, int truedim,
     }
     row++;
   }
+
+  // Mostly band diagonal, so apply it from a sparse copy
+  fSmearCSR.Setup(fSmearMatrix);
+  LOG(SAM) << "Smearing matrix has " << fSmearCSR.GetNNonZero() << "/"
+           << truedim * recodim << " non-zero elements" << std::endl;
   return;
 }
 
@@ -789,24 +840,11 @@ void Measurement1D::ApplySmearingMatrix() {
     return;
   }
 
-  TH1D* unsmeared = (TH1D*)fMCHist->Clone();
-  TH1D* smeared = (TH1D*)fMCHist->Clone();
-  smeared->Reset();
+  if (!fSmearCSR.IsSetup()) fSmearCSR.Setup(fSmearMatrix);
 
-  // Loop over reconstructed bins
+  // Each reco bin sums the contributions from all true bins
   // true = row; reco = column
-  for (int rbin = 0; rbin < fSmearMatrix->GetNcols(); ++rbin) {
-    // Sum up the constributions from all true bins
-    double rBinVal = 0;
-
-    // Loop over true bins
-    for (int tbin = 0; tbin < fSmearMatrix->GetNrows(); ++tbin) {
-      rBinVal +=
-        (*fSmearMatrix)(tbin, rbin) * unsmeared->GetBinContent(tbin + 1);
-    }
-    smeared->SetBinContent(rbin + 1, rBinVal);
-  }
-  fMCHist = (TH1D*)smeared->Clone();
+  fSmearCSR.Apply(fMCHist);
 
   return;
 }
@@ -819,8 +857,14 @@ void Measurement1D::ResetAll() {
 //********************************************************************
 
   fMCHist->Reset();
-  fMCFine->Reset();
   fMCStat->Reset();
+  fMCFill.Reset();
+
+  // Display only histograms are left as they are during a fit
+  if (fFitPhase) return;
+
+  fMCFine->Reset();
+  fMCFineFill.Reset();
 
   return;
 };
@@ -831,20 +875,82 @@ void Measurement1D::FillHistograms() {
 
   if (Signal) {
 
-    fMCHist->Fill(fXVar, Weight);
-    fMCFine->Fill(fXVar, Weight);
-    fMCStat->Fill(fXVar, 1.0);
+    if (fMCFill.GetHist() != fMCHist or fMCFineFill.GetHist() != fMCFine or
+        fMCFillModes != fMCHist_Modes) {
+      SetupFillCache();
+    }
+
+    // One bin lookup serves fMCHist, fMCStat and the mode stack
+    int bin = fMCFill.FindBin(fXVar);
+    fMCFill.FillBin(0, bin, fXVar, Weight);
+    fMCFill.FillBin(fMCStatSlot, bin, fXVar, 1.0);
 
-    if (fMCHist_Modes) fMCHist_Modes->Fill(Mode, fXVar, Weight);
+    if (fFitPhase) return;
+    fMCFineFill.Fill(0, fXVar, Weight);
+
+    if (fMCHist_Modes) {
+      int index = fMCHist_Modes->ConvertModeToIndex(Mode);
+      if (index >= 0 and index < fMCNModes) {
+        fMCFill.FillBin(fMCModeSlot + index, bin, fXVar, Weight);
+      } else {
+        fMCHist_Modes->Fill(Mode, fXVar, Weight);
+      }
+    }
   }
 
   return;
 };
 
+//********************************************************************
+void Measurement1D::SetupFillCache() {
+//********************************************************************
+
+  // Pending fills belong to the histograms they were made for
+  FlushHistograms();
+
+  fMCFill.Setup(fMCHist);
+  fMCStatSlot = fMCFill.Add(fMCStat);
+  fMCFineFill.Setup(fMCFine);
+
+  fMCFillModes = fMCHist_Modes;
+  fMCModeSlot = -1;
+  fMCNModes = 0;
+  if (fMCHist_Modes) {
+    fMCModeSlot = fMCFill.GetNSlots();
+    fMCNModes = fMCHist_Modes->fAllLabels.size();
+    for (int i = 0; i < fMCNModes; i++) fMCFill.Add(fMCHist_Modes->GetHist(i));
+  }
+}
+
+//********************************************************************
+void Measurement1D::FlushHistograms() {
+//********************************************************************
+  fMCFill.Flush();
+  fMCFineFill.Flush();
+}
+
+//********************************************************************
+void Measurement1D::SetupFluxUnfolding() {
+//********************************************************************
+
+  fFluxUnfoldScale = fScaleFactor;
+  fFluxUnfoldFactors = PlotUtils::GetFluxUnfoldedFactors(
+      fMCHist, GetFluxHistogram(), GetEventHistogram(), fScaleFactor);
+
+  fFluxUnfoldFineFactors.clear();
+  if (fMCFine) {
+    fFluxUnfoldFineFactors = PlotUtils::GetFluxUnfoldedFactors(
+        fMCFine, GetFluxHistogram(), GetEventHistogram(), fScaleFactor);
+  }
+}
+
 //********************************************************************
 void Measurement1D::ScaleEvents() {
 //********************************************************************
 
+  // Samples calling ScaleEvents directly skip ConvertEventRates
+  FlushHistograms();
+
   // Fill MCWeighted;
   // for (int i = 0; i < fMCHist->GetNbinsX(); i++) {
   //   fMCWeighted->SetBinContent(i + 1, fMCHist->GetBinContent(i + 1));
@@ -853,21 +959,27 @@ void Measurement1D::ScaleEvents() {
 
 
   // Setup Stat ratios for MC and MC Fine
-  double* statratio     = new double[fMCHist->GetNbinsX()];
+  fStatRatio.resize(fMCHist->GetNbinsX());
   for (int i = 0; i < fMCHist->GetNbinsX(); i++) {
     if (fMCHist->GetBinContent(i + 1) != 0) {
-      statratio[i] = fMCHist->GetBinError(i + 1) / fMCHist->GetBinContent(i + 1);
+      fStatRatio[i] = fMCHist->GetBinError(i + 1) / fMCHist->GetBinContent(i + 1);
     } else {
-      statratio[i] = 0.0;
+      fStatRatio[i] = 0.0;
     }
   }
 
-  double* statratiofine = new double[fMCFine->GetNbinsX()];
-  for (int i = 0; i < fMCFine->GetNbinsX(); i++) {
-    if (fMCFine->GetBinContent(i + 1) != 0) {
-      statratiofine[i] = fMCFine->GetBinError(i + 1) / fMCFine->GetBinContent(i + 1);
-    } else {
-      statratiofine[i] = 0.0;
+  // Display only histograms are left unscaled during a fit
+  TH1D* fine = fFitPhase ? NULL : fMCFine;
+  TrueModeStack* modes = fFitPhase ? NULL : fMCHist_Modes;
+
+  if (fine) {
+    fStatRatioFine.resize(fine->GetNbinsX());
+    for (int i = 0; i < fine->GetNbinsX(); i++) {
+      if (fine->GetBinContent(i + 1) != 0) {
+        fStatRatioFine[i] = fine->GetBinError(i + 1) / fine->GetBinContent(i + 1);
+      } else {
+        fStatRatioFine[i] = 0.0;
+      }
     }
   }
 
@@ -877,19 +989,21 @@ void Measurement1D::ScaleEvents() {
     double datamcratio = fDataHist->Integral() / fMCHist->Integral();
 
     fMCHist->Scale(datamcratio);
-    fMCFine->Scale(datamcratio);
+    if (fine) fine->Scale(datamcratio);
 
-    if (fMCHist_Modes) fMCHist_Modes->Scale(datamcratio);
+    if (modes) modes->Scale(datamcratio);
 
     // Scaling for XSec as function of Enu
   } else if (fIsEnu1D) {
 
-    PlotUtils::FluxUnfoldedScaling(fMCHist, GetFluxHistogram(),
-                                   GetEventHistogram(), fScaleFactor,
-                                   fNEvents);
-    PlotUtils::FluxUnfoldedScaling(fMCFine, GetFluxHistogram(),
-                                   GetEventHistogram(), fScaleFactor,
-                                   fNEvents);
+    // Unfolding factors only depend on the binning and flux
+    if (fFluxUnfoldFactors.size() != (size_t)fMCHist->GetSize() or
+        fFluxUnfoldScale != fScaleFactor) {
+      SetupFluxUnfolding();
+    }
+
+    PlotUtils::ScaleByBinFactors(fMCHist, fFluxUnfoldFactors);
+    if (fine) PlotUtils::ScaleByBinFactors(fine, fFluxUnfoldFineFactors);
 
 
     // if (fMCHist_Modes) {
@@ -900,31 +1014,27 @@ void Measurement1D::ScaleEvents() {
 
   } else if (fIsNoWidth) {
     fMCHist->Scale(fScaleFactor);
-    fMCFine->Scale(fScaleFactor);
-    if (fMCHist_Modes) fMCHist_Modes->Scale(fScaleFactor);
+    if (fine) fine->Scale(fScaleFactor);
+    if (modes) modes->Scale(fScaleFactor);
     // Any other differential scaling
   } else {
     fMCHist->Scale(fScaleFactor, "width");
-    fMCFine->Scale(fScaleFactor, "width");
+    if (fine) fine->Scale(fScaleFactor, "width");
 
-    if (fMCHist_Modes) fMCHist_Modes->Scale(fScaleFactor, "width");
+    if (modes) modes->Scale(fScaleFactor, "width");
   }
 
 
   // Proper error scaling - ROOT Freaks out with xsec weights sometimes
   for (int i = 0; i < fMCStat->GetNbinsX(); i++) {
-    fMCHist->SetBinError(i + 1, fMCHist->GetBinContent(i + 1) * statratio[i]);
+    fMCHist->SetBinError(i + 1, fMCHist->GetBinContent(i + 1) * fStatRatio[i]);
   }
 
-  for (int i = 0; i < fMCFine->GetNbinsX(); i++) {
-    fMCFine->SetBinError(i + 1, fMCFine->GetBinContent(i + 1) * statratiofine[i]);
+  for (int i = 0; fine and i < fine->GetNbinsX(); i++) {
+    fine->SetBinError(i + 1, fine->GetBinContent(i + 1) * fStatRatioFine[i]);
   }
 
 
-  // Clean up
-  delete statratio;
-  delete statratiofine;
-
   return;
 };
 
@@ -935,7 +1045,7 @@ void Measurement1D::ApplyNormScale(double norm) {
   fCurrentNorm = norm;
 
   fMCHist->Scale(1.0 / norm);
-  fMCFine->Scale(1.0 / norm);
+  if (!fFitPhase) fMCFine->Scale(1.0 / norm);
 
   return;
 };
@@ -984,14 +1094,24 @@ double Measurement1D::GetLikelihood() {
   double stat = 0.;
   if (fIsChi2) {
 
-    if (fIsRawEvents) {
-      stat = StatUtils::GetChi2FromEventRate(fDataHist, fMCHist, fMaskHist);
-    } else if (fIsDiag) {
-      stat = StatUtils::GetChi2FromDiag(fDataHist, fMCHist, fMaskHist);
-    } else if (!fIsDiag and !fIsRawEvents) {
-      stat = StatUtils::GetChi2FromCov(fDataHist, fMCHist, covar, fMaskHist);
+    int type = Chi2Evaluator::kChi2Cov;
+    if (fIsRawEvents) type = Chi2Evaluator::kChi2EventRate;
+    else if (fIsDiag) type = Chi2Evaluator::kChi2Diag;
+
+    // Masking and covariance packing are only redone when they change
+    if (!fChi2Eval.IsSetup(type, fCovarGen)) {
+      fChi2Eval.Setup(type, fCovarGen, fDataHist, covar, fMaskHist);
     }
 
+    // Profiled norms scale the MC inside the evaluator, fMCHist keeps fCurrentNorm
+    double mcscale = 1.0;
+    if (fProfileNorm and fChi2Eval.CanProfile()) {
+      mcscale = fChi2Eval.ProfileScale(fDataHist, fMCHist);
+      if (mcscale <= 0.0) mcscale = 1.0;
+      fProfiledNorm = fCurrentNorm / mcscale;
+    }
+    stat = fChi2Eval.Eval(fDataHist, fMCHist, mcscale);
+
   }
 
   // Sort Penalty Terms
@@ -1013,6 +1133,146 @@ double Measurement1D::GetLikelihood() {
   return stat;
 }
 
+//********************************************************************
+bool Measurement1D::HasLikelihoodGradient() {
+//********************************************************************
+
+  // Events are binned through GetLikelihoodBin
+  if (!fSingleBinFill) return false;
+
+  // Raw event scaling uses the unmasked integral, which masking removes
+  if (fIsRawEvents and fIsMask and fMaskHist) return false;
+
+  // dL/dnorm is zero at a profiled norm but the MC derivative picks up the scale
+  if (fProfileNorm) return false;
+
+  // Only the chi2 depends on the MC
+  if (!fIsChi2) return false;
+
+  // The shape-only covariance is not included in the gradient
+  if (fIsShape and fShapeCovar and FitPar::Config().GetSnapshot().UseShapeCovar) {
+    return false;
+  }
+
+  return !FitPar::Config().GetSnapshot().addmcerror;
+}
+
+//********************************************************************
+int Measurement1D::GetLikelihoodBin(MeasurementVariableBox* box) {
+//********************************************************************
+  return fMCHist->FindBin(box->GetX());
+}
+
+//********************************************************************
+bool Measurement1D::SetLikelihoodBins(const double* sumw, const double* sumw2) {
+//********************************************************************
+
+  if (!fFitPhase or !fSingleBinFill) return false;
+
+  fMCFill.Reset();
+  fMCHist->Reset();
+  if (!fMCHist->GetSumw2N()) fMCHist->Sumw2();
+
+  int ncells = fMCHist->GetSize();
+  double* val = fMCHist->GetArray();
+  double* err = fMCHist->GetSumw2()->GetArray();
+  for (int i = 0; i < ncells; i++) {
+    val[i] = sumw[i];
+    err[i] = sumw2[i];
+  }
+
+  // One entry per signal fill, as FillHistograms would have counted
+  fMCHist->SetEntries(fMCStat->GetEntries());
+  return true;
+}
+
+//********************************************************************
+void Measurement1D::GetLikelihoodGradient(std::vector<double>& dldlnmc,
+                                          double& dldnorm) {
+//********************************************************************
+
+  int nbins = fMCHist->GetNbinsX();
+  dldlnmc.assign(nbins + 2, 0.0);
+  dldnorm = 0.0;
+
+  if (fNoData || !fDataHist) return;
+
+  // Same masking and shape scaling as GetLikelihood
+  if (fIsMask and fMaskHist) {
+    PlotUtils::MaskBins(fMCHist, fMaskHist);
+  }
+
+  double scaleF = 0.0;
+  if (fIsShape) {
+    if (fMCHist->Integral(1, nbins, "width")) {
+      scaleF = fDataHist->Integral(1, fDataHist->GetNbinsX(), "width") /
+        fMCHist->Integral(1, nbins, "width");
+      fMCHist->Scale(scaleF);
+    }
+  }
+
+  if (fIsChi2) {
+    if (fIsRawEvents) {
+      StatUtils::GetChi2GradientFromEventRate(fDataHist, fMCHist, fMaskHist, dldlnmc);
+    } else if (fIsDiag) {
+      StatUtils::GetChi2GradientFromDiag(fDataHist, fMCHist, fMaskHist, dldlnmc);
+    } else {
+      StatUtils::GetChi2GradientFromCov(fDataHist, fMCHist, covar, fMaskHist, dldlnmc);
+    }
+  }
+
+  // Shape scaled MC is s * mc with s = data / integral(mc), chain through s
+  if (fIsShape and scaleF) {
+    double gm = 0.0;
+    double mw = 0.0;
+    for (int i = 1; i <= nbins; i++) {
+      gm += dldlnmc[i] * fMCHist->GetBinContent(i);
+      mw += fMCHist->GetBinContent(i) * fMCHist->GetBinWidth(i);
+    }
+    for (int i = 1; i <= nbins; i++) {
+      dldlnmc[i] = scaleF * (dldlnmc[i] - fMCHist->GetBinWidth(i) * gm / mw);
+    }
+    fMCHist->Scale(1. / scaleF);
+  }
+
+  // Masked bins are forced to zero so carry no derivative
+  if (fIsMask and fMaskHist) {
+    for (int i = 1; i <= nbins; i++) {
+      if (fMaskHist->GetBinContent(i)) dldlnmc[i] = 0.0;
+    }
+  }
+
+  // Raw event rates are scaled to the data integral in ScaleEvents,
+  // chain through that normalisation as well
+  if (fIsRawEvents) {
+    double gm = 0.0;
+    double mcint = 0.0;
+    for (int i = 1; i <= nbins; i++) {
+      gm += dldlnmc[i] * fMCHist->GetBinContent(i);
+      mcint += fMCHist->GetBinContent(i);
+    }
+    if (mcint != 0.0) {
+      for (int i = 1; i <= nbins; i++) dldlnmc[i] -= gm / mcint;
+    }
+  }
+
+  // MC scales as 1/norm after ConvertEventRates. Taken after the raw
+  // projection, so the norm drops out of raw event rate samples.
+  if (fCurrentNorm != 0.0) {
+    for (int i = 1; i <= nbins; i++) {
+      dldnorm -= dldlnmc[i] * fMCHist->GetBinContent(i) / fCurrentNorm;
+    }
+  }
+  if (fAddNormPen) {
+    dldnorm -= 2. * (1. - fCurrentNorm) / (fNormError * fNormError);
+  }
+
+  // Return per relative change of the MC
+  for (int i = 1; i <= nbins; i++) {
+    dldlnmc[i] *= fMCHist->GetBinContent(i);
+  }
+}
+
 
 /*
   Fake Data Functions
@@ -1063,24 +1323,32 @@ void Measurement1D::SetFakeDataValues(std::string fakeOption) {
 
   // Make a new covariance for fake data hist.
   int nbins = fDataHist->GetNbinsX();
-  double alpha_i = 0.0;
-  double alpha_j = 0.0;
+  std::vector<double> alpha(nbins, 0.0);
+  for (int i = 0; i < nbins; i++) {
+    alpha[i] = fDataHist->GetBinContent(i + 1) / tempdata->GetBinContent(i + 1);
+  }
 
   for (int i = 0; i < nbins; i++) {
     for (int j = 0; j < nbins; j++) {
-      alpha_i = fDataHist->GetBinContent(i + 1) / tempdata->GetBinContent(i + 1);
-      alpha_j = fDataHist->GetBinContent(j + 1) / tempdata->GetBinContent(j + 1);
-
-      (*fFullCovar)(i, j) = alpha_i * alpha_j * (*fFullCovar)(i, j);
+      (*fFullCovar)(i, j) = alpha[i] * alpha[j] * (*fFullCovar)(i, j);
     }
   }
 
-  // Setup Covariances
+  // Setup Covariances, rescaling the cached forms rather than reinverting
   if (covar) delete covar;
-  covar   = StatUtils::GetInvert(fFullCovar);
-
   if (fDecomp) delete fDecomp;
-  fDecomp = StatUtils::GetInvert(fFullCovar);
+  if (fCovarCache.IsSetup(fCovarGen)) {
+    fCovarCache.ScaleBins(alpha);
+    covar   = (TMatrixDSym*) fCovarCache.GetInverse()->Clone();
+    fDecomp = (TMatrixDSym*) fCovarCache.GetDecomp()->Clone();
+  } else {
+    covar   = StatUtils::GetInvert(fFullCovar);
+    fDecomp = StatUtils::GetDecomp(fFullCovar);
+  }
+  fCovarGen++;
+  fCovarCache.Setup(fCovarGen, fFullCovar, covar, fDecomp);
+  fChi2Eval.Reset();
+  fThrower.Reset();
 
   delete tempdata;
 
@@ -1117,9 +1385,10 @@ void Measurement1D::ThrowCovariance() {
   // Take a fDecomposition and use it to throw the current dataset.
   // Requires fDataTrue also be set incase used repeatedly.
 
+  // Toys are thrown in batches and copied into fDataHist in place.
   if (!fDataTrue) fDataTrue = (TH1D*) fDataHist->Clone();
-  if (fDataHist) delete fDataHist;
-  fDataHist = StatUtils::ThrowHistogram(fDataTrue, fFullCovar);
+  if (!fThrower.IsSetup(fFullCovar)) SetupThrower();
+  fThrower.FillHistogram(fDataHist, fDataTrue, fThrower.NextToy());
 
   return;
 };
@@ -1129,8 +1398,23 @@ void Measurement1D::ThrowCovariance() {
 void Measurement1D::ThrowDataToy(){
 //********************************************************************
   if (!fDataTrue) fDataTrue = (TH1D*) fDataHist->Clone();
-  if (fMCHist) delete fMCHist;
-  fMCHist = StatUtils::ThrowHistogram(fDataTrue, fFullCovar);
+  if (!fThrower.IsSetup(fFullCovar)) SetupThrower();
+  fThrower.FillHistogram(fMCHist, fDataTrue, fThrower.NextToy());
+}
+
+//********************************************************************
+void Measurement1D::SetupThrower() {
+//********************************************************************
+
+  // Covariance rows are the bins of fDataTrue
+  std::vector<int> bins;
+  for (int i = 0; i < fDataTrue->GetNbinsX(); i++) bins.push_back(i + 1);
+
+  if (fCovarCache.IsSetup(fCovarGen)) {
+    fThrower.SetupDecomp(fFullCovar, fCovarCache.GetDecomp(), bins);
+  } else {
+    fThrower.Setup(fFullCovar, bins);
+  }
 }
 
 /*
@@ -1203,6 +1487,8 @@ TH1D* Measurement1D::GetDataHistogram() {
 void Measurement1D::Write(std::string drawOpt) {
 //********************************************************************
 
+  FlushHistograms();
+
   // Get Draw Options
   drawOpt = FitPar::Config().GetParS("drawopts");
 
@@ -1631,6 +1917,7 @@ void Measurement1D::SetCovarMatrix(std::string covarFile) {
 
   TDecompSVD LU = TDecompSVD(*this->covar);
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   return;
 };
@@ -1695,6 +1982,7 @@ void Measurement1D::SetCovarMatrixFromText(std::string covarFile, int dim,
   // Now need to multiply by the scaling factor
   // If the covariance
   (*this->covar) *= 1. / (scale);
+  fCovarGen++;
 
   return;
 };
@@ -1751,6 +2039,7 @@ void Measurement1D::SetCovarMatrixFromCorrText(std::string corrFile, int dim) {
   TDecompSVD LU = TDecompSVD(*this->covar);
   delete this->covar;
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   return;
 };
@@ -1793,6 +2082,7 @@ void Measurement1D::SetCovarFromDataFile(std::string covarFile,
 
   TDecompSVD LU = TDecompSVD(*this->covar);
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   TDecompChol LUChol = TDecompChol(*fDecomp);
   LUChol.Decompose();
@@ -55,6 +55,11 @@
 #include "MeasurementBase.h"
 #include "PlotUtils.h"
 #include "StatUtils.h"
+#include "Chi2Evaluator.h"
+#include "MVNThrower.h"
+#include "CovarianceCache.h"
+#include "SmearingMatrix.h"
+#include "HistAccumulator.h"
 
 #include "SignalDef.h"
 #include "MeasurementVariableBox.h"
@@ -358,6 +363,12 @@ public:
   /// even if they have been set to auto process.
   virtual void FillHistograms(void);
 
+  /// \brief Add the fills held in fMCFill and fMCFineFill to the MC histograms
+  ///
+  /// The standard histograms are filled through array accumulators during the
+  /// event loop. This is called before they are scaled or written.
+  virtual void FlushHistograms(void);
+
   // \brief Convert event rates to final histogram
   ///
   /// Apply standard scaling procedure to standard mc histograms to convert from
@@ -391,6 +402,30 @@ public:
   /// Diferent likelihoods definitions are used depending on the FitOptions.
   virtual double GetLikelihood(void);
 
+  /// \brief Analytic likelihood gradient is available
+  ///
+  /// False if the MC errors are added to the data errors, as the
+  /// likelihood then depends on the MC errors as well as the contents,
+  /// or for masked raw event rates.
+  virtual bool HasLikelihoodGradient(void);
+
+  /// \brief Derivative of GetLikelihood with respect to the MC prediction
+  ///
+  /// Returned as MC * dL/dMC per bin. Shape and raw event rate scalings are
+  /// functions of the MC itself and are folded in, so it can be chained with
+  /// the per bin filled weights.
+  virtual void GetLikelihoodGradient(std::vector<double>& dldlnmc, double& dldnorm);
+
+  /// \brief MC histogram bin filled by a signal event box
+  virtual int GetLikelihoodBin(MeasurementVariableBox* box);
+
+  /// \brief Set fMCHist from per bin signal weight sums
+  ///
+  /// Only valid in the fit phase, where FillHistograms fills fMCHist and
+  /// fMCStat alone. fMCStat does not depend on the weights and is kept.
+  /// Requires fSingleBinFill.
+  virtual bool SetLikelihoodBins(const double* sumw, const double* sumw2);
+
 
   /*
     Fake Data
@@ -431,6 +466,9 @@ public:
   /// so that the likelihood is calculated between data and thrown data
   virtual void ThrowDataToy(void);
 
+  /// \brief Setup fThrower for fFullCovar, reusing the cached decomposition
+  void SetupThrower(void);
+
 
   /*
     Access Functions
@@ -592,12 +630,36 @@ protected:
 
   TH1I* fMaskHist;   ///< Mask histogram for neglecting specific bins
   TMatrixD* fSmearMatrix;   ///< Smearing matrix (note, this is not symmetric)
+  SmearingMatrix fSmearCSR; ///< Sparse copy of fSmearMatrix used to apply it
 
   TrueModeStack* fMCHist_Modes; ///< Optional True Mode Stack
 
+  /// \brief Point the fill accumulators at the current MC histograms
+  void SetupFillCache(void);
+
+  HistAccumulator fMCFill;      ///< Pending fills of fMCHist, fMCStat and fMCHist_Modes
+  HistAccumulator fMCFineFill;  ///< Pending fills of fMCFine
+  TrueModeStack* fMCFillModes;  ///< Mode stack fMCFill was setup with
+  int fMCStatSlot;              ///< fMCFill slot of fMCStat
+  int fMCModeSlot;              ///< fMCFill slot of the first mode, -1 if none
+  int fMCNModes;                ///< Number of mode slots
+
+  /// \brief Compute the flux unfolding factors for fMCHist and fMCFine
+  void SetupFluxUnfolding(void);
+
+  std::vector<double> fStatRatio;      ///< Per bin MC stat error / content
+  std::vector<double> fStatRatioFine;  ///< Per bin fine MC stat error / content
+  std::vector<double> fFluxUnfoldFactors;     ///< fMCHist flux unfolding factors
+  std::vector<double> fFluxUnfoldFineFactors; ///< fMCFine flux unfolding factors
+  double fFluxUnfoldScale; ///< fScaleFactor the unfolding factors were built with
+
 
   // Statistical
   TMatrixDSym* covar;       ///< Inverted Covariance
+  int fCovarGen;            ///< Bumped whenever covar, fFullCovar or fMaskHist change
+  Chi2Evaluator fChi2Eval; ///< Cached chi2 setup for covar and fMaskHist
+  MVNThrower fThrower;     ///< Cached decomposition of fFullCovar for toys
+  CovarianceCache fCovarCache; ///< Full, inverted and masked forms of fFullCovar
   TMatrixDSym* fFullCovar;  ///< Full Covariance
   TMatrixDSym* fDecomp;     ///< Decomposed Covariance
   TMatrixDSym* fCorrel;     ///< Correlation Matrix
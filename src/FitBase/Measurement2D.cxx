@@ -25,7 +25,11 @@
 Measurement2D::Measurement2D(void) {
 //********************************************************************
 
+  // Chi2 setups take masked forms of covar from the sample cache
+  fChi2Eval.SetCovarianceCache(&fCovarCache);
+
   covar = NULL;
+  fCovarGen = 0;
   fDecomp = NULL;
   fFullCovar = NULL;
 
@@ -115,6 +119,13 @@ Measurement2D::Measurement2D(void) {
   // Extra Histograms
   fMCHist_Modes = NULL;
 
+  // Fill accumulators are setup at the first fill
+  fMCFillModes = NULL;
+  fFluxUnfoldScale = 0.0;
+  fMCStatSlot = -1;
+  fMCModeSlot = -1;
+  fMCNModes = 0;
+
 }
 
 //********************************************************************
@@ -268,9 +279,11 @@ void Measurement2D::SetMapValuesFromText(std::string dataFile) {
 
   fMapHist = new TH2I((fName + "_map").c_str(), (fName + fPlotTitles).c_str(),
                       edgex.size() - 1, &edgex[0], edgey.size() - 1, &edgey[0]);
+  fCovarGen++;
 
   LOG(SAM) << "Reading map from: " << dataFile << std::endl;
   PlotUtils::Set2DHistFromText(dataFile, fMapHist, 1.0);
+  fMapBins.clear();
 
 }
 
@@ -302,6 +315,7 @@ void Measurement2D::SetCovarFromDiagonal(TH2D* data) {
     fFullCovar = StatUtils::MakeDiagonalCovarMatrix(data);
     covar      = StatUtils::GetInvert(fFullCovar);
     fDecomp    = StatUtils::GetDecomp(fFullCovar);
+    fCovarGen++;
   } else {
     ERR(FTL) << "No data input provided to set diagonal covar from!" << std::endl;
 
@@ -327,6 +341,7 @@ void Measurement2D::SetCovarFromTextFile(std::string covfile, int dim) {
   fFullCovar = StatUtils::GetCovarFromTextFile(covfile, dim);
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -338,6 +353,7 @@ void Measurement2D::SetCovarFromRootFile(std::string covfile, std::string histna
   fFullCovar = StatUtils::GetCovarFromRootFile(covfile, histname);
   covar      = StatUtils::GetInvert(fFullCovar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -353,6 +369,7 @@ void Measurement2D::SetCovarInvertFromTextFile(std::string covfile, int dim) {
   covar       = StatUtils::GetCovarFromTextFile(covfile, dim);
   fFullCovar  = StatUtils::GetInvert(covar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -364,6 +381,7 @@ void Measurement2D::SetCovarInvertFromRootFile(std::string covfile, std::string
   covar      = StatUtils::GetCovarFromRootFile(covfile, histname);
   fFullCovar = StatUtils::GetInvert(covar);
   fDecomp    = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
 }
 
@@ -392,6 +410,7 @@ void Measurement2D::SetCorrelationFromTextFile(std::string covfile, int dim) {
   // Fill other covars.
   covar   = StatUtils::GetInvert(fFullCovar);
   fDecomp = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete correlation;
 }
@@ -420,6 +439,7 @@ void Measurement2D::SetCorrelationFromRootFile(std::string covfile, std::string
   // Fill other covars.
   covar   = StatUtils::GetInvert(fFullCovar);
   fDecomp = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete correlation;
 }
@@ -443,6 +463,7 @@ void Measurement2D::SetCholDecompFromTextFile(std::string covfile, int dim) {
   fFullCovar  = new TMatrixDSym(dim, trans->GetMatrixArray(), "");
   covar       = StatUtils::GetInvert(fFullCovar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete temp;
   delete trans;
@@ -463,6 +484,7 @@ void Measurement2D::SetCholDecompFromRootFile(std::string covfile, std::string h
   fFullCovar  = new TMatrixDSym(temp->GetNrows(), trans->GetMatrixArray(), "");
   covar       = StatUtils::GetInvert(fFullCovar);
   fDecomp     = StatUtils::GetDecomp(fFullCovar);
+  fCovarGen++;
 
   delete temp;
   delete trans;
@@ -491,9 +513,15 @@ void Measurement2D::ScaleDataErrors(double scale) {
 //********************************************************************
 void Measurement2D::ScaleCovar(double scale) {
 //********************************************************************
+  bool cached = fCovarCache.IsSetup(fCovarGen);
+  if (cached) fCovarCache.Scale(scale);
   (*fFullCovar) *= scale;
   (*covar) *= 1.0 / scale;
   (*fDecomp) *= sqrt(scale);
+
+  // The cache was rescaled in step, only the chi2 setup is stale
+  fCovarGen++;
+  if (cached) fCovarCache.SetGeneration(fCovarGen);
 }
 
 
@@ -510,6 +538,7 @@ void Measurement2D::SetBinMask(std::string maskfile) {
   fMaskHist =
     new TH2I((fSettings.GetName() + "_BINMASK").c_str(),
              (fSettings.GetName() + "_BINMASK; Bin; Mask?").c_str(), nbinsx, 0, nbinsx, nbinxy, 0, nbinxy);
+  fCovarGen++;
   std::string line;
   std::ifstream mask(maskfile.c_str(), ifstream::in);
 
@@ -573,6 +602,11 @@ void Measurement2D::FinaliseMeasurement() {
     fDecomp = StatUtils::GetDecomp(fFullCovar);
   }
 
+  // Keep the full forms so later masking, rescaling and throws reuse them
+  // Samples may have set their matrices directly before finalising
+  fCovarGen++;
+  fCovarCache.Setup(fCovarGen, fFullCovar, covar, fDecomp);
+
   // Setup fMCHist from data
   fMCHist = (TH2D*)fDataHist->Clone();
   fMCHist->SetNameTitle((fSettings.GetName() + "_MC").c_str(),
@@ -777,6 +811,11 @@ void Measurement2D::SetFitOptions(std::string opt) {
 
   fIsProjFitX = (opt.find("FITPROJX") != std::string::npos);
   fIsProjFitY = (opt.find("FITPROJY") != std::string::npos);
+  // Closed form norm for FREE Gaussian chi2s, the penalty term
+  // and MC errors in the covariance would need an iterative solution.
+  fProfileNorm = (fIsFree and !fAddNormPen and
+                  FitPar::Config().GetParB("profile_sample_norms") and
+                  (fIsDiag or !FitPar::Config().GetSnapshot().addmcerror));
 
   return;
 };
@@ -790,8 +829,14 @@ void Measurement2D::ResetAll() {
 //********************************************************************
 
   fMCHist->Reset();
-  fMCFine->Reset();
   fMCStat->Reset();
+  fMCFill.Reset();
+
+  // Display only histograms are left as they are during a fit
+  if (fFitPhase) return;
+
+  fMCFine->Reset();
+  fMCFineFill.Reset();
 
   return;
 };
@@ -801,20 +846,82 @@ void Measurement2D::FillHistograms() {
   //********************************************************************
 
   if (Signal) {
-    fMCHist->Fill(fXVar, fYVar, Weight);
-    fMCFine->Fill(fXVar, fYVar, Weight);
-    fMCStat->Fill(fXVar, fYVar, 1.0);
+    if (fMCFill.GetHist() != fMCHist or fMCFineFill.GetHist() != fMCFine or
+        fMCFillModes != fMCHist_Modes) {
+      SetupFillCache();
+    }
 
-    if (fMCHist_Modes) fMCHist_Modes->Fill(Mode, fXVar, fYVar, Weight);
+    // One bin lookup serves fMCHist, fMCStat and the mode stack
+    int bin = fMCFill.FindBin(fXVar, fYVar);
+    fMCFill.FillBin(0, bin, fXVar, fYVar, Weight);
+    fMCFill.FillBin(fMCStatSlot, bin, fXVar, fYVar, 1.0);
+
+    if (fFitPhase) return;
+    fMCFineFill.Fill(0, fXVar, fYVar, Weight);
+
+    if (fMCHist_Modes) {
+      int index = fMCHist_Modes->ConvertModeToIndex(Mode);
+      if (index >= 0 and index < fMCNModes) {
+        fMCFill.FillBin(fMCModeSlot + index, bin, fXVar, fYVar, Weight);
+      } else {
+        fMCHist_Modes->Fill(Mode, fXVar, fYVar, Weight);
+      }
+    }
   }
 
   return;
 };
 
+//********************************************************************
+void Measurement2D::SetupFillCache() {
+//********************************************************************
+
+  // Pending fills belong to the histograms they were made for
+  FlushHistograms();
+
+  fMCFill.Setup(fMCHist);
+  fMCStatSlot = fMCFill.Add(fMCStat);
+  fMCFineFill.Setup(fMCFine);
+
+  fMCFillModes = fMCHist_Modes;
+  fMCModeSlot = -1;
+  fMCNModes = 0;
+  if (fMCHist_Modes) {
+    fMCModeSlot = fMCFill.GetNSlots();
+    fMCNModes = fMCHist_Modes->fAllLabels.size();
+    for (int i = 0; i < fMCNModes; i++) fMCFill.Add(fMCHist_Modes->GetHist(i));
+  }
+}
+
+//********************************************************************
+void Measurement2D::FlushHistograms() {
+//********************************************************************
+  fMCFill.Flush();
+  fMCFineFill.Flush();
+}
+
+//********************************************************************
+void Measurement2D::SetupFluxUnfolding() {
+//********************************************************************
+
+  fFluxUnfoldScale = fScaleFactor;
+  fFluxUnfoldFactors = PlotUtils::GetFluxUnfoldedFactors(
+      fMCHist, GetFluxHistogram(), GetEventHistogram(), fScaleFactor);
+
+  fFluxUnfoldFineFactors.clear();
+  if (fMCFine) {
+    fFluxUnfoldFineFactors = PlotUtils::GetFluxUnfoldedFactors(
+        fMCFine, GetFluxHistogram(), GetEventHistogram(), fScaleFactor);
+  }
+}
+
 //********************************************************************
 void Measurement2D::ScaleEvents() {
 //********************************************************************
 
+  // Samples calling ScaleEvents directly skip ConvertEventRates
+  FlushHistograms();
+
   // Fill MCWeighted;
   // for (int i = 0; i < fMCHist->GetNbinsX(); i++) {
   // fMCWeighted->SetBinContent(i + 1, fMCHist->GetBinContent(i + 1));
@@ -823,21 +930,27 @@ void Measurement2D::ScaleEvents() {
 
 
   // Setup Stat ratios for MC and MC Fine
-  double* statratio     = new double[fMCHist->GetNbinsX()];
+  fStatRatio.resize(fMCHist->GetNbinsX());
   for (int i = 0; i < fMCHist->GetNbinsX(); i++) {
     if (fMCHist->GetBinContent(i + 1) != 0) {
-      statratio[i] = fMCHist->GetBinError(i + 1) / fMCHist->GetBinContent(i + 1);
+      fStatRatio[i] = fMCHist->GetBinError(i + 1) / fMCHist->GetBinContent(i + 1);
     } else {
-      statratio[i] = 0.0;
+      fStatRatio[i] = 0.0;
     }
   }
 
-  double* statratiofine = new double[fMCFine->GetNbinsX()];
-  for (int i = 0; i < fMCFine->GetNbinsX(); i++) {
-    if (fMCFine->GetBinContent(i + 1) != 0) {
-      statratiofine[i] = fMCFine->GetBinError(i + 1) / fMCFine->GetBinContent(i + 1);
-    } else {
-      statratiofine[i] = 0.0;
+  // Display only histograms are left unscaled during a fit
+  TH2D* fine = fFitPhase ? NULL : fMCFine;
+  TrueModeStack* modes = fFitPhase ? NULL : fMCHist_Modes;
+
+  if (fine) {
+    fStatRatioFine.resize(fine->GetNbinsX());
+    for (int i = 0; i < fine->GetNbinsX(); i++) {
+      if (fine->GetBinContent(i + 1) != 0) {
+        fStatRatioFine[i] = fine->GetBinError(i + 1) / fine->GetBinContent(i + 1);
+      } else {
+        fStatRatioFine[i] = 0.0;
+      }
     }
   }
 
@@ -847,18 +960,21 @@ void Measurement2D::ScaleEvents() {
     double datamcratio = fDataHist->Integral() / fMCHist->Integral();
 
     fMCHist->Scale(datamcratio);
-    fMCFine->Scale(datamcratio);
+    if (fine) fine->Scale(datamcratio);
 
-    if (fMCHist_Modes) fMCHist_Modes->Scale(datamcratio);
+    if (modes) modes->Scale(datamcratio);
 
     // Scaling for XSec as function of Enu
   } else if (fIsEnu1D) {
 
-    PlotUtils::FluxUnfoldedScaling(fMCHist, GetFluxHistogram(),
-                                   GetEventHistogram(), fScaleFactor);
+    // Unfolding factors only depend on the binning and flux
+    if (fFluxUnfoldFactors.size() != (size_t)fMCHist->GetSize() or
+        fFluxUnfoldScale != fScaleFactor) {
+      SetupFluxUnfolding();
+    }
 
-    PlotUtils::FluxUnfoldedScaling(fMCFine, GetFluxHistogram(),
-                                   GetEventHistogram(), fScaleFactor);
+    PlotUtils::ScaleByBinFactors(fMCHist, fFluxUnfoldFactors);
+    if (fine) PlotUtils::ScaleByBinFactors(fine, fFluxUnfoldFineFactors);
 
 
     // if (fMCHist_Modes) {
@@ -870,7 +986,7 @@ void Measurement2D::ScaleEvents() {
     // Any other differential scaling
   } else {
     fMCHist->Scale(fScaleFactor, "width");
-    fMCFine->Scale(fScaleFactor, "width");
+    if (fine) fine->Scale(fScaleFactor, "width");
 
     // if (fMCHist_Modes) fMCHist_Modes->Scale(fScaleFactor, "width");
   }
@@ -878,18 +994,14 @@ void Measurement2D::ScaleEvents() {
 
   // Proper error scaling - ROOT Freaks out with xsec weights sometimes
   for (int i = 0; i < fMCStat->GetNbinsX(); i++) {
-    fMCHist->SetBinError(i + 1, fMCHist->GetBinContent(i + 1) * statratio[i]);
+    fMCHist->SetBinError(i + 1, fMCHist->GetBinContent(i + 1) * fStatRatio[i]);
   }
 
-  for (int i = 0; i < fMCFine->GetNbinsX(); i++) {
-    fMCFine->SetBinError(i + 1, fMCFine->GetBinContent(i + 1) * statratiofine[i]);
+  for (int i = 0; fine and i < fine->GetNbinsX(); i++) {
+    fine->SetBinError(i + 1, fine->GetBinContent(i + 1) * fStatRatioFine[i]);
   }
 
 
-  // Clean up
-  delete statratio;
-  delete statratiofine;
-
   return;
 };
 
@@ -900,7 +1012,7 @@ void Measurement2D::ApplyNormScale(double norm) {
   fCurrentNorm = norm;
 
   fMCHist->Scale(1.0 / norm);
-  fMCFine->Scale(1.0 / norm);
+  if (!fFitPhase) fMCFine->Scale(1.0 / norm);
 
   return;
 };
@@ -957,6 +1069,7 @@ double Measurement2D::GetLikelihood() {
   if (!fIsMask) {
     if (fMaskHist) {
       fMaskHist = NULL;
+      fCovarGen++;
     }
   } else {
     if (fMaskHist) {
@@ -975,21 +1088,27 @@ double Measurement2D::GetLikelihood() {
     //PlotUtils::ScaleNeutModeArray((TH1**)fMCHist_PDG, scaleF);
   }
 
-  if (!fMapHist) {
-    fMapHist = StatUtils::GenerateMap(fDataHist);
-  }
+  SetupMapBins();
 
   // Get the chi2 from either covar or diagonals
   double chi2 = 0.0;
 
   if (fIsChi2) {
-    if (fIsDiag) {
-      chi2 =
-        StatUtils::GetChi2FromDiag(fDataHist, fMCHist, fMapHist, fMaskHist);
-    } else {
-      chi2 = StatUtils::GetChi2FromCov(fDataHist, fMCHist, covar, fMapHist,
-                                       fMaskHist);
+    int type = fIsDiag ? Chi2Evaluator::kChi2Diag : Chi2Evaluator::kChi2Cov;
+
+    // Map flattening, masking and covariance packing are cached
+    if (!fChi2Eval.IsSetup(type, fCovarGen)) {
+      fChi2Eval.Setup(type, fCovarGen, fDataHist, covar, fMapHist, fMaskHist);
+    }
+
+    // Profiled norms scale the MC inside the evaluator, fMCHist keeps fCurrentNorm
+    double mcscale = 1.0;
+    if (fProfileNorm and fChi2Eval.CanProfile()) {
+      mcscale = fChi2Eval.ProfileScale(fDataHist, fMCHist);
+      if (mcscale <= 0.0) mcscale = 1.0;
+      fProfiledNorm = fCurrentNorm / mcscale;
     }
+    chi2 = fChi2Eval.Eval(fDataHist, fMCHist, mcscale);
   }
 
   // Add a normal penalty term
@@ -1003,7 +1122,7 @@ double Measurement2D::GetLikelihood() {
   }
 
   // Adjust the shape back to where it was.
-  if (fIsShape and !FitPar::Config().GetParB("saveshapescaling")) {
+  if (fIsShape and !FitPar::Config().GetSnapshot().saveshapescaling) {
     fMCHist->Scale(1. / scaleF);
     fMCFine->Scale(1. / scaleF);
   }
@@ -1013,6 +1132,35 @@ double Measurement2D::GetLikelihood() {
   return chi2;
 }
 
+//********************************************************************
+int Measurement2D::GetLikelihoodBin(MeasurementVariableBox* box) {
+//********************************************************************
+  return fMCHist->FindBin(box->GetX(), box->GetY());
+}
+
+//********************************************************************
+bool Measurement2D::SetLikelihoodBins(const double* sumw, const double* sumw2) {
+//********************************************************************
+
+  if (!fFitPhase or !fSingleBinFill) return false;
+
+  fMCFill.Reset();
+  fMCHist->Reset();
+  if (!fMCHist->GetSumw2N()) fMCHist->Sumw2();
+
+  int ncells = fMCHist->GetSize();
+  double* val = fMCHist->GetArray();
+  double* err = fMCHist->GetSumw2()->GetArray();
+  for (int i = 0; i < ncells; i++) {
+    val[i] = sumw[i];
+    err[i] = sumw2[i];
+  }
+
+  // One entry per signal fill, as FillHistograms would have counted
+  fMCHist->SetEntries(fMCStat->GetEntries());
+  return true;
+}
+
 
 /*
   Fake Data Functions
@@ -1063,29 +1211,34 @@ void Measurement2D::SetFakeDataValues(std::string fakeOption) {
 
   // Make a new covariance for fake data hist.
   int nbins = fDataHist->GetNbinsX() * fDataHist->GetNbinsY();
-  double alpha_i = 0.0;
-  double alpha_j = 0.0;
+  std::vector<double> alpha(nbins, 0.0);
+  for (int i = 0; i < nbins; i++) {
+    // Empty reference bins drop out of the covariance
+    if (!tempdata->GetBinContent(i + 1)) continue;
+    alpha[i] = fDataHist->GetBinContent(i + 1) / tempdata->GetBinContent(i + 1);
+  }
 
   for (int i = 0; i < nbins; i++) {
     for (int j = 0; j < nbins; j++) {
-      if (tempdata->GetBinContent(i + 1) && tempdata->GetBinContent(j + 1)) {
-        alpha_i = fDataHist->GetBinContent(i + 1) / tempdata->GetBinContent(i + 1);
-        alpha_j = fDataHist->GetBinContent(j + 1) / tempdata->GetBinContent(j + 1);
-      } else {
-        alpha_i = 0.0;
-        alpha_j = 0.0;
-      }
-
-      (*fFullCovar)(i, j) = alpha_i * alpha_j * (*fFullCovar)(i, j);
+      (*fFullCovar)(i, j) = alpha[i] * alpha[j] * (*fFullCovar)(i, j);
     }
   }
 
-  // Setup Covariances
+  // Setup Covariances, rescaling the cached forms rather than reinverting
   if (covar) delete covar;
-  covar   = StatUtils::GetInvert(fFullCovar);
-
   if (fDecomp) delete fDecomp;
-  fDecomp = StatUtils::GetInvert(fFullCovar);
+  if (fCovarCache.IsSetup(fCovarGen)) {
+    fCovarCache.ScaleBins(alpha);
+    covar   = (TMatrixDSym*) fCovarCache.GetInverse()->Clone();
+    fDecomp = (TMatrixDSym*) fCovarCache.GetDecomp()->Clone();
+  } else {
+    covar   = StatUtils::GetInvert(fFullCovar);
+    fDecomp = StatUtils::GetDecomp(fFullCovar);
+  }
+  fCovarGen++;
+  fCovarCache.Setup(fCovarGen, fFullCovar, covar, fDecomp);
+  fChi2Eval.Reset();
+  fThrower.Reset();
 
   delete tempdata;
 
@@ -1121,9 +1274,8 @@ void Measurement2D::ThrowCovariance() {
 
   // Take a fDecomposition and use it to throw the current dataset.
   // Requires fDataTrue also be set incase used repeatedly.
-
-  if (fDataHist) delete fDataHist;
-  fDataHist = StatUtils::ThrowHistogram(fDataTrue, fFullCovar);
+  if (!fDataTrue) fDataTrue = (TH2D*) fDataHist->Clone();
+  ThrowFromTrue(fDataHist);
 
   return;
 };
@@ -1132,8 +1284,39 @@ void Measurement2D::ThrowCovariance() {
 void Measurement2D::ThrowDataToy() {
   //********************************************************************
   if (!fDataTrue) fDataTrue = (TH2D*) fDataHist->Clone();
-  if (fMCHist) delete fMCHist;
-  fMCHist = StatUtils::ThrowHistogram(fDataTrue, fFullCovar);
+  ThrowFromTrue(fMCHist);
+}
+
+//********************************************************************
+void Measurement2D::SetupMapBins() {
+//********************************************************************
+
+  if (!fMapHist) {
+    fMapHist = StatUtils::GenerateMap(fDataHist);
+    fCovarGen++;
+  }
+  if (!fMapBins.empty()) return;
+
+  // Throws cover every mapped bin, masking is left to the chi2
+  std::vector<bool> masked;
+  StatUtils::GenerateMapBins(fDataHist, fMapHist, NULL, fMapBins, masked);
+}
+
+//********************************************************************
+void Measurement2D::ThrowFromTrue(TH2D* hist) {
+//********************************************************************
+
+  // Covariance rows follow the fMapHist indices
+  if (!fThrower.IsSetup(fFullCovar)) {
+    SetupMapBins();
+    if (fCovarCache.IsSetup(fCovarGen)) {
+      fThrower.SetupDecomp(fFullCovar, fCovarCache.GetDecomp(), fMapBins);
+    } else {
+      fThrower.Setup(fFullCovar, fMapBins);
+    }
+  }
+
+  fThrower.FillHistogram(hist, fDataTrue, fThrower.NextToy());
 }
 
 
@@ -1207,6 +1390,8 @@ TH2D* Measurement2D::GetDataHistogram() {
 void Measurement2D::Write(std::string drawOpt) {
 //********************************************************************
 
+  FlushHistograms();
+
   // Get Draw Options
   drawOpt = FitPar::Config().GetParS("drawopts");
 
@@ -1339,7 +1524,7 @@ void Measurement2D::Write(std::string drawOpt) {
   }
 
   // Generate a simple map
-  if (!fMapHist) fMapHist = StatUtils::GenerateMap(fDataHist);
+  SetupMapBins();
 
   // Convert to 1D Lists
   TH1D* data_1D = StatUtils::MapToTH1D(fDataHist, fMapHist);
@@ -1846,6 +2031,7 @@ void Measurement2D::SetCovarMatrix(std::string covarFile) {
 
   TDecompSVD LU = TDecompSVD(*this->covar);
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   tempFile->Close();
   delete tempFile;
@@ -1892,6 +2078,7 @@ void Measurement2D::SetCovarMatrixFromText(std::string covarFile, int dim) {
   // Robust matrix inversion method
   TDecompSVD LU = TDecompSVD(*this->covar);
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   return;
 };
@@ -1941,6 +2128,7 @@ void Measurement2D::SetCovarMatrixFromChol(std::string covarFile, int dim) {
   // Robust matrix inversion method
   TDecompChol LU = TDecompChol(*this->fFullCovar);
   this->covar = new TMatrixDSym(dim, LU.Invert().GetMatrixArray(), "");
+  fCovarGen++;
 
   return;
 };
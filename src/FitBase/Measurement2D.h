@@ -54,6 +54,10 @@
 #include "PlotUtils.h"
 #include "SignalDef.h"
 #include "StatUtils.h"
+#include "Chi2Evaluator.h"
+#include "MVNThrower.h"
+#include "CovarianceCache.h"
+#include "HistAccumulator.h"
 #include "MeasurementVariableBox2D.h"
 
 //********************************************************************
@@ -351,6 +355,12 @@ public:
   /// even if they have been set to auto process.
   virtual void FillHistograms(void);
 
+  /// \brief Add the fills held in fMCFill and fMCFineFill to the MC histograms
+  ///
+  /// The standard histograms are filled through array accumulators during the
+  /// event loop. This is called before they are scaled or written.
+  virtual void FlushHistograms(void);
+
   // \brief Convert event rates to final histogram
   ///
   /// Apply standard scaling procedure to standard mc histograms to convert from
@@ -385,6 +395,16 @@ public:
   /// Diferent likelihoods definitions are used depending on the FitOptions.
   virtual double GetLikelihood(void);
 
+  /// \brief MC histogram bin filled by a signal event box
+  virtual int GetLikelihoodBin(MeasurementVariableBox* box);
+
+  /// \brief Set fMCHist from per bin signal weight sums
+  ///
+  /// Only valid in the fit phase, where FillHistograms fills fMCHist and
+  /// fMCStat alone. fMCStat does not depend on the weights and is kept.
+  /// Requires fSingleBinFill.
+  virtual bool SetLikelihoodBins(const double* sumw, const double* sumw2);
+
 
 
 
@@ -428,6 +448,15 @@ public:
   /// so that the likelihood is calculated between data and thrown data     
   virtual void ThrowDataToy(void);
 
+  /// \brief Flatten fMapHist into fMapBins
+  ///
+  /// Generates the map from the data if none was given. Only done once, the
+  /// throws then index the histogram arrays through fMapBins.
+  void SetupMapBins(void);
+
+  /// \brief Set hist to fDataTrue plus the next toy of fThrower, in place
+  void ThrowFromTrue(TH2D* hist);
+
 
 
 
@@ -578,6 +607,7 @@ protected:
 
   TH2I* fMaskHist;  //!< mask histogram for the data
   TH2I* fMapHist;   //!< map histogram used to convert 2D to 1D distributions
+  std::vector<int> fMapBins;  //!< Global bin of each fMapHist index, -1 if unused
 
   bool fIsFakeData;          //!< is current data actually fake
   std::string fakeDataFile;  //!< MC fake data input file
@@ -588,6 +618,10 @@ protected:
   std::string fAllowedTypes;  //!< Any allowed Fit Options
 
   TMatrixDSym* covar;       //!< inverted covariance matrix
+  int fCovarGen;            //!< bumped whenever covar, fFullCovar, fMapHist or fMaskHist change
+  Chi2Evaluator fChi2Eval;  //!< cached chi2 setup for covar, fMapHist and fMaskHist
+  MVNThrower fThrower;      //!< cached decomposition of fFullCovar for toys
+  CovarianceCache fCovarCache;  //!< full, inverted and masked forms of fFullCovar
   TMatrixDSym* fFullCovar;  //!< covariance matrix
   TMatrixDSym* fDecomp;     //!< fDecomposed covariance matrix
   TMatrixDSym* fCorrel;     //!< correlation matrix
@@ -623,6 +657,25 @@ protected:
 
   TrueModeStack* fMCHist_Modes; ///< Optional True Mode Stack
 
+  /// \brief Point the fill accumulators at the current MC histograms
+  void SetupFillCache(void);
+
+  HistAccumulator fMCFill;      ///< Pending fills of fMCHist, fMCStat and fMCHist_Modes
+  HistAccumulator fMCFineFill;  ///< Pending fills of fMCFine
+  TrueModeStack* fMCFillModes;  ///< Mode stack fMCFill was setup with
+  int fMCStatSlot;              ///< fMCFill slot of fMCStat
+  int fMCModeSlot;              ///< fMCFill slot of the first mode, -1 if none
+  int fMCNModes;                ///< Number of mode slots
+
+  /// \brief Compute the flux unfolding factors for fMCHist and fMCFine
+  void SetupFluxUnfolding(void);
+
+  std::vector<double> fStatRatio;      ///< Per bin MC stat error / content
+  std::vector<double> fStatRatioFine;  ///< Per bin fine MC stat error / content
+  std::vector<double> fFluxUnfoldFactors;     ///< fMCHist flux unfolding factors
+  std::vector<double> fFluxUnfoldFineFactors; ///< fMCFine flux unfolding factors
+  double fFluxUnfoldScale; ///< fScaleFactor the unfolding factors were built with
+
   TMatrixDSym* fCovar;    ///< New FullCovar
   TMatrixDSym* fInvert;   ///< New covar
 
@@ -19,6 +19,8 @@
 
 #include "MeasurementBase.h"
 
+#include <algorithm>
+
 /*
   Constructor/Destructors
 */
@@ -30,6 +32,12 @@ MeasurementBase::MeasurementBase(void) {
 
   fScaleFactor = 1.0;
   fMCFilled = false;
+  fProfileNorm = false;
+  fProfiledNorm = 1.0;
+  fThreadSafe = false;
+  fFitPhase = false;
+  fFitPhaseSafe = true;
+  fSingleBinFill = false;
   fNoData = false;
   fInput = NULL;
   NSignal = 0;
@@ -42,6 +50,10 @@ MeasurementBase::MeasurementBase(void) {
   fMeasurementSpeciesType = kSingleSpeciesMeasurement;
   fEventVariables = NULL;
   fIsJoint = false;
+  fUseSignalCache = true;
+  fSignalCacheReady = false;
+  fSignalCacheChecked = false;
+  fSignalCacheSplines = false;
 
   fNPOT = 0xdeadbeef;
   fFluxIntegralOverride = 0xdeadbeef;
@@ -58,7 +70,8 @@ void MeasurementBase::FinaliseMeasurement() {
 // 2nd Level Destructor (Inherits From MeasurementBase.h)
 MeasurementBase::~MeasurementBase(){
     //********************************************************************
-
+  ClearSignalCache();
+  if (fInput) fInput->RemovePreselection(this);
 };
 
 //********************************************************************
@@ -106,6 +119,7 @@ void MeasurementBase::SetupInputs(std::string inputfile) {
   }
 
   fNEvents = fInput->GetNEvents();
+  fInput->SetPreselection(this, fPreselection);
 
   // Expect INPUTTYPE:FileLocation(s)
   std::vector<std::string> file_descriptor =
@@ -209,11 +223,7 @@ void MeasurementBase::Reconfigure() {
   //***********************************************
 
   LOG(REC) << " Reconfiguring sample " << fName << std::endl;
-
-  // Reset Histograms
-  ResetExtraHistograms();
-  AutoResetExtraTH1();
-  this->ResetAll();
+  bool savesignal = BeginReconfigure();
 
   // FitEvent* cust_event = fInput->GetEventPointer();
   int fNEvents = fInput->GetNEvents();
@@ -224,33 +234,12 @@ void MeasurementBase::Reconfigure() {
   int i = 0;
   int npassed = 0;
   while (cust_event) {
-    cust_event->RWWeight = fRW->CalcWeight(cust_event);
-    cust_event->Weight = cust_event->RWWeight * cust_event->InputWeight;
-
-    Weight = cust_event->Weight;
-
-    // Initialize
-    fXVar = -999.9;
-    fYVar = -999.9;
-    fZVar = -999.9;
-    Signal = false;
-    Mode = cust_event->Mode;
-
-    // Extract Measurement Variables
-    this->FillEventVariables(cust_event);
-    Signal = this->isSignal(cust_event);
-    if (Signal) npassed++;
-
-    GetBox()->SetX(fXVar);
-    GetBox()->SetY(fYVar);
-    GetBox()->SetZ(fZVar);
-    GetBox()->SetMode(Mode);
-    // GetBox()->fSignal = Signal;
+    if (cust_event->fPreselected) {
+      cust_event->RWWeight = fRW->CalcWeight(cust_event);
+      cust_event->Weight = cust_event->RWWeight * cust_event->InputWeight;
+    }
 
-    // Fill Histogram Values
-    GetBox()->FillBoxFromEvent(cust_event);
-    // this->FillExtraHistograms(GetBox(), Weight);
-    this->FillHistogramsFromBox(GetBox(), Weight);
+    if (FillReconfigureEvent(cust_event, i, savesignal)) npassed++;
 
     // Print Out
     if (LOG_LEVEL(REC) && countwidth > 0 && !(i % countwidth)) {
@@ -279,9 +268,260 @@ void MeasurementBase::Reconfigure() {
   LOG(REC) << std::setw(10) << std::right << NSignal << "/" << fNEvents
            << " events passed selection + binning after reweight" << std::endl;
 
+  FinishReconfigure(savesignal);
+}
+
+//***********************************************
+void MeasurementBase::ReconfigureSharedInput(
+    const std::vector<MeasurementBase*>& samples) {
+  //***********************************************
+
+  if (samples.empty()) return;
+  InputHandlerBase* input = samples[0]->fInput;
+  FitWeight* rw = samples[0]->fRW;
+  int nsamples = samples.size();
+
+  LOG(REC) << " Reconfiguring " << nsamples << " samples sharing input "
+           << input->GetName() << std::endl;
+
+  std::vector<bool> savesignal(nsamples);
+  std::vector<int> npassed(nsamples, 0);
+  for (int j = 0; j < nsamples; j++) {
+    savesignal[j] = samples[j]->BeginReconfigure();
+  }
+
+  // One event pass, reweighted once and filled into every sample
+  FitEvent* cust_event = input->FirstNuisanceEvent();
+  int i = 0;
+  while (cust_event) {
+    if (!cust_event->fPreselected) {
+      cust_event = input->NextNuisanceEvent();
+      i++;
+      continue;
+    }
+
+    cust_event->RWWeight = rw->CalcWeight(cust_event);
+    cust_event->Weight = cust_event->RWWeight * cust_event->InputWeight;
+
+    for (int j = 0; j < nsamples; j++) {
+      bool save = savesignal[j];
+      if (samples[j]->FillReconfigureEvent(cust_event, i, save)) npassed[j]++;
+      savesignal[j] = save;
+    }
+
+    cust_event = input->NextNuisanceEvent();
+    i++;
+  }
+
+  for (int j = 0; j < nsamples; j++) {
+    LOG(SAM) << samples[j]->fName << " : " << npassed[j] << "/" << i
+             << " passed selection " << std::endl;
+    if (npassed[j] == 0) {
+      LOG(SAM) << "WARNING: NO EVENTS PASSED SELECTION!" << std::endl;
+    }
+    samples[j]->FinishReconfigure(savesignal[j]);
+  }
+}
+
+//***********************************************
+bool MeasurementBase::BeginReconfigure() {
+  //***********************************************
+
+  // Reset Histograms
+  if (!fFitPhase) {
+    ResetExtraHistograms();
+    AutoResetExtraTH1();
+  }
+  this->ResetAll();
+
+  // Signal events are kept so ReconfigureFast can skip the selection
+  ClearSignalCache();
+  return fUseSignalCache and FitPar::Config().GetSnapshot().SignalReconfigures;
+}
+
+//***********************************************
+bool MeasurementBase::FillReconfigureEvent(FitEvent* cust_event, int entry,
+                                           bool& savesignal) {
+  //***********************************************
+
+  // Only the header of events failing the input preselection is read
+  Signal = false;
+  if (!cust_event->fPreselected) return false;
+
+  Weight = cust_event->Weight;
+
+  // Initialize
+  fXVar = -999.9;
+  fYVar = -999.9;
+  fZVar = -999.9;
+  Signal = false;
+  Mode = cust_event->Mode;
+
+  // Extract Measurement Variables
+  this->FillEventVariables(cust_event);
+  Signal = this->isSignal(cust_event);
+
+  GetBox()->SetX(fXVar);
+  GetBox()->SetY(fYVar);
+  GetBox()->SetZ(fZVar);
+  GetBox()->SetMode(Mode);
+  // GetBox()->fSignal = Signal;
+
+  // Fill Histogram Values
+  GetBox()->FillBoxFromEvent(cust_event);
+  // this->FillExtraHistograms(GetBox(), Weight);
+  this->FillHistogramsFromBox(GetBox(), Weight);
+
+  if (savesignal and Signal) savesignal = SaveSignalEvent(cust_event, entry);
+  if (Signal) CheckPreselection(cust_event);
+
+  return Signal;
+}
+
+//***********************************************
+void MeasurementBase::CheckPreselection(FitEvent* event) {
+  //***********************************************
+
+  // Declared cuts must never reject a signal event
+  if (!fPreselection.IsSet()) return;
+
+  FitParticle* nu = event->GetNeutrinoIn();
+  if (nu and !fPreselection.Accept(nu->fPID, nu->fP.E(), event->Mode)) {
+    ERR(FTL) << fName << " : signal event fails the sample preselection, "
+             << "check its SetPreselection call." << std::endl;
+    throw;
+  }
+}
+
+//***********************************************
+void MeasurementBase::SetPreselection(int nupdg, bool cc, bool nc) {
+  //***********************************************
+
+  fPreselection = InputPreselection();
+  if (nupdg) fPreselection.fNuPDG.push_back(nupdg);
+  fPreselection.fCC = cc;
+  fPreselection.fNC = nc;
+
+  // Same window as SignalDef::IsEnuInRange, which is skipped if empty
+  if (EnuMax > EnuMin) {
+    fPreselection.fEnuMin = EnuMin * 1000.;
+    fPreselection.fEnuMax = EnuMax * 1000.;
+  }
+
+  if (fInput) fInput->SetPreselection(this, fPreselection);
+}
+
+//***********************************************
+void MeasurementBase::FinishReconfigure(bool savesignal) {
+  //***********************************************
+
+  // The input decodes every event until this loop has checked our cuts
+  if (fInput) fInput->SetPreselectionChecked(this);
+
   // Finalise Histograms
   fMCFilled = true;
   this->ConvertEventRates();
+
+  if (!savesignal) {
+    ClearSignalCache();
+    return;
+  }
+  fSignalCacheReady = true;
+
+  // Check the replay reproduces the full loop once per sample. The MC bins
+  // are compared, as samples without data always have a zero likelihood.
+  if (!fSignalCacheChecked) {
+    fSignalCacheChecked = true;
+    std::vector<double> full;
+    GetMCBinContents(full);
+    this->ReconfigureFast();
+    std::vector<double> fast;
+    GetMCBinContents(fast);
+
+    size_t nbad = (full.size() == fast.size()) ? 0 : 1;
+    for (size_t i = 0; !nbad and i < full.size(); i++) {
+      double tol = 1E-6 * std::max(fabs(full[i]), fabs(fast[i]));
+      if (fabs(full[i] - fast[i]) > tol) nbad++;
+    }
+
+    if (nbad) {
+      ERR(WRN) << "Fast and Full MC histograms DIFFER for " << fName << std::endl;
+      ERR(WRN) << "Signal reconfigures disabled for this sample." << std::endl;
+      ClearSignalCache();
+      fUseSignalCache = false;
+      this->Reconfigure();
+    }
+  }
+}
+
+//***********************************************
+void MeasurementBase::GetMCBinContents(std::vector<double>& vals) {
+  //***********************************************
+
+  vals.clear();
+  std::vector<TH1*> hists = GetMCList();
+  std::vector<TH1*> fine = GetFineList();
+  hists.insert(hists.end(), fine.begin(), fine.end());
+
+  for (size_t i = 0; i < hists.size(); i++) {
+    TArrayD* arr = dynamic_cast<TArrayD*>(hists[i]);
+    if (!arr) continue;
+    vals.insert(vals.end(), arr->GetArray(), arr->GetArray() + arr->GetSize());
+  }
+}
+
+//***********************************************
+bool MeasurementBase::SaveSignalEvent(FitEvent* event, int entry) {
+  //***********************************************
+
+  MeasurementVariableBox* box = GetBox()->CloneSignalBox();
+  if (!box) return false;
+
+  // Spline inputs are reweighted from the coefficients alone
+  bool splines = (event->fSplineRead and event->fSplineCoeff);
+  if (fSignalCacheBoxes.empty()) fSignalCacheSplines = splines;
+  if (splines != fSignalCacheSplines) {
+    delete box;
+    return false;
+  }
+
+  fSignalCacheBoxes.push_back(box);
+  fSignalCacheEntries.push_back(entry);
+  fSignalCacheModes.push_back(event->Mode);
+  fSignalCacheInputWeights.push_back(event->InputWeight);
+
+  if (splines) {
+    fSignalCacheOffsets.push_back(fSignalCacheCoeffs.size());
+    int ncoeff = event->fSplineRead->GetNPar();
+    if (event->fSplineMask) {
+      int nwords = event->fSplineRead->GetNMaskWords();
+      ncoeff = event->fSplineRead->GetNPacked(event->fSplineMask);
+      fSignalCacheMasks.insert(fSignalCacheMasks.end(), event->fSplineMask,
+                               event->fSplineMask + nwords);
+    }
+    fSignalCacheCoeffs.insert(fSignalCacheCoeffs.end(), event->fSplineCoeff,
+                              event->fSplineCoeff + ncoeff);
+  }
+
+  return true;
+}
+
+//***********************************************
+void MeasurementBase::ClearSignalCache() {
+  //***********************************************
+
+  for (size_t i = 0; i < fSignalCacheBoxes.size(); i++) {
+    if (fEventVariables == fSignalCacheBoxes[i]) fEventVariables = NULL;
+    delete fSignalCacheBoxes[i];
+  }
+  fSignalCacheBoxes.clear();
+  fSignalCacheEntries.clear();
+  fSignalCacheModes.clear();
+  fSignalCacheInputWeights.clear();
+  fSignalCacheCoeffs.clear();
+  fSignalCacheMasks.clear();
+  fSignalCacheOffsets.clear();
+  fSignalCacheReady = false;
 }
 
 void MeasurementBase::FillHistogramsFromBox(MeasurementVariableBox* var,
@@ -293,13 +533,13 @@ void MeasurementBase::FillHistogramsFromBox(MeasurementVariableBox* var,
   fEventVariables = var;
 
   FillHistograms();
-  FillExtraHistograms(var, weight);
+  if (!fFitPhase) FillExtraHistograms(var, weight);
 }
 
 void MeasurementBase::FillHistograms(double weight) {
   Weight = weight * GetBox()->GetSampleWeight();
   FillHistograms();
-  FillExtraHistograms(GetBox(), Weight);
+  if (!fFitPhase) FillExtraHistograms(GetBox(), Weight);
 }
 
 MeasurementVariableBox* MeasurementBase::FillVariableBox(FitEvent* event) {
@@ -330,15 +570,76 @@ MeasurementVariableBox* MeasurementBase::GetBox() {
 //***********************************************
 void MeasurementBase::ReconfigureFast() {
   //***********************************************
-  this->Reconfigure();
+
+  if (!fSignalCacheReady or !fMCFilled) {
+    this->Reconfigure();
+    return;
+  }
+
+  LOG(REC) << " Reconfiguring signal events of sample " << fName << std::endl;
+
+  // Reset Histograms
+  if (!fFitPhase) {
+    ResetExtraHistograms();
+    AutoResetExtraTH1();
+  }
+  this->ResetAll();
+
+  bool fullevent = FitPar::Config().GetSnapshot().FullEventOnSignalReconfigure;
+  BaseFitEvt* splineevent = NULL;
+  if (fSignalCacheSplines) {
+    splineevent = fInput->FirstBaseEvent();
+    splineevent->fSplineRead->SetNeedsReconfigure(true);
+  }
+
+  // FillHistogramsFromBox points fEventVariables at the box it fills from
+  MeasurementVariableBox* box = GetBox();
+
+  int nsignal = fSignalCacheBoxes.size();
+  for (int i = 0; i < nsignal; i++) {
+    BaseFitEvt* event = splineevent;
+    if (splineevent) {
+      size_t off = fSignalCacheOffsets[i];
+      event->fSplineCoeff =
+          fSignalCacheCoeffs.empty() ? NULL : &fSignalCacheCoeffs[0] + off;
+      if (event->fSplineMask) {
+        int nwords = event->fSplineRead->GetNMaskWords();
+        event->fSplineMask = &fSignalCacheMasks[i * nwords];
+      }
+      event->Mode = fSignalCacheModes[i];
+      event->InputWeight = fSignalCacheInputWeights[i];
+    } else if (fullevent) {
+      event = fInput->GetNuisanceEvent(fSignalCacheEntries[i]);
+    } else {
+      event = fInput->GetBaseEvent(fSignalCacheEntries[i]);
+    }
+
+    event->RWWeight = fRW->CalcWeight(event);
+    event->Weight = event->RWWeight * event->InputWeight;
+
+    Signal = true;
+    Mode = fSignalCacheModes[i];
+    this->FillHistogramsFromBox(fSignalCacheBoxes[i], event->Weight);
+  }
+  fEventVariables = box;
+
+  LOG(REC) << std::setw(10) << std::right << nsignal
+           << " cached signal events refilled" << std::endl;
+
+  // Finalise Histograms
+  fMCFilled = true;
+  this->ConvertEventRates();
 }
 
 //***********************************************
 void MeasurementBase::ConvertEventRates() {
   //***********************************************
 
-  AutoScaleExtraTH1();
-  ScaleExtraHistograms(GetBox());
+  FlushHistograms();
+  if (!fFitPhase) {
+    AutoScaleExtraTH1();
+    ScaleExtraHistograms(GetBox());
+  }
   this->ScaleEvents();
 
   double normval = fRW->GetSampleNorm(this->fName);
@@ -351,8 +652,10 @@ void MeasurementBase::ConvertEventRates() {
     ERR(WRN) << "Setting it to 1.0" << std::endl;
     normval = 1.0;
   }
-  AutoNormExtraTH1(normval);
-  NormExtraHistograms(GetBox(), normval);
+  if (!fFitPhase) {
+    AutoNormExtraTH1(normval);
+    NormExtraHistograms(GetBox(), normval);
+  }
   this->ApplyNormScale(normval);
 }
 
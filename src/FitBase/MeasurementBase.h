@@ -124,17 +124,80 @@ public:
   virtual void Renormalise(void);
 
   //! Call reconfigure only looping over signal events to save time.
+  //! Replays the signal events cached by the last full Reconfigure when
+  //! SignalReconfigures is set, otherwise calls Reconfigure.
   virtual void ReconfigureFast(void);
 
+  //! Delete the signal events cached for ReconfigureFast
+  virtual void ClearSignalCache(void);
+
   virtual void FillHistograms(double weight);
 
 
   //! Call reconfigure looping over all MC events including background
   virtual void Reconfigure(void);
 
+  //! Reconfigure several samples that share one input handler with a single
+  //! pass over its events, reweighting each event once. Every sample sees the
+  //! same FitEvent, so isSignal and FillEventVariables must not modify it
+  //! (e.g. a smearcepter's EnergyShuffler removing particle KE).
+  static void ReconfigureSharedInput(const std::vector<MeasurementBase*>& samples);
+
+  //! Stop if a signal event fails the cuts declared with SetPreselection,
+  //! as the input may leave such events undecoded. The input decodes every
+  //! event until the first full reconfigure after the cuts are declared, so
+  //! that loop checks all of them.
+  void CheckPreselection(FitEvent* event);
+
   // virtual TH2D GetCovarMatrix(void) = 0;
   virtual double GetLikelihood(void) { return 0.0; };
   virtual int GetNDOF(void) { return 0; };
+
+  //! Whether GetLikelihoodGradient and GetLikelihoodBin are implemented.
+  //! Used by JointFCN to decide if an analytic gradient can be used.
+  virtual bool HasLikelihoodGradient(void) { return false; };
+
+  //! MC * dL/dMC for each global bin of the first MC histogram, with respect
+  //! to a relative change of the linearly filled content, and the total
+  //! dL/dnorm of the sample norm.
+  virtual void GetLikelihoodGradient(std::vector<double>& dldlnmc, double& dldnorm) {
+    dldlnmc.clear();
+    dldnorm = 0.0;
+  };
+
+  //! Global bin of the first MC histogram a signal box fills, -1 if none
+  virtual int GetLikelihoodBin(MeasurementVariableBox* box) {
+    (void)box;
+    return -1;
+  };
+
+  //! Overwrite the first MC histogram with per global bin sums of the signal
+  //! weights and squared weights, as a fit phase refill from the same boxes
+  //! would leave it before ConvertEventRates. Returns false if unsupported.
+  virtual bool SetLikelihoodBins(const double* sumw, const double* sumw2) {
+    (void)sumw;
+    (void)sumw2;
+    return false;
+  };
+
+  //! Whether GetLikelihood profiles the sample normalisation analytically,
+  //! in which case the norm dial can be left out of the minimiser.
+  inline bool IsNormProfiled(void) { return fProfileNorm; };
+
+  //! Norm dial value equivalent to the last profiled normalisation
+  inline double GetProfiledNorm(void) { return fProfiledNorm; };
+
+  //! Whether ConvertEventRates and GetLikelihood only touch this sample's own
+  //! objects, so JointFCN may run them alongside other samples. Off unless a
+  //! sample's constructor opts in, which it should only do when it keeps the
+  //! base ScaleEvents and GetLikelihood and reads no config or files in them.
+  inline bool IsThreadSafe(void) { return fThreadSafe; };
+
+  //! Set while the FCN only needs likelihoods. Histograms that are only
+  //! written out are then left unfilled until a later full reconfigure.
+  //! Ignored by samples whose likelihood reads more than fMCHist.
+  virtual void SetFitPhase(bool fitphase) { fFitPhase = fitphase and fFitPhaseSafe; };
+  inline bool IsFitPhase(void) { return fFitPhase; };
   virtual void ThrowCovariance(void) = 0;
   virtual void ThrowDataToy(void) = 0;
   virtual void SetFakeDataValues(std::string fkdt) = 0;
@@ -192,6 +255,10 @@ public:
   /// inherited sample)
   virtual void FillHistograms(void) {};
 
+  ///! Move fills held outside the MC histograms into them. Called before
+  /// the histograms are scaled or written.
+  virtual void FlushHistograms(void) {};
+
   ///! Convert event rates to whatever distributions you need.
   virtual void ConvertEventRates(void);
 
@@ -314,6 +381,19 @@ protected:
   //! eventrate to final distribution
   double
   fCurrentNorm;  //!< current normalisation factor applied if fit is "FREE"
+  bool fProfileNorm;     //!< flag whether the "FREE" norm is profiled in GetLikelihood
+  double fProfiledNorm;  //!< norm found by the last profiled GetLikelihood
+  bool fThreadSafe;      //!< flag whether the sample can be finalised concurrently, see IsThreadSafe
+  bool fFitPhase;        //!< flag whether only likelihood histograms are filled
+  //! flag whether the likelihood needs only fMCHist filled. Samples that
+  //! override the MC filling, scaling or likelihood clear it in their
+  //! constructor so every histogram stays filled during fits.
+  bool fFitPhaseSafe;
+  //! flag whether each signal event fills fMCHist once, in the bin given by
+  //! GetLikelihoodBin. Lets the fit phase set fMCHist from per bin weight
+  //! sums. Only set by samples that keep the base FillHistograms, as
+  //! overrides can fill other bins or several times per event.
+  bool fSingleBinFill;
   bool fMCFilled;    //!< flag whether MC plots have been filled (For
   //! ApplyNormalisation)
   bool fNoData;      //!< flag whether data plots do not exist (for ratios)
@@ -342,6 +422,42 @@ protected:
 
   bool fIsJoint;
 
+  //! Reset histograms ahead of the Reconfigure event loop. Returns whether
+  //! signal events should be saved for ReconfigureFast.
+  bool BeginReconfigure(void);
+
+  //! Fill this sample from one reweighted event. Returns true if signal.
+  bool FillReconfigureEvent(FitEvent* event, int entry, bool& savesignal);
+
+  //! Finalise histograms and the signal cache after the event loop
+  void FinishReconfigure(bool savesignal);
+
+  //! Declare coarse cuts every signal event of this sample passes, so the
+  //! input can skip decoding events no sample sharing it accepts. nupdg 0
+  //! allows any neutrino. The Enu window is taken from EnuMin and EnuMax, so
+  //! call this after FinaliseSampleSettings.
+  void SetPreselection(int nupdg, bool cc = true, bool nc = true);
+
+  InputPreselection fPreselection;  //!< Cuts declared to fInput
+
+  //! Cache a filled signal event for ReconfigureFast. False if unsupported.
+  bool SaveSignalEvent(FitEvent* event, int entry);
+
+  //! Flattened bin contents of the MC and fine MC histograms
+  void GetMCBinContents(std::vector<double>& vals);
+
+  bool fUseSignalCache;      //!< Replay matched the full loop or is unchecked
+  bool fSignalCacheReady;    //!< Signal cache matches the last Reconfigure
+  bool fSignalCacheChecked;  //!< Replay has been compared with a Reconfigure
+  bool fSignalCacheSplines;  //!< Weights come from cached spline coefficients
+  std::vector<int> fSignalCacheEntries;          //!< Input entry of each signal event
+  std::vector<int> fSignalCacheModes;            //!< Mode of each signal event
+  std::vector<double> fSignalCacheInputWeights;  //!< Input weight of each signal event
+  std::vector<MeasurementVariableBox*> fSignalCacheBoxes;  //!< Filled box clones
+  std::vector<float> fSignalCacheCoeffs;         //!< Flat spline coefficients
+  std::vector<UInt_t> fSignalCacheMasks;         //!< Flat masks if packed splines used
+  std::vector<size_t> fSignalCacheOffsets;       //!< First coefficient of each event
+
 
 
   double fNPOT, fFluxIntegralOverride, fTargetVolume, fTargetMaterialDensity;
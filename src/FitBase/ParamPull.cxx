@@ -27,6 +27,7 @@ ParamPull::ParamPull(std::string name, std::string inputfile, std::string type,
   fTypeHist = NULL;
   fDialSelection = dials;
   fLimitHist = NULL;
+  fCovarGen = 0;
 
   fName  = name;
   fInput = inputfile;
@@ -171,6 +172,7 @@ void ParamPull::SetupHistograms(std::string input) {
   // Sort Covariances
   fInvCovar = StatUtils::GetInvert(fCovar);
   fDecomp   = StatUtils::GetDecomp(fCovar);
+  fCovarGen++;
 
   // Create DataTrue for Throws
   fDataTrue = (TH1D*) fDataHist->Clone();
@@ -670,7 +672,10 @@ double ParamPull::GetLikelihood() {
 
   // Gaussian Calculation with correlations
   case kGausPull:
-    like = StatUtils::GetChi2FromCov(fDataHist, fMCHist, fInvCovar, NULL);
+    if (!fChi2Eval.IsSetup(Chi2Evaluator::kChi2Cov, fCovarGen)) {
+      fChi2Eval.Setup(Chi2Evaluator::kChi2Cov, fCovarGen, fDataHist, fInvCovar, NULL);
+    }
+    like = fChi2Eval.Eval(fDataHist, fMCHist);
     like *= 1E-76;
     break;
 
@@ -687,6 +692,50 @@ double ParamPull::GetLikelihood() {
 
 };
 
+//*******************************************************************************
+void ParamPull::AddLikelihoodGradient(double* grad) {
+//*******************************************************************************
+
+  // Only the gaussian pull depends on the dials
+  if (fCalcType != kGausPull) return;
+
+  // GetLikelihood scales the chi2 by 1E-76, cancelling the covariance scale
+  std::vector<double> dldmc;
+  StatUtils::GetChi2GradientFromCov(fDataHist, fMCHist, fInvCovar, NULL, dldmc,
+                                    1.0, 1.0);
+
+  // Map bins back to dials the same way Reconfigure sets them,
+  // the last dial matching a bin owns it.
+  std::vector<std::string> namevec = FitBase::GetRW()->GetDialNames();
+  std::vector<int> owner(fMCHist->GetNbinsX(), -1);
+
+  for (UInt_t i = 0; i < namevec.size(); i++) {
+    std::string syst = namevec.at(i);
+    std::vector<std::string> allsyst = GeneralUtils::ParseToStr(syst, ",");
+
+    for (int j = 0; j < fMCHist->GetNbinsX(); j++) {
+      std::string binname = std::string(fMCHist->GetXaxis()->GetBinLabel(j + 1) );
+
+      if (!syst.compare(binname.c_str())) {
+        owner[j] = i;
+        break;
+      }
+
+      std::vector<std::string> splitbinname = GeneralUtils::ParseToStr(binname, ",");
+      for (size_t l = 0; l < splitbinname.size(); l++) {
+        for (size_t k = 0; k < allsyst.size(); k++) {
+          if (!allsyst[k].compare(splitbinname[l].c_str())) owner[j] = i;
+        }
+      }
+    }
+  }
+
+  for (int j = 0; j < fMCHist->GetNbinsX(); j++) {
+    if (owner[j] < 0) continue;
+    grad[owner[j]] += dldmc[j + 1];
+  }
+}
+
 //*******************************************************************************
 int ParamPull::GetNDOF() {
 //*******************************************************************************
@@ -709,18 +758,22 @@ void ParamPull::ThrowCovariance() {
   ResetToy();
   LOG(FIT) << "Creating new toy dataset" << std::endl;
 
-  // Generate random Gaussian throws
+  // Correlated Gaussian throws come from the cached decomposition
+  const double* gausthrow = NULL;
+  if (fThrowType == kGausThrow) {
+    std::vector<int> bins;
+    for (int i = 0; i < fDataHist->GetNbinsX(); i++) bins.push_back(i + 1);
+    if (!fThrower.IsSetup(fCovar)) fThrower.Setup(fCovar, bins, 1.0);
+    gausthrow = fThrower.NextToy();
+  }
+
+  // Generate random flat throws
   std::vector<double> randthrows;
   for (int i = 0; i < fDataHist->GetNbinsX(); i++) {
     double randtemp = 0.0;
 
     switch (fThrowType) {
 
-    // Gaussian Throws
-    case kGausThrow:
-      randtemp = gRandom->Gaus(0.0, 1.0);
-      break;
-
     // Uniform Throws
     case kFlatThrow:
       randtemp = gRandom->Uniform(0.0, 1.0);
@@ -745,9 +798,7 @@ void ParamPull::ThrowCovariance() {
     double binmod  = 0.0;
 
     if (fThrowType == kGausThrow) {
-      for (int j = 0; j < fDataHist->GetNbinsX(); j++) {
-        binmod += (*fDecomp)(j, i) * randthrows.at(j);
-      }
+      binmod = gausthrow[i];
     } else if (fThrowType == kFlatThrow) {
       binmod = randthrows.at(i) - fDataHist->GetBinContent(i + 1);
     }
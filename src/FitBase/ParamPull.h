@@ -47,6 +47,8 @@
 // Fit Includes
 #include "PlotUtils.h"
 #include "StatUtils.h"
+#include "Chi2Evaluator.h"
+#include "MVNThrower.h"
 #include "FitWeight.h"
 #include "FitLogger.h"
 #include "EventManager.h"
@@ -102,6 +104,10 @@ class ParamPull {
   //! Get likelihood given the current values
   double GetLikelihood(void);
 
+  /// Add the derivative of GetLikelihood with respect to each RW dial to grad,
+  /// in the FitWeight dial order.
+  void AddLikelihoodGradient(double* grad);
+
   //! Get NDOF if used in likelihoods
   int GetNDOF(void);
   
@@ -178,6 +184,9 @@ class ParamPull {
     
   TMatrixDSym* fCovar;    //!< Covariance
   TMatrixDSym* fInvCovar; //!< Inverted Covariance
+  int fCovarGen;           //!< Bumped whenever fInvCovar is replaced
+  Chi2Evaluator fChi2Eval; //!< Cached chi2 setup for fInvCovar
+  MVNThrower fThrower;     //!< Cached decomposition of fCovar for toys
   TMatrixDSym* fDecomp;   //!< Decomposition
 
   TH1D* fLimitHist;
@@ -18,8 +18,7 @@ void StackBase::AddMode(std::string name, std::string title,
 
 void StackBase::FluxUnfold(TH1D* flux, TH1D* events, double scalefactor) {
 
-
-
+	FlushStack();
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		if (fNDim == 1) {
 			PlotUtils::FluxUnfoldedScaling((TH1D*) fAllHists[i], flux, events, scalefactor);
@@ -71,9 +70,18 @@ void StackBase::SetupStack(TH1* hist) {
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		fAllHists.push_back( (TH1*) fTemplate->Clone( (fName + "_" + fAllLabels[i]).c_str() ) );
 	}
+
+	// Category index doubles as the fill cache slot
+	fUseFillCache = (fNDim <= 2 and !fAllHists.empty() and
+	                 dynamic_cast<TArrayD*>(fTemplate));
+	if (fUseFillCache) {
+		fFillCache.Setup(fAllHists[0]);
+		for (size_t i = 1; i < fAllHists.size(); i++) fFillCache.Add(fAllHists[i]);
+	}
 };
 
 void StackBase::Scale(double sf, std::string opt) {
+	FlushStack();
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		// std::cout << "Scaling Stack Hist " << i << " by " << sf << std::endl;
 		fAllHists[i]->Scale(sf, opt.c_str());
@@ -81,6 +89,7 @@ void StackBase::Scale(double sf, std::string opt) {
 };
 
 void StackBase::Reset() {
+	if (fUseFillCache) fFillCache.Reset();
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		fAllHists[i]->Reset();
 	}
@@ -92,6 +101,12 @@ void StackBase::FillStack(int index, double x, double y, double z, double weight
 		return;
 	}
 
+	if (fUseFillCache) {
+		if (fNDim == 1) fFillCache.Fill(index, x, y);
+		else fFillCache.Fill(index, x, y, z);
+		return;
+	}
+
 	if (fNDim == 1)      fAllHists[index]->Fill(x, y);
 	else if (fNDim == 2) {
 		// std::cout << "Filling 2D Stack " << index << " " << x << " " << y << " " << z << std::endl;
@@ -101,7 +116,12 @@ void StackBase::FillStack(int index, double x, double y, double z, double weight
 	else if (fNDim == 3) ((TH3*)fAllHists[index])->Fill(x, y, z, weight);
 }
 
+void StackBase::FlushStack() {
+	if (fUseFillCache) fFillCache.Flush();
+}
+
 void StackBase::Write() {
+	FlushStack();
 	THStack* st = new THStack();
 
 	// Loop and add all histograms
@@ -131,24 +151,28 @@ void StackBase::Write() {
 };
 
 void StackBase::Multiply(TH1* hist) {
+	FlushStack();
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		fAllHists[i]->Multiply(hist);
 	}
 }
 
 void StackBase::Divide(TH1* hist) {
+	FlushStack();
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		fAllHists[i]->Divide(hist);
 	}
 }
 
 void StackBase::Add(TH1* hist, double scale) {
+	FlushStack();
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		fAllHists[i]->Add(hist, scale);
 	}
 }
 
 void StackBase::Add(StackBase* hist, double scale) {
+	FlushStack();
 
 	if (hist->GetType() != fType) {
 		ERR(WRN) << "Trying to add two StackBases of different types!" << std::endl;
@@ -163,10 +187,12 @@ void StackBase::Add(StackBase* hist, double scale) {
 }
 
 TH1* StackBase::GetHist(int entry) {
+	FlushStack();
 	return fAllHists[entry];
 }
 
 TH1* StackBase::GetHist(std::string label) {
+	FlushStack();
 
 	TH1* hist = NULL;
 	std::vector<std::string> splitlabels = GeneralUtils::ParseToStr(label, "+");
@@ -186,6 +212,7 @@ TH1* StackBase::GetHist(std::string label) {
 
 
 THStack StackBase::GetStack() {
+	FlushStack();
 	THStack st = THStack();
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		st.Add(fAllHists[i]);
@@ -195,11 +222,15 @@ THStack StackBase::GetStack() {
 
 
 void StackBase::AddNewHist(std::string name, TH1* hist) {
+	// New categories need not share the binning, fill them directly
+	FlushStack();
+	fUseFillCache = false;
 	AddMode( fAllLabels.size(), name, hist->GetTitle(), hist->GetLineColor());
 	fAllHists.push_back( (TH1*) hist->Clone() );
 }
 
 void StackBase::AddToCategory(std::string name, TH1* hist) {
+	FlushStack();
 
 	for (size_t i = 0; i < fAllLabels.size(); i++) {
 		if (name == fAllLabels[i]) {
@@ -211,6 +242,7 @@ void StackBase::AddToCategory(std::string name, TH1* hist) {
 }
 
 void StackBase::AddToCategory(int index, TH1* hist) {
+	FlushStack();
 	fAllHists[index]->Add(hist);
 }
 
@@ -12,10 +12,11 @@
 #include "TH3.h"
 
 #include "PlotUtils.h"
+#include "HistAccumulator.h"
 
 class StackBase {
 public:
-	StackBase() {};
+	StackBase() { fTemplate = NULL; fNDim = 0; fUseFillCache = false; };
 	~StackBase() {};
 
 	virtual void AddMode(std::string name, std::string title,
@@ -31,6 +32,7 @@ public:
 	virtual void FluxUnfold(TH1D* flux, TH1D* events, double scalefactor);
 	virtual void Reset();
 	virtual void FillStack(int index, double x, double y = 1.0, double z = 1.0, double weight = 1.0);
+	virtual void FlushStack();
 	virtual void Write();
 
 	virtual void Add(StackBase* hist, double scale);
@@ -63,6 +65,11 @@ public:
 	std::vector<std::string> fAllTitles;
 	std::vector<std::string> fAllLabels;
 	std::vector<TH1*> fAllHists;
+
+	// 1D/2D TH1D stacks fill one contiguous (category x bin) array, added
+	// into fAllHists by FlushStack before anything reads them.
+	HistAccumulator fFillCache;
+	bool fUseFillCache;
 };
 
 
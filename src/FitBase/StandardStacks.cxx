@@ -112,39 +112,20 @@ TrueModeStack::TrueModeStack(std::string name, std::string title, TH1* hist) {
 	StackBase::SetupStack(hist);
 };
 
-int TrueModeStack::ConvertModeToIndex(int mode) {
-	// std::cout << "Converting Mode " << (mode) << std::endl;
-	switch (abs(mode)) {
-	case 1:  return 0;  // CCQE
-	case 2:  return 1;  // CC2p2h
-	case 11: return 2;  // CC1piponp
-	case 12: return 3;  // CC1pi0onn
-	case 13: return 4;  // CC1piponn
-	case 16: return 5;  // CCcoh
-	case 17: return 6;  // CC1gamma
-	case 21: return 7;  // CCMultipi
-	case 22: return 8;  // CC1eta
-	case 23: return 9;  // CC1lamkp
-	case 26: return 10; // CCDIS
+// Category of each |mode| up to NC 2p2h, anything else is Undefined (27)
+static const int kTrueModeIndex[54] = {
+	27,  0,  1, 27, 27, 27, 27, 27, 27, 27, //  0-9:  CCQE, CC2p2h
+	27,  2,  3,  4, 27, 27,  5,  6, 27, 27, // 10-19: CC1pi, CCcoh, CC1gamma
+	27,  7,  8,  9, 27, 27, 10, 27, 27, 27, // 20-29: CCMultipi, CC1eta, CC1lamkp, CCDIS
+	27, 11, 12, 13, 14, 27, 15, 27, 16, 17, // 30-39: NC1pi, NCcoh, NC1gamma
+	27, 18, 19, 20, 21, 22, 23, 27, 27, 27, // 40-49: NCMultipi, NC1eta, NC1kamk0, NC1lamkp, NCDIS
+	27, 24, 25, 26                          // 50-53: NCEL on p/n, NC 2p2h
+};
 
-	case 31: return 11; // NC1pi0onn
-	case 32: return 12; // NC1pi0onp
-	case 33: return 13; // NC1pimonn
-	case 34: return 14; // NC1piponp
-	case 36: return 15; // NCcoh
-	case 38: return 16; // NC1gammaonn
-	case 39: return 17; // NC1gammaonp
-	case 41: return 18; // NC Multipi
-	case 42: return 19; // NC1etaonn
-	case 43: return 20; // NC1etaonp
-	case 44: return 21; // NC1kamk0
-	case 45: return 22; // NC1lamkp
-	case 46: return 23; // NCDIS
-	case 51: return 24; // NCEL on p
-	case 52: return 25; // NCEL on n
-	case 53: return 26; // NC 2p2h
-	default: return 27; // Undefined
-	}
+int TrueModeStack::ConvertModeToIndex(int mode) {
+	int absmode = abs(mode);
+	if (absmode >= 54) return 27; // Undefined
+	return kTrueModeIndex[absmode];
 };
 
 void TrueModeStack::Fill(int mode, double x, double y, double z, double weight) {
@@ -33,6 +33,7 @@ BaseFitEvt::BaseFitEvt() {
   SavedRWWeight = 1.0;
 
   fSplineCoeff = NULL;
+  fSplineMask = NULL;
   fSplineRead = NULL;
 
   fGenInfo = NULL;
@@ -98,6 +99,7 @@ BaseFitEvt::BaseFitEvt(const BaseFitEvt* obj) {
   SavedRWWeight = obj->SavedRWWeight;
 
   fSplineCoeff = obj->fSplineCoeff;
+  fSplineMask = obj->fSplineMask;
   fSplineRead = obj->fSplineRead;
 
   fGenInfo = obj->fGenInfo;
@@ -136,6 +138,7 @@ BaseFitEvt::BaseFitEvt(BaseFitEvt const& other) {
   SavedRWWeight = other.SavedRWWeight;
 
   fSplineCoeff = other.fSplineCoeff;
+  fSplineMask = other.fSplineMask;
   fSplineRead = other.fSplineRead;
 
   fGenInfo = other.fGenInfo;
@@ -178,6 +181,7 @@ BaseFitEvt BaseFitEvt::operator=(BaseFitEvt const& other) {
   SavedRWWeight = other.SavedRWWeight;
 
   fSplineCoeff = other.fSplineCoeff;
+  fSplineMask = other.fSplineMask;
   fSplineRead = other.fSplineRead;
 
   fGenInfo = other.fGenInfo;
@@ -88,6 +88,7 @@ class BaseFitEvt {
 
   // Spline Info Coefficients and Readers
   float* fSplineCoeff; ///< ND Array of Spline Coefficients
+  UInt_t* fSplineMask; ///< Spline response bitmask. If set fSplineCoeff is packed.
   SplineReader* fSplineRead; ///< Spline Interpretter
 
   // Generator Info
@@ -22,6 +22,7 @@
 
 FitEvent::FitEvent() {
   fGenInfo = NULL;
+  fPreselected = true;
   kRemoveFSIParticles = true;
   kRemoveUndefParticles = true;
 
@@ -120,6 +121,8 @@ void FitEvent::ResetEvent() {
   fTargetH = -1;
   fBound = false;
   fNParticles = 0;
+  fPreselected = true;
+  ClearMemo();
 
   if (fGenInfo) fGenInfo->Reset();
 
@@ -146,6 +149,9 @@ void FitEvent::ResetEvent() {
 }
 
 void FitEvent::OrderStack() {
+  // Stack indices change so memoised results no longer apply
+  ClearMemo();
+
   // Copy current stack
   int npart = fNParticles;
 
@@ -195,6 +201,33 @@ void FitEvent::OrderStack() {
   return;
 }
 
+bool FitEvent::GetMemo(int key, double& value, double a0, double a1,
+                       double a2, double a3) const {
+  for (size_t i = 0; i < fMemo.size(); i++) {
+    const EventMemoEntry& memo = fMemo[i];
+    if (memo.key != key or memo.args[0] != a0 or memo.args[1] != a1 or
+        memo.args[2] != a2 or memo.args[3] != a3) {
+      continue;
+    }
+    value = memo.value;
+    return true;
+  }
+  return false;
+}
+
+double FitEvent::SetMemo(int key, double value, double a0, double a1,
+                         double a2, double a3) {
+  EventMemoEntry memo;
+  memo.key = key;
+  memo.args[0] = a0;
+  memo.args[1] = a1;
+  memo.args[2] = a2;
+  memo.args[3] = a3;
+  memo.value = value;
+  fMemo.push_back(memo);
+  return value;
+}
+
 void FitEvent::Print() {
   if (LOG_LEVEL(FIT)) {
     LOG(FIT) << "FITEvent print" << std::endl;
@@ -38,6 +38,32 @@
 
 #include "PhysConst.h"
 
+/// Helpers whose per event results are shared between samples through
+/// FitEvent::GetMemo and FitEvent::SetMemo.
+enum EventMemoKey {
+  kMemoCCINC = 0,
+  kMemoNCINC,
+  kMemoCC0pi,
+  kMemoNC0pi,
+  kMemoCC1pi,
+  kMemoNC1pi,
+  kMemoProtonKEAboveThreshold,
+  kMemoProtonMomAboveThreshold,
+  kMemoErecoilTRUE,
+  kMemoErecoilCHARGED,
+  kMemoErecoilMINERvALowRecoil,
+  kMemoSTVdpt,
+  kMemoSTVdphit,
+  kMemoSTVdalphat
+};
+
+/// One memoised helper result, keyed by helper and arguments
+struct EventMemoEntry {
+  int key;
+  double args[4];
+  double value;
+};
+
 /// Common container for event particles
 class FitEvent : public BaseFitEvt {
 public:
@@ -60,6 +86,17 @@ public:
   void ExpandParticleStack(int stacksize);
   void AddGeneratorInfo(GeneratorInfoBase* gen);
 
+  // ---- PER EVENT MEMO ---- //
+  /// Get a helper result stored by an earlier caller for this event.
+  /// Returns false if the helper has not been evaluated with these arguments.
+  bool GetMemo(int key, double& value, double a0 = 0.0, double a1 = 0.0,
+               double a2 = 0.0, double a3 = 0.0) const;
+  /// Store a helper result for this event and return it.
+  double SetMemo(int key, double value, double a0 = 0.0, double a1 = 0.0,
+                 double a2 = 0.0, double a3 = 0.0);
+  /// Forget all memoised results. Called whenever the particle stack changes.
+  inline void ClearMemo(void) { fMemo.clear(); };
+
 
   // ---- HELPER/ACCESS FUNCTIONS ---- //
   /// Return True Interaction ID
@@ -95,6 +132,7 @@ public:
   /// Allows the removal of KE up to total KE.
   inline void RemoveKE(int index, double KE){
 
+    ClearMemo();
     FitParticle *fp = GetParticle(index);
 
     double mass = fp->M();
@@ -608,6 +646,7 @@ public:
   bool fBound;
   int fDistance;
   int fTargetPDG;
+  bool fPreselected;  ///< False if the input preselection left the stack empty
 
   // Reduced Particle Stack
   UInt_t kMaxParticles;
@@ -629,6 +668,9 @@ public:
   bool kRemoveFSIParticles;
   bool kRemoveUndefParticles;
 
+  /// Helper results for the current particle stack
+  std::vector<EventMemoEntry> fMemo;
+
 
 
 };
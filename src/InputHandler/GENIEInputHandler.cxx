@@ -184,9 +184,16 @@ FitEvent* GENIEInputHandler::GetNuisanceEvent(const UInt_t entry,
   // Read Entry from TTree to fill NEUT Vect in BaseFitEvt;
   fGENIETree->GetEntry(entry);
 
-  // Run NUISANCE Vector Filler
+  // Run NUISANCE Vector Filler, skipped for events no user can accept
   if (!lightweight) {
-    CalcNUISANCEKinematics();
+    GHepRecord* ghep =
+        fGenieNtpl ? static_cast<GHepRecord*>(fGenieNtpl->event) : NULL;
+    GHepParticle* nu = ghep ? ghep->Probe() : NULL;
+    if (!nu or !fUsePreselection or
+        PreselectEvent(nu->Pdg(), nu->E() * 1.E3,
+                       ConvertGENIEReactionCode(ghep))) {
+      CalcNUISANCEKinematics();
+    }
   }
 #ifdef __PROB3PP_ENABLED__
   else {
@@ -19,6 +19,9 @@
 #include "InputHandler.h"
 #include "InputUtils.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 InputHandlerBase::InputHandlerBase() {
   fName = "";
   fFluxHist = NULL;
@@ -31,6 +34,7 @@ InputHandlerBase::InputHandlerBase() {
   kRemoveNuclearParticles = FitPar::Config().GetParB("RemoveNuclearParticles");
   fMaxEvents = FitPar::Config().GetParI("MAXEVENTS");
   fTTreePerformance = NULL;
+  fUsePreselection = false;
 };
 
 InputHandlerBase::~InputHandlerBase() {
@@ -53,6 +57,83 @@ InputHandlerBase::~InputHandlerBase() {
 
 void InputHandlerBase::Print(){};
 
+InputPreselection::InputPreselection() {
+  fEnuMin = 0.0;
+  fEnuMax = 0.0;
+  fCC = true;
+  fNC = true;
+};
+
+bool InputPreselection::IsSet() const {
+  return !fNuPDG.empty() or fEnuMax > fEnuMin or !fCC or !fNC;
+};
+
+bool InputPreselection::Accept(int nupdg, double enu, int mode) const {
+  if (!fNuPDG.empty() and
+      std::find(fNuPDG.begin(), fNuPDG.end(), nupdg) == fNuPDG.end()) {
+    return false;
+  }
+
+  // Same CC/NC split as FitEvent::IsCC
+  bool cc = (abs(mode) <= 30);
+  if ((cc and !fCC) or (!cc and !fNC)) return false;
+
+  if (fEnuMax > fEnuMin and (enu < fEnuMin or enu > fEnuMax)) return false;
+  return true;
+};
+
+void InputHandlerBase::SetPreselection(const void* user,
+                                       const InputPreselection& cuts) {
+  fPreselections[user] = cuts;
+  fPreselectionChecked.erase(user);
+  UpdatePreselection();
+};
+
+void InputHandlerBase::RemovePreselection(const void* user) {
+  fPreselections.erase(user);
+  fPreselectionChecked.erase(user);
+  UpdatePreselection();
+};
+
+void InputHandlerBase::SetPreselectionChecked(const void* user) {
+  if (!fPreselections.count(user) or fPreselectionChecked.count(user)) return;
+  fPreselectionChecked.insert(user);
+  UpdatePreselection();
+};
+
+void InputHandlerBase::UpdatePreselection() {
+  // Any user without cuts, or whose cuts are unchecked, needs every event
+  fUsePreselection = !fPreselections.empty() and
+                     FitPar::Config().GetParB("input_preselection");
+  for (std::map<const void*, InputPreselection>::iterator iter =
+           fPreselections.begin();
+       iter != fPreselections.end(); iter++) {
+    if (!(*iter).second.IsSet()) fUsePreselection = false;
+    if (!fPreselectionChecked.count((*iter).first)) fUsePreselection = false;
+  }
+};
+
+bool InputHandlerBase::PassesPreselection(int nupdg, double enu,
+                                          int mode) const {
+  for (std::map<const void*, InputPreselection>::const_iterator iter =
+           fPreselections.begin();
+       iter != fPreselections.end(); iter++) {
+    if ((*iter).second.Accept(nupdg, enu, mode)) return true;
+  }
+  return fPreselections.empty();
+};
+
+bool InputHandlerBase::PreselectEvent(int nupdg, double enu, int mode) {
+  if (!fUsePreselection or PassesPreselection(nupdg, enu, mode)) return true;
+
+  fNUISANCEEvent->ResetEvent();
+  fNUISANCEEvent->Mode = mode;
+  fNUISANCEEvent->probe_E = enu;
+  fNUISANCEEvent->probe_pdg = nupdg;
+  fNUISANCEEvent->fPreselected = false;
+  return false;
+};
+
 TH1D* InputHandlerBase::GetXSecHistogram(void) {
   fXSecHist = (TH1D*)fFluxHist->Clone();
   fXSecHist->Divide(fEventHist);
@@ -27,6 +27,30 @@
 #include "BaseFitEvt.h"
 #include "TTreePerfStats.h"
 
+#include <map>
+#include <set>
+#include <vector>
+
+/// Coarse cuts on the generator record that every signal event of a sample
+/// passes. Default constructed cuts accept every event.
+class InputPreselection {
+public:
+
+  InputPreselection();
+
+  /// Whether any cut is applied
+  bool IsSet() const;
+
+  /// Check an event from its incoming neutrino PDG, energy (MeV) and mode
+  bool Accept(int nupdg, double enu, int mode) const;
+
+  std::vector<int> fNuPDG;  ///< Allowed incoming PDGs, empty for any
+  double fEnuMin;  ///< Lowest incoming energy kept (MeV), inclusive
+  double fEnuMax;  ///< Highest incoming energy kept (MeV), no cut if <= fEnuMin
+  bool fCC;        ///< Keep charged current modes
+  bool fNC;        ///< Keep neutral current modes
+};
+
 /// Base InputHandler class defining how events are requested and setup.
 class InputHandlerBase {
 public:
@@ -113,6 +137,28 @@ public:
                              std::string intOpt = "");
 
 
+  /// Set the preselection of one user of this input. Every user is
+  /// registered with default cuts when it is setup, so events are only left
+  /// undecoded once all users sharing the input have declared their cuts.
+  void SetPreselection(const void* user, const InputPreselection& cuts);
+
+  /// Drop a user's cuts, called when the user is deleted
+  void RemovePreselection(const void* user);
+
+  /// Mark that a user has seen every event since declaring its cuts, so
+  /// they have been checked against its signal. Events are only left
+  /// undecoded once all users are checked.
+  void SetPreselectionChecked(const void* user);
+
+  /// Whether any registered user accepts the event
+  bool PassesPreselection(int nupdg, double enu, int mode) const;
+
+  /// Called by handlers before decoding a full event. If no user can accept
+  /// it the NUISANCE event is reset to its header, marked as not
+  /// preselected, and false is returned.
+  bool PreselectEvent(int nupdg, double enu, int mode);
+
+
   /// Actual data members.
   std::vector<TH1D*> jointfluxinputs;
   std::vector<TH1D*> jointeventinputs;
@@ -139,6 +185,13 @@ public:
   bool kRemoveNuclearParticles;
   TTreePerfStats* fTTreePerformance;
 
+  std::map<const void*, InputPreselection> fPreselections;  ///< Cuts per user
+  std::set<const void*> fPreselectionChecked;  ///< Users whose cuts are checked
+  bool fUsePreselection;  ///< All users declared cuts and input_preselection set
+
+private:
+  /// Recompute fUsePreselection from the registered users
+  void UpdatePreselection();
 
 };
 /*! @} */
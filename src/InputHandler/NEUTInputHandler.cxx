@@ -155,9 +155,12 @@ FitEvent* NEUTInputHandler::GetNuisanceEvent(const UInt_t entry,
   // Read Entry from TTree to fill NEUT Vect in BaseFitEvt;
   fNEUTTree->GetEntry(entry);
 
-  // Run NUISANCE Vector Filler
+  // Run NUISANCE Vector Filler, skipped for events no user can accept
   if (!lightweight) {
-    CalcNUISANCEKinematics();
+    NeutPart* nu = fNeutVect->Npart() ? fNeutVect->PartInfo(0) : NULL;
+    if (!nu or PreselectEvent(nu->fPID, nu->fP.E(), fNeutVect->Mode)) {
+      CalcNUISANCEKinematics();
+    }
   }
 #ifdef __PROB3PP_ENABLED__
   else {
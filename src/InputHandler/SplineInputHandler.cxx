@@ -56,8 +56,20 @@ SplineInputHandler::SplineInputHandler(std::string const& handle, std::string co
 
 	// Setup Matching Spline TTree
 	fSplTree = (TTree*)inp_file->Get("spline_tree");
-	fSplTree->SetBranchAddress( "SplineCoeff", fSplineCoeff );
-	fNUISANCEEvent->fSplineCoeff = this->fSplineCoeff;
+
+	// Packed trees carry a response mask and only the non-zero blocks
+	fSplPacker = new SplineCoeffPacker();
+	fSplPacker->Setup(fSplRead->GetNParList(), SplineUtils::kDenseCoeff);
+	if (fSplPacker->SetBranchAddresses(fSplTree)) {
+		LOG(SAM) << "Reading packed spline coefficients." << std::endl;
+		fNUISANCEEvent->fSplineMask = fSplPacker->fMask;
+		fNUISANCEEvent->fSplineCoeff = fSplPacker->fPacked;
+	} else {
+		delete fSplPacker;
+		fSplPacker = NULL;
+		fSplTree->SetBranchAddress( "SplineCoeff", fSplineCoeff );
+		fNUISANCEEvent->fSplineCoeff = this->fSplineCoeff;
+	}
 
 	// Load into memory
 	for (int j = 0; j < fNEvents; j++) {
@@ -72,6 +84,7 @@ SplineInputHandler::~SplineInputHandler() {
 	if (fFitEventTree) delete fFitEventTree;
 	if (fSplTree) delete fSplTree;
 	if (fSplRead) delete fSplRead;
+	if (fSplPacker) delete fSplPacker;
 	fStartingWeights.clear();
 }
 
@@ -112,7 +125,12 @@ FitEvent* SplineInputHandler::GetNuisanceEvent(const UInt_t entry, const bool li
 
 	// Get Spline Coefficients
 	fSplTree->GetEntry(entry);
-	fNUISANCEEvent->fSplineCoeff = fSplineCoeff;
+	if (fSplPacker) {
+		fNUISANCEEvent->fSplineMask = fSplPacker->fMask;
+		fNUISANCEEvent->fSplineCoeff = fSplPacker->GetPacked();
+	} else {
+		fNUISANCEEvent->fSplineCoeff = fSplineCoeff;
+	}
 
 	// Setup Input scaling for joint inputs
 	fNUISANCEEvent->InputWeight = fStartingWeights[entry];
@@ -4,6 +4,7 @@
 #include "InputHandler.h"
 #include "FitEvent.h"
 #include "PlotUtils.h"
+#include "SplineCoeffPacker.h"
 
 /// Spline InputHandler. Almost functionally identical to FitEventInputHandler
 /// with an extension to handle the spline co-efficients.
@@ -34,6 +35,7 @@ public:
 	TTree* fSplTree;	     ///< Main Spline Coefficient Tree
 	SplineReader* fSplRead;  ///< Spline Reader Object used to interpret splines
 	float fSplineCoeff[1000];///< Coefficients. Currently a hardcoded limit of 1000.
+	SplineCoeffPacker* fSplPacker; ///< Packed coefficient reader, NULL for dense trees
 
 	/// Starting RW Input Weights corresponding to nominal spline weight
 	std::vector<float> fStartingWeights;
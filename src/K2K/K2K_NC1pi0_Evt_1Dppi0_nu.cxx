@@ -43,6 +43,7 @@ K2K_NC1pi0_Evt_1Dppi0_nu::K2K_NC1pi0_Evt_1Dppi0_nu(nuiskey samplekey){
   fSettings.SetDataInput(  FitPar::GetDataBase() + "K2K/nc1pi0/ppi0.csv");
 
   FinaliseSampleSettings();
+  SetPreselection(14, false, true);
 
   // Plot Setup -------------------------------------------------------
   SetDataFromTextFile( fSettings.GetDataInput() );
@@ -64,12 +64,18 @@ bool LOGGING(int level) {
 
 int __GETLOG_LEVEL(int level, const char* filename, const char* funct) {
 #ifdef __DEBUG__
-  int logfile = FitPar::Config().GetParI("logging." + std::string(filename));
+  // Read from the config snapshot, this is called for every LOG statement
+  const std::map<std::string, int>& overrides = Config::GetSnapshot().logging;
+  std::map<std::string, int>::const_iterator iter;
+
+  iter = overrides.find("logging." + std::string(filename));
+  int logfile = (iter != overrides.end()) ? iter->second : 0;
   if (logfile >= DEB and logfile <= EVT) {
     level = logfile;
   }
 
-  int logfunc = FitPar::Config().GetParI("logging." + std::string(funct));
+  iter = overrides.find("logging." + std::string(funct));
+  int logfunc = (iter != overrides.end()) ? iter->second : 0;
   if (logfunc >= DEB and logfunc <= EVT) {
     level = logfunc;
   }
@@ -53,8 +53,10 @@ MCStudy_CCQEHistograms::MCStudy_CCQEHistograms(std::string name, std::string inp
   this->fDataHist = new TH1D(("approximate_data"), ("kaon_data"), 5, 1.0, 6.0);
 
   this->SetupDefaultHist();
+
   fFullCovar = StatUtils::MakeDiagonalCovarMatrix(fDataHist);
   covar = StatUtils::GetInvert(fFullCovar);
+  fFitPhaseSafe = false;
 
   // 1. The generator is organised in SetupMeasurement so it gives the
   // cross-section in "per nucleon" units.
@@ -217,6 +217,7 @@ OfficialNIWGPlots::OfficialNIWGPlots(nuiskey samplekey) {
 
 	// Final setup  ---------------------------------------------------
 	FinaliseMeasurement();
+	fFitPhaseSafe = false;
 
 };
 
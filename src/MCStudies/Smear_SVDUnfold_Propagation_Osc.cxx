@@ -485,6 +485,9 @@ Smear_SVDUnfold_Propagation_Osc::Smear_SVDUnfold_Propagation_Osc(
   fSettings = LoadSampleSettings(samplekey);
 
   fSettings.SetTitle("Osc Studies");
+
+  // ConvertEventRates reads the global oscillation engine
+  fThreadSafe = false;
   fSettings.SetDescription(descrip);
   fSettings.SetXTitle("XXX");
   fSettings.SetYTitle("Number of events");
@@ -546,6 +549,7 @@ Smear_SVDUnfold_Propagation_Osc::Smear_SVDUnfold_Propagation_Osc(
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fFitPhaseSafe = false;
 };
 
 void Smear_SVDUnfold_Propagation_Osc::FillEventVariables(FitEvent *event){};
@@ -159,6 +159,7 @@ Smearceptance_Tester::Smearceptance_Tester(nuiskey samplekey) {
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fFitPhaseSafe = false;
 }
 
 void Smearceptance_Tester::AddEventVariablesToTree() {
@@ -102,6 +102,7 @@ T2K2017_FakeData::T2K2017_FakeData(nuiskey samplekey) {
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fFitPhaseSafe = false;
 
 };
 
@@ -47,6 +47,7 @@ MINERvA_CCCOHPI_XSec_1DEpi_antinu::MINERvA_CCCOHPI_XSec_1DEpi_antinu(nuiskey sam
   fSettings.SetCovarInput(GeneralUtils::GetTopLevelDir() + "/data/MINERvA/CCcoh/Epi_nubar_cov.csv");
 			   
   FinaliseSampleSettings();
+  SetPreselection(-14);
 
   // Scaling Setup ---------------------------------------------------
   // ScaleFactor automatically setup for DiffXSec/cm2/Nucleon
@@ -58,6 +59,8 @@ MINERvA_CCCOHPI_XSec_1DEpi_antinu::MINERvA_CCCOHPI_XSec_1DEpi_antinu(nuiskey sam
 
   // Final setup  ---------------------------------------------------
   FinaliseMeasurement();
+  fThreadSafe = true;
+  fSingleBinFill = true;
 
 };
 
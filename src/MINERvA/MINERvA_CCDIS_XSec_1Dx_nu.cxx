@@ -47,6 +47,7 @@ MINERvA_CCDIS_XSec_1Dx_nu::MINERvA_CCDIS_XSec_1Dx_nu(std::string name, std::stri
   if (target == "") ERR(WRN) << "target " << target << " was not found!" << std::endl;
 
   FinaliseSampleSettings();
+  SetPreselection(14);
 
   // Scaling Setup ---------------------------------------------------
   // ScaleFactor automatically setup for DiffXSec/cm2/Nucleon
@@ -57,6 +58,7 @@ MINERvA_CCDIS_XSec_1Dx_nu::MINERvA_CCDIS_XSec_1Dx_nu(std::string name, std::stri
   CreateDataHistogram(5, binsx);
 
   FinaliseMeasurement();
+  fFitPhaseSafe = false;
 
 };
 
@@ -210,6 +210,14 @@ double FitWeight::CalcWeight(BaseFitEvt* evt) {
   return rwweight;
 }
 
+bool FitWeight::IsThreadSafe() {
+  for (std::map<int, WeightEngineBase*>::iterator iter = fAllRW.begin();
+       iter != fAllRW.end(); iter++) {
+    if (!(*iter).second->IsThreadSafe()) return false;
+  }
+  return true;
+}
+
 void FitWeight::UpdateWeightEngine(const double* x) {
   size_t count = 0;
   for (std::vector<int>::iterator iter = fEnumList.begin();
@@ -36,6 +36,7 @@ public:
   bool DialIncluded(int rwenum);
 
   double CalcWeight(BaseFitEvt* evt);
+  bool IsThreadSafe();
   bool HasRWDialChanged(const double* x) { return true; };
   // bool NeedsEventReWeight(const double* x);
 
@@ -45,6 +45,7 @@ class ModeNormEngine : public WeightEngineBase {
     return fDialValues[fDialEnumIndex[mode]];
   };
   bool NeedsEventReWeight() { return false; };
+  bool IsThreadSafe() { return true; };
 
   double GetDialValue(std::string name) {
     int rwenum = Reweight::ConvDial(name, kMODENORM);
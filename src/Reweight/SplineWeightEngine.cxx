@@ -79,7 +79,12 @@ double SplineWeightEngine::CalcWeight(BaseFitEvt* evt) {
     evt->fSplineRead->Reconfigure(fSplineValueMap);
   }
 
-  double rw_weight = evt->fSplineRead->CalcWeight( evt->fSplineCoeff );
+  double rw_weight = 1.0;
+  if (evt->fSplineMask) {
+    rw_weight = evt->fSplineRead->CalcWeight( evt->fSplineMask, evt->fSplineCoeff );
+  } else {
+    rw_weight = evt->fSplineRead->CalcWeight( evt->fSplineCoeff );
+  }
   if (rw_weight < 0.0) rw_weight = 0.0;
 
   return rw_weight;
@@ -39,6 +39,9 @@ class WeightEngineBase {
   virtual double CalcWeight(BaseFitEvt* evt) { return 1.0; };
   virtual bool NeedsEventReWeight() = 0;
 
+  // Whether CalcWeight can be called for events of different inputs at once
+  virtual bool IsThreadSafe() { return false; };
+
   bool fHasChanged;
   bool fIsAbsTwk;
 
@@ -53,6 +53,8 @@ void MinimizerRoutines::Init() {
   fMinimizer = NULL;
   fMinimizerFCN = NULL;
   fCallFunctor = NULL;
+  fGradFCN = NULL;
+  fGradChecked = false;
 
   fAllowedRoutines =
       ("Migrad,Simplex,Combined,"
@@ -365,11 +367,94 @@ void MinimizerRoutines::SetupFCN() {
   fMinimizerFCN = new MinimizerFCN(fSampleFCN);
   fCallFunctor = new ROOT::Math::Functor(*fMinimizerFCN, fParams.size());
 
+  // Gradient support is checked against the new FCN when first needed
+  if (fGradFCN) delete fGradFCN;
+  fGradFCN = NULL;
+  fGradChecked = false;
+
   fSampleFCN->CreateIterationTree("fit_iterations", FitBase::GetRW());
 
+  FixProfiledNorms();
+
   return;
 }
 
+//*************************************
+void MinimizerRoutines::FixProfiledNorms() {
+//*************************************
+
+  std::list<MeasurementBase*> samples = fSampleFCN->GetSampleList();
+  for (std::list<MeasurementBase*>::iterator iter = samples.begin();
+       iter != samples.end(); iter++) {
+    MeasurementBase* exp = *iter;
+    std::string normname = exp->GetName() + "_norm";
+
+    if (!exp->IsNormProfiled() or fFixVals.find(normname) == fFixVals.end()) {
+      continue;
+    }
+
+    LOG(FIT) << "Profiling " << normname << " in the likelihood" << std::endl;
+    fFixVals[normname] = true;
+  }
+}
+
+//*************************************
+void MinimizerRoutines::UpdateProfiledNorms() {
+//*************************************
+
+  std::list<MeasurementBase*> samples = fSampleFCN->GetSampleList();
+  std::list<MeasurementBase*>::iterator iter;
+
+  bool profiled = false;
+  for (iter = samples.begin(); iter != samples.end(); iter++) {
+    if ((*iter)->IsNormProfiled()) profiled = true;
+  }
+  if (!profiled or fParams.empty()) return;
+
+  // Profile at the current values, outside DoEval so no iteration is logged
+  UpdateRWEngine(fCurVals);
+  fSampleFCN->ReconfigureAllEvents();
+  fSampleFCN->GetLikelihood();
+
+  for (iter = samples.begin(); iter != samples.end(); iter++) {
+    MeasurementBase* exp = *iter;
+    std::string normname = exp->GetName() + "_norm";
+    if (!exp->IsNormProfiled() or fCurVals.find(normname) == fCurVals.end()) {
+      continue;
+    }
+
+    fCurVals[normname] = exp->GetProfiledNorm();
+    fErrorVals[normname] = 0.0;
+  }
+}
+
+//*************************************
+ROOT::Math::IMultiGenFunction* MinimizerRoutines::GetCallFunction() {
+//*************************************
+
+  if (!fGradChecked) {
+    fGradChecked = true;
+
+    if (FitPar::Config().GetParB("analytic_gradient") and !fParams.empty() and
+        fSampleFCN->SetupGradient()) {
+
+      std::vector<double> vals;
+      for (UInt_t i = 0; i < fParams.size(); i++) {
+        vals.push_back(fCurVals[fParams[i]]);
+      }
+
+      double tol = FitPar::Config().GetParD("analytic_gradient_tolerance");
+      if (fSampleFCN->CheckGradient(&vals[0], tol)) {
+        LOG(FIT) << "Using analytic likelihood gradient." << std::endl;
+        fGradFCN = new MinimizerGradFCN(fSampleFCN, fParams.size());
+      }
+    }
+  }
+
+  if (fGradFCN) return fGradFCN;
+  return fCallFunctor;
+}
+
 //******************************************
 void MinimizerRoutines::SetupFitter(std::string routine) {
   //******************************************
@@ -440,7 +525,7 @@ void MinimizerRoutines::SetupFitter(std::string routine) {
       FitPar::Config().GetParI("MAXITERATIONS"));
   fMinimizer->SetTolerance(FitPar::Config().GetParD("TOLERANCE"));
   fMinimizer->SetStrategy(FitPar::Config().GetParI("STRATEGY"));
-  fMinimizer->SetFunction(*fCallFunctor);
+  fMinimizer->SetFunction(*GetCallFunction());
 
   int ipar = 0;
   // Add Fit Parameters
@@ -700,6 +785,7 @@ void MinimizerRoutines::GetMinimizerState() {
     fErrorVals[syst] = errors[i];
   }
 
+  UpdateProfiledNorms();
   PrintState();
 
   // Covar
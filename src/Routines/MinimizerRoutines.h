@@ -124,6 +124,10 @@ void SetupMinimizerFromXML();
   //! Sets up the minimizerObj for ROOT. there are cases where this is called repeatedly, e.g. If you are using a brute force scan before using Migrad.
   void SetupFitter(std::string routine);
 
+  //! Function handed to the minimizer. Uses the analytic gradient if every
+  //! sample and pull supports it and it passes the finite difference check.
+  ROOT::Math::IMultiGenFunction* GetCallFunction();
+
   //! Set the current data histograms in each sample to the fake data.
   void SetFakeData();
 
@@ -147,6 +151,12 @@ void SetupMinimizerFromXML();
   //! Get the current state of minimizerObj and fill it into currentVals and currentNorms
   void GetMinimizerState();
 
+  //! Fix norm dials of samples that profile their normalisation in the likelihood
+  void FixProfiledNorms();
+
+  //! Copy profiled sample norms at the current point into currentVals
+  void UpdateProfiledNorms();
+
   //! Print current value
   void PrintState();
   
@@ -223,6 +233,8 @@ protected:
   JointFCN* fSampleFCN;
   MinimizerFCN* fMinimizerFCN;
   ROOT::Math::Functor* fCallFunctor;
+  MinimizerGradFCN* fGradFCN;
+  bool fGradChecked;
 
   int nfreepars;
 
@@ -18,6 +18,15 @@
 *******************************************************************************/
 #include "SplineRoutines.h"
 
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
 void SplineRoutines::Init() {
 
   fStrategy = "SaveEvents";
@@ -60,6 +69,12 @@ SplineRoutines::SplineRoutines(int argc, char* argv[]) {
   ParserUtils::ParseCounter(args, "v", verbocount);
   ParserUtils::CheckBadArguments(args);
 
+  // Keep what is needed to relaunch ourselves as a chunk worker
+  fExecutable = argv[0];
+  fMaxEvents  = maxevents;
+  fConfigArgs = configargs;
+  fXMLCmds    = xmlcmds;
+
   // Add extra defaults if none given
   if (fCardFile.empty() and xmlcmds.empty()) {
     ERR(FTL) << "No input supplied!" << std::endl;
@@ -201,6 +216,10 @@ void SplineRoutines::Run() {
       BuildEventSplines(chunk);
     } else if (!rout.compare("MergeEventSplinesChunks")) {
       MergeEventSplinesChunks();
+    } else if (!rout.compare("GenerateEventSplinesParallel")) {
+      GenerateEventSplinesParallel();
+    } else if (!rout.compare("GenerateEventSplineChunk")) {
+      GenerateEventSplineChunk(FitPar::Config().GetParI("spline_procchunk"));
     }
   }
 
@@ -1117,8 +1136,8 @@ void SplineRoutines::BuildEventSplines(int procchunk) {
     outputfile->cd();
     TTree* splinetree = new TTree("spline_tree", "spline_tree");
 
-    float* coeff = new float[npar];
-    splinetree->Branch("SplineCoeff", coeff, Form("SplineCoeff[%d]/F", npar));
+    float* coeff = splwrite->fCoEffStorer;
+    splwrite->AddCoefficientsToTree(splinetree);
 
 
     // Load N Chunks of the Weights into Memory
@@ -1188,6 +1207,7 @@ void SplineRoutines::BuildEventSplines(int procchunk) {
           coeff[l] = allcoeff[k][l];
         }
         // std::cout << "Coeff 0, 1, 2 = " << coeff[0] << " " << coeff[1] << " " << coeff[2] << std::endl;
+        splwrite->PackCoefficients();
         splinetree->Fill();
       }
 
@@ -1202,6 +1222,7 @@ void SplineRoutines::BuildEventSplines(int procchunk) {
     // Save flux and close file
     outputfile->cd();
     splinetree->Write();
+    splwrite->fPacker.PrintSummary();
 
 
     if (procchunk == -1 or procchunk == 0) {
@@ -1291,8 +1312,8 @@ void SplineRoutines::MergeEventSplinesChunks() {
     outputfile->cd();
     TTree* splinetree = new TTree("spline_tree", "spline_tree");
 
-    float* coeff = new float[npar];
-    splinetree->Branch("SplineCoeff", coeff, Form("SplineCoeff[%d]/F", npar));
+    float* coeff = splwrite->fCoEffStorer;
+    splwrite->AddCoefficientsToTree(splinetree);
 
 
     // Load N Chunks of the Weights into Memory
@@ -1311,16 +1332,24 @@ void SplineRoutines::MergeEventSplinesChunks() {
       // Get TTree for spline coeffchunk
       TTree* splinetreechunk = (TTree*) chunkfile->Get("spline_tree");
 
-      // Set Branch Address to coeffchunk
+      // Set Branch Address to coeffchunk, chunks may be packed
       float* coeffchunk = new float[npar];
-      splinetreechunk->SetBranchAddress("SplineCoeff", coeffchunk);
+      SplineCoeffPacker chunkpacker;
+      chunkpacker.Setup(splwrite->GetNParList(), SplineUtils::kDenseCoeff);
+      bool packedchunk = chunkpacker.SetBranchAddresses(splinetreechunk);
+      if (!packedchunk) splinetreechunk->SetBranchAddress("SplineCoeff", coeffchunk);
 
       // Loop over nevents in chunk
       for (int k = 0; k < neventsinchunk; k++) {
         splinetreechunk->GetEntry(k);
-        for (int j = 0; j < npar; j++) {
-          coeff[j] = coeffchunk[j];
+        if (packedchunk) {
+          chunkpacker.Unpack(coeff);
+        } else {
+          for (int j = 0; j < npar; j++) {
+            coeff[j] = coeffchunk[j];
+          }
         }
+        splwrite->PackCoefficients();
         splinetree->Fill();
       }
 
@@ -1362,6 +1391,407 @@ void SplineRoutines::MergeEventSplinesChunks() {
 
 }
 
+//*************************************
+static std::string SplineChunkFileName(std::string const& dir, int ievtkey, int ichunk) {
+//*************************************
+  return dir + "/" + std::string(Form("events%d_chunk%d.root", ievtkey, ichunk));
+}
+
+//*************************************
+static std::string SplineChunkProgressName(std::string const& dir, int ichunk) {
+//*************************************
+  return dir + "/" + std::string(Form("chunk%d.progress", ichunk));
+}
+
+//*************************************
+static void WriteSplineChunkProgress(std::string const& name, long done, long total) {
+//*************************************
+  // Write to a temporary and rename so the driver never reads a partial line
+  std::string tmpname = name + ".tmp";
+  std::ofstream progfile(tmpname.c_str());
+  progfile << done << " " << total << std::endl;
+  progfile.close();
+  std::rename(tmpname.c_str(), name.c_str());
+}
+
+//*************************************
+void SplineRoutines::GenerateEventSplineChunk(int procchunk) {
+//*************************************
+
+  std::string chunkdir = FitPar::Config().GetParS("spline_chunkdir");
+  int nchunks = FitPar::Config().GetParI("spline_chunks");
+  if (nchunks <= 0) nchunks = 1;
+
+  if (chunkdir.empty() or procchunk < 0 or procchunk >= nchunks) {
+    THROW("GenerateEventSplineChunk needs spline_chunkdir and a spline_procchunk in [0,"
+          << nchunks << "). Got '" << chunkdir << "' and " << procchunk);
+  }
+
+  if (fRW) delete fRW;
+  SetupRWEngine();
+
+  // Setup the spline writer
+  SplineWriter* splwrite = new SplineWriter(fRW);
+  std::vector<nuiskey> splinekeys = Config::QueryKeys("spline");
+  for (std::vector<nuiskey>::iterator iter = splinekeys.begin();
+       iter != splinekeys.end(); iter++) {
+    splwrite->AddSpline(*iter);
+  }
+  splwrite->SetupSplineSet();
+
+  int nweights = splwrite->GetNWeights();
+  int npar = splwrite->GetNPars();
+  std::string progressname = SplineChunkProgressName(chunkdir, procchunk);
+
+  std::vector<nuiskey> eventkeys = Config::QueryKeys("events");
+
+  // Count the total work up front so progress covers every input
+  std::vector<InputHandlerBase*> inputs;
+  long totalwork = 0;
+  for (size_t i = 0; i < eventkeys.size(); i++) {
+    std::string inputfilename = eventkeys[i].GetS("input");
+    std::vector<std::string> file_descriptor =
+      GeneralUtils::ParseToStr(inputfilename, ":");
+    if (file_descriptor.size() != 2) {
+      THROW("File descriptor had no filetype declaration: \"" << inputfilename
+            << "\". expected \"FILETYPE:file.root\"");
+    }
+    InputUtils::InputType inptype =
+      InputUtils::ParseInputType(file_descriptor[0]);
+    inputs.push_back(InputUtils::CreateInputHandler("eventsaver", inptype, file_descriptor[1]));
+
+    long nevents = inputs.back()->GetNEvents();
+    long neventsinchunk = (nevents * (procchunk + 1)) / nchunks - (nevents * procchunk) / nchunks;
+    totalwork += neventsinchunk * (nweights + 1);
+  }
+
+  long donework = 0;
+  WriteSplineChunkProgress(progressname, donework, totalwork);
+
+  for (size_t i = 0; i < eventkeys.size(); i++) {
+
+    InputHandlerBase* input = inputs[i];
+
+    // Chunk boundaries include the remainder in the last chunk
+    int nevents = input->GetNEvents();
+    int lowevent  = int((long(nevents) * procchunk) / nchunks);
+    int highevent = int((long(nevents) * (procchunk + 1)) / nchunks);
+    int neventsinchunk = highevent - lowevent;
+
+    LOG(FIT) << "Spline chunk " << procchunk << "/" << nchunks << " processing events ["
+             << lowevent << "," << highevent << ") of " << eventkeys[i].GetS("input") << std::endl;
+
+    TFile* outputfile = new TFile(SplineChunkFileName(chunkdir, i, procchunk).c_str(), "RECREATE");
+    outputfile->cd();
+
+    FitEvent* nuisevent = input->FirstNuisanceEvent();
+
+    TTree* eventtree = new TTree("nuisance_events", "nuisance_events");
+    nuisevent->AddBranchesToTree(eventtree);
+
+    TTree* weighttree = new TTree("weight_tree", "weight_tree");
+    splwrite->AddWeightsToTree(weighttree);
+
+    TTree* splinetree = new TTree("spline_tree", "spline_tree");
+    splwrite->AddCoefficientsToTree(splinetree);
+
+    // Loop over sets first so each dial set is only reconfigured once.
+    std::vector<double> allweights(size_t(neventsinchunk) * nweights, 1.0);
+    for (int iset = 0; iset < nweights; iset++) {
+
+      splwrite->ReconfigureSet(iset);
+
+      for (int k = 0; k < neventsinchunk; k++) {
+        nuisevent = input->GetNuisanceEvent(lowevent + k);
+        double w = splwrite->GetWeightForThisSet(nuisevent);
+        double* evtweights = &allweights[size_t(k) * nweights];
+
+        // Same conventions as SplineWriter::GetWeightsForEvent
+        if (iset == 0) {
+          evtweights[0] = w;
+        } else if (w >= 0.0 and w < 200) {
+          evtweights[iset] = w / evtweights[0];
+        } else {
+          evtweights[iset] = 1.0;
+        }
+      }
+
+      donework += neventsinchunk;
+      WriteSplineChunkProgress(progressname, donework, totalwork);
+      LOG(REC) << "Processed Set " << iset << "/" << nweights << " in chunk " << procchunk << std::endl;
+    }
+
+    // Fit and save in event order
+    for (int k = 0; k < neventsinchunk; k++) {
+
+      nuisevent = input->GetNuisanceEvent(lowevent + k);
+      double* evtweights = &allweights[size_t(k) * nweights];
+      nuisevent->RWWeight = evtweights[0];
+
+      splwrite->SetWeights(evtweights);
+      bool hasresponse = false;
+      for (int j = 1; j < nweights; j++) {
+        if (evtweights[j] != 1.0) {
+          hasresponse = true;
+          break;
+        }
+      }
+
+      if (hasresponse) {
+        splwrite->FitSplinesForEvent(evtweights, splwrite->fCoEffStorer);
+      } else {
+        for (int j = 0; j < npar; j++) splwrite->fCoEffStorer[j] = 0.0;
+      }
+      splwrite->PackCoefficients();
+
+      eventtree->Fill();
+      weighttree->Fill();
+      splinetree->Fill();
+
+      donework++;
+      if (k % 1000 == 0) WriteSplineChunkProgress(progressname, donework, totalwork);
+    }
+
+    outputfile->cd();
+    eventtree->Write();
+    weighttree->Write();
+    splinetree->Write();
+    splwrite->fPacker.PrintSummary();
+    input->GetFluxHistogram()->Write("nuisance_fluxhist");
+    input->GetEventHistogram()->Write("nuisance_eventhist");
+    outputfile->Close();
+
+    delete input;
+  }
+
+  WriteSplineChunkProgress(progressname, totalwork, totalwork);
+  delete splwrite;
+}
+
+//*************************************
+void SplineRoutines::GenerateEventSplinesParallel() {
+//*************************************
+
+  int nprocs = FitPar::Config().GetParI("spline_procs");
+  if (nprocs <= 0) nprocs = 1;
+
+  int nchunks = FitPar::Config().GetParI("spline_chunks");
+  if (nchunks < nprocs) nchunks = nprocs;
+
+  int nretries = FitPar::Config().GetParI("spline_retries");
+  if (nretries < 0) nretries = 0;
+
+  std::vector<nuiskey> eventkeys = Config::QueryKeys("events");
+  if (eventkeys.empty()) {
+    THROW("GenerateEventSplinesParallel called with no <events> keys!");
+  }
+
+  // Scratch area for the chunk outputs
+  std::string tmpbase = FitPar::Config().GetParS("spline_tmpdir");
+  if (tmpbase.empty() and getenv("TMPDIR")) tmpbase = getenv("TMPDIR");
+  if (tmpbase.empty()) tmpbase = "/tmp";
+
+  std::string tmptemplate = tmpbase + "/nuissplines_XXXXXX";
+  std::vector<char> tmpbuf(tmptemplate.begin(), tmptemplate.end());
+  tmpbuf.push_back('\0');
+  if (!mkdtemp(&tmpbuf[0])) {
+    THROW("Failed to create spline chunk directory from " << tmptemplate);
+  }
+  std::string chunkdir = &tmpbuf[0];
+
+  LOG(FIT) << "Generating splines in " << nchunks << " chunks across " << nprocs
+           << " processes. Chunk outputs in " << chunkdir << std::endl;
+
+  // Chunk bookkeeping
+  std::vector<int> queue;
+  for (int i = nchunks - 1; i >= 0; i--) queue.push_back(i);
+  std::vector<int> attempts(nchunks, 0);
+  std::map<pid_t, int> running;
+  int ndone = 0;
+  int lastreport = 0;
+
+  while (ndone < nchunks) {
+
+    // Launch workers while there are free slots
+    while (int(running.size()) < nprocs and !queue.empty()) {
+
+      int ichunk = queue.back();
+      queue.pop_back();
+      attempts[ichunk]++;
+
+      std::vector<std::string> wargs;
+      wargs.push_back(fExecutable);
+      wargs.push_back("-c");
+      wargs.push_back(fCardFile);
+      wargs.push_back("-o");
+      wargs.push_back(chunkdir + "/" + std::string(Form("worker%d.root", ichunk)));
+      wargs.push_back("-f");
+      wargs.push_back("GenerateEventSplineChunk");
+      if (fMaxEvents.compare("-1")) {
+        wargs.push_back("-n");
+        wargs.push_back(fMaxEvents);
+      }
+      for (size_t j = 0; j < fXMLCmds.size(); j++) {
+        wargs.push_back("-i");
+        wargs.push_back(fXMLCmds[j]);
+      }
+      for (size_t j = 0; j < fConfigArgs.size(); j++) {
+        wargs.push_back("-q");
+        wargs.push_back(fConfigArgs[j]);
+      }
+      wargs.push_back("-q");
+      wargs.push_back(std::string(Form("spline_procchunk=%d", ichunk)));
+      wargs.push_back("-q");
+      wargs.push_back(std::string(Form("spline_chunks=%d", nchunks)));
+      wargs.push_back("-q");
+      wargs.push_back("spline_chunkdir=" + chunkdir);
+
+      std::string logname = chunkdir + "/" + std::string(Form("chunk%d.log", ichunk));
+
+      pid_t pid = fork();
+      if (pid < 0) {
+        THROW("fork() failed launching spline chunk " << ichunk);
+      }
+
+      if (pid == 0) {
+        // Child : send output to the chunk log and replace ourselves
+        int logfd = open(logname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (logfd >= 0) {
+          dup2(logfd, STDOUT_FILENO);
+          dup2(logfd, STDERR_FILENO);
+          close(logfd);
+        }
+
+        std::vector<char*> cargs;
+        for (size_t j = 0; j < wargs.size(); j++) {
+          cargs.push_back(const_cast<char*>(wargs[j].c_str()));
+        }
+        cargs.push_back(NULL);
+
+        execvp(cargs[0], &cargs[0]);
+        _exit(127);
+      }
+
+      running[pid] = ichunk;
+      LOG(FIT) << "Launched spline chunk " << ichunk << " (attempt " << attempts[ichunk]
+               << ") as pid " << pid << std::endl;
+    }
+
+    // Reap finished workers
+    int status = 0;
+    pid_t pid = waitpid(-1, &status, WNOHANG);
+    if (pid > 0 and running.find(pid) != running.end()) {
+
+      int ichunk = running[pid];
+      running.erase(pid);
+
+      bool good = (WIFEXITED(status) and WEXITSTATUS(status) == 0);
+      for (size_t i = 0; good and i < eventkeys.size(); i++) {
+        good = !gSystem->AccessPathName(SplineChunkFileName(chunkdir, i, ichunk).c_str());
+      }
+
+      if (good) {
+        ndone++;
+        LOG(FIT) << "Spline chunk " << ichunk << " finished. " << ndone << "/" << nchunks
+                 << " complete." << std::endl;
+
+      } else if (attempts[ichunk] <= nretries) {
+        ERR(WRN) << "Spline chunk " << ichunk << " failed (status " << status
+                 << "), retrying. See " << chunkdir << "/chunk" << ichunk << ".log" << std::endl;
+        queue.push_back(ichunk);
+
+      } else {
+        for (std::map<pid_t, int>::iterator iter = running.begin();
+             iter != running.end(); iter++) {
+          kill(iter->first, SIGTERM);
+        }
+        THROW("Spline chunk " << ichunk << " failed after " << attempts[ichunk]
+              << " attempts. See " << chunkdir << "/chunk" << ichunk << ".log");
+      }
+      continue;
+    }
+
+    // Periodic progress report from the worker progress files
+    int now = time(NULL);
+    if (now - lastreport >= 30) {
+      lastreport = now;
+      for (std::map<pid_t, int>::iterator iter = running.begin();
+           iter != running.end(); iter++) {
+        std::ifstream progfile(SplineChunkProgressName(chunkdir, iter->second).c_str());
+        long done = 0;
+        long total = 0;
+        if (progfile >> done >> total and total > 0) {
+          LOG(REC) << "Spline chunk " << iter->second << " : "
+                   << (100.0 * done) / total << "% complete." << std::endl;
+        }
+      }
+    }
+
+    sleep(1);
+  }
+
+  // Setup a spline writer only to save the spline_reader definitions
+  if (fRW) delete fRW;
+  SetupRWEngine();
+  SplineWriter* splwrite = new SplineWriter(fRW);
+  std::vector<nuiskey> splinekeys = Config::QueryKeys("spline");
+  for (std::vector<nuiskey>::iterator iter = splinekeys.begin();
+       iter != splinekeys.end(); iter++) {
+    splwrite->AddSpline(*iter);
+  }
+
+  // Concatenate chunks in order for each input
+  for (size_t i = 0; i < eventkeys.size(); i++) {
+
+    std::string outputfilename = eventkeys[i].GetS("output");
+    if (outputfilename.empty()) {
+      outputfilename = eventkeys[i].GetS("input") + ".nuisance.root";
+      ERR(WRN) << "No output give for set of output events! Saving to "
+               << outputfilename << std::endl;
+    }
+
+    SplineMerger merger;
+    for (int ichunk = 0; ichunk < nchunks; ichunk++) {
+      merger.AddChunkFile(SplineChunkFileName(chunkdir, i, ichunk));
+    }
+
+    TFile* outputfile = new TFile(outputfilename.c_str(), "RECREATE");
+    Long64_t nmerged = merger.ConcatenateChunkTrees("nuisance_events", outputfile);
+    merger.ConcatenateChunkTrees("weight_tree", outputfile);
+    merger.ConcatenateChunkTrees("spline_tree", outputfile);
+    merger.CopyChunkObject("nuisance_fluxhist", outputfile);
+    merger.CopyChunkObject("nuisance_eventhist", outputfile);
+
+    outputfile->cd();
+    splwrite->Write("spline_reader");
+    outputfile->Close();
+    delete outputfile;
+
+    LOG(FIT) << "Merged " << nmerged << " spline events into " << outputfilename << std::endl;
+  }
+  delete splwrite;
+
+  // Clean up scratch area
+  if (!FitPar::Config().GetParB("spline_keepchunks")) {
+    void* dirp = gSystem->OpenDirectory(chunkdir.c_str());
+    const char* entry = NULL;
+    std::vector<std::string> scratchfiles;
+    while (dirp and (entry = gSystem->GetDirEntry(dirp))) {
+      std::string name = entry;
+      if (!name.compare(".") or !name.compare("..")) continue;
+      scratchfiles.push_back(chunkdir + "/" + name);
+    }
+    if (dirp) gSystem->FreeDirectory(dirp);
+
+    for (size_t i = 0; i < scratchfiles.size(); i++) {
+      gSystem->Unlink(scratchfiles[i].c_str());
+    }
+    gSystem->Unlink(chunkdir.c_str());
+  } else {
+    LOG(FIT) << "Keeping spline chunk outputs in " << chunkdir << std::endl;
+  }
+}
+
 // void SplineRoutines::BuildSplineChunk(){
 //}
 
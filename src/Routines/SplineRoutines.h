@@ -107,6 +107,14 @@ public:
   void GenerateEventWeightChunks(int procchunk = -1);
   void BuildEventSplines(int procchunk = -1);
   void MergeEventSplinesChunks();
+
+  /// Forks spline_procs worker processes over disjoint event ranges and
+  /// merges their chunk outputs into the final spline files.
+  void GenerateEventSplinesParallel();
+
+  /// Worker routine launched by GenerateEventSplinesParallel. Builds weights
+  /// and spline coefficients for a single chunk into spline_chunkdir.
+  void GenerateEventSplineChunk(int procchunk);
   /* 
     Testing Functions
   */
@@ -160,6 +168,12 @@ protected:
   
   std::string fCardFile;
 
+  // Arguments needed to relaunch this executable as a chunk worker
+  std::string fExecutable;
+  std::string fMaxEvents;
+  std::vector<std::string> fConfigArgs;
+  std::vector<std::string> fXMLCmds;
+
   std::string fStrategy;
   std::vector<std::string> fRoutines;
   std::string fAllowedRoutines;
@@ -399,6 +399,36 @@ float Spline::Spline2DTSpline3(const Float_t* par) const {
   return weight * weight2 * par[off + 8];
 };
 
+double Spline::GetCoeffScale(int ipar) {
+
+  switch (fType) {
+  case k1DPol1:
+  case k1DPol2:
+  case k1DPol3:
+  case k1DPol4:
+  case k1DPol5:
+  case k1DPol6: {
+    double xmax = fabs(fValMax[0]) > fabs(fValMin[0]) ? fabs(fValMax[0]) : fabs(fValMin[0]);
+    return pow(xmax, ipar);
+  }
+
+  case k1DTSpline3: {
+    // dx never exceeds the widest knot spacing as values are clamped
+    double dxmax = 0.0;
+    for (size_t i = 1; i < fXScan.size(); i++) {
+      double dx = fabs(fXScan[i] - fXScan[i - 1]);
+      if (dx > dxmax) dxmax = dx;
+    }
+    return pow(dxmax, ipar % 4);
+  }
+
+  // Normalised to [0,1] in Spline2DPol
+  case k2DPol6: { return 1.0; }
+  }
+
+  return -1.0;
+}
+
 TF1* Spline::GetFunction() {
 
   if (!fROOTFunction) {
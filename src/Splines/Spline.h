@@ -69,6 +69,10 @@ public:
   inline int GetNPar(void) { return fNPar;  };
   inline std::string GetForm() {return fForm;};
 
+  /// Max magnitude of the basis term multiplying coefficient ipar over the
+  /// dial range. Returns -1.0 where no simple bound exists.
+  double GetCoeffScale(int ipar);
+
   //void Reconfigure(double x);
   void Reconfigure(float x, int index = 0);
   void Reconfigure(std::string name, float x);
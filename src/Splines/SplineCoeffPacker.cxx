@@ -0,0 +1,272 @@
+#include "SplineCoeffPacker.h"
+#include <cmath>
+#include <cstring>
+
+int SplineUtils::ParseCoeffFormat(std::string format) {
+  if (format.empty() or !format.compare("dense")) return kDenseCoeff;
+  else if (!format.compare("sparse")) return kSparseCoeff;
+  else if (!format.compare("sparse16")) return kSparseHalfCoeff;
+
+  ERR(FTL) << "Unknown spline coefficient format : " << format
+           << ". Expected dense, sparse or sparse16." << std::endl;
+  throw;
+}
+
+unsigned short SplineUtils::FloatToHalf(float val) {
+
+  UInt_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+
+  UInt_t sign = (bits >> 16) & 0x8000;
+  UInt_t mant = bits & 0x007fffff;
+  int    expo = int((bits >> 23) & 0xff);
+
+  // NaN and Inf
+  if (expo == 0xff) {
+    return (unsigned short)(sign | 0x7c00 | (mant ? 0x200 : 0));
+  }
+
+  int halfexp = expo - 127 + 15;
+
+  // Overflow to Inf
+  if (halfexp >= 0x1f) return (unsigned short)(sign | 0x7c00);
+
+  // Subnormal or zero
+  if (halfexp <= 0) {
+    if (halfexp < -10) return (unsigned short)sign;
+    mant |= 0x00800000;
+    int shift = 14 - halfexp;
+    UInt_t halfmant = mant >> shift;
+    UInt_t rem = mant & ((1u << shift) - 1);
+    UInt_t halfway = 1u << (shift - 1);
+    if (rem > halfway or (rem == halfway and (halfmant & 1))) halfmant++;
+    return (unsigned short)(sign | halfmant);
+  }
+
+  // Normal, round mantissa to nearest even
+  UInt_t halfbits = sign | (UInt_t(halfexp) << 10) | (mant >> 13);
+  UInt_t rem = mant & 0x1fff;
+  if (rem > 0x1000 or (rem == 0x1000 and (halfbits & 1))) halfbits++;
+  return (unsigned short)halfbits;
+}
+
+float SplineUtils::HalfToFloat(unsigned short val) {
+
+  UInt_t sign = (UInt_t(val) & 0x8000) << 16;
+  int    expo = (val >> 10) & 0x1f;
+  UInt_t mant = val & 0x3ff;
+  UInt_t bits;
+
+  if (expo == 0x1f) {
+    bits = sign | 0x7f800000 | (mant << 13);
+  } else if (expo == 0) {
+    if (mant == 0) {
+      bits = sign;
+    } else {
+      // Renormalise the subnormal
+      expo = 1;
+      while (!(mant & 0x400)) {
+        mant <<= 1;
+        expo--;
+      }
+      mant &= 0x3ff;
+      bits = sign | (UInt_t(expo - 15 + 127) << 23) | (mant << 13);
+    }
+  } else {
+    bits = sign | (UInt_t(expo - 15 + 127) << 23) | (mant << 13);
+  }
+
+  float out;
+  std::memcpy(&out, &bits, sizeof(out));
+  return out;
+}
+
+SplineCoeffPacker::SplineCoeffPacker() {
+  fFormat = SplineUtils::kDenseCoeff;
+  fNSplines = 0;
+  fNMaskWords = 0;
+  fNCoeff = 0;
+  fMask = NULL;
+  fNPacked = 0;
+  fPacked = NULL;
+  fPacked16 = NULL;
+  fNEntries = 0;
+  fNPackedTotal = 0;
+  fMaxCoeffError = 0.0;
+  fMaxRelCoeffError = 0.0;
+  fMaxWeightErrorBound = 0.0;
+}
+
+SplineCoeffPacker::~SplineCoeffPacker() {
+  if (fMask) delete[] fMask;
+  if (fPacked) delete[] fPacked;
+  if (fPacked16) delete[] fPacked16;
+}
+
+void SplineCoeffPacker::Setup(std::vector<int> const& npars, int format,
+                              std::vector<double> const& coeffscale) {
+
+  fFormat = format;
+  fNPars = npars;
+  fNSplines = npars.size();
+  fNMaskWords = (fNSplines + 31) / 32;
+  if (fNMaskWords == 0) fNMaskWords = 1;
+
+  fOffsets.clear();
+  fNCoeff = 0;
+  for (size_t i = 0; i < npars.size(); i++) {
+    fOffsets.push_back(fNCoeff);
+    fNCoeff += npars[i];
+  }
+
+  fCoeffScale = coeffscale;
+  if ((int)fCoeffScale.size() != fNCoeff) {
+    fCoeffScale = std::vector<double>(fNCoeff, -1.0);
+  }
+
+  if (fMask) delete[] fMask;
+  if (fPacked) delete[] fPacked;
+  if (fPacked16) delete[] fPacked16;
+
+  // Sized for the worst case of every block responding
+  fMask = new UInt_t[fNMaskWords];
+  fPacked = new float[fNCoeff + 1];
+  fPacked16 = new UShort_t[fNCoeff + 1];
+  std::memset(fMask, 0, sizeof(UInt_t) * fNMaskWords);
+  fNPacked = 0;
+}
+
+void SplineCoeffPacker::AddBranchesToTree(TTree* tr) {
+
+  LOG(SAM) << "Saving packed spline coefficients to TTree. Format = " << fFormat
+           << ", NSplines = " << fNSplines << ", Max NCoeff = " << fNCoeff << std::endl;
+
+  tr->Branch("SplineMask", fMask, Form("SplineMask[%d]/i", fNMaskWords));
+  tr->Branch("NSplineCoeff", &fNPacked, "NSplineCoeff/I");
+  if (fFormat == SplineUtils::kSparseHalfCoeff) {
+    tr->Branch("SplinePacked16", fPacked16, "SplinePacked16[NSplineCoeff]/s");
+  } else {
+    tr->Branch("SplinePacked", fPacked, "SplinePacked[NSplineCoeff]/F");
+  }
+}
+
+bool SplineCoeffPacker::SetBranchAddresses(TTree* tr) {
+
+  if (!tr->GetBranch("SplineMask")) return false;
+
+  tr->SetBranchAddress("SplineMask", fMask);
+  tr->SetBranchAddress("NSplineCoeff", &fNPacked);
+
+  if (tr->GetBranch("SplinePacked16")) {
+    fFormat = SplineUtils::kSparseHalfCoeff;
+    tr->SetBranchAddress("SplinePacked16", fPacked16);
+  } else {
+    fFormat = SplineUtils::kSparseCoeff;
+    tr->SetBranchAddress("SplinePacked", fPacked);
+  }
+
+  return true;
+}
+
+void SplineCoeffPacker::Pack(const float* dense) {
+
+  std::memset(fMask, 0, sizeof(UInt_t) * fNMaskWords);
+  fNPacked = 0;
+
+  for (int i = 0; i < fNSplines; i++) {
+    const float* block = &dense[fOffsets[i]];
+
+    bool hasresponse = false;
+    for (int j = 0; j < fNPars[i]; j++) {
+      if (block[j] != 0.0) {
+        hasresponse = true;
+        break;
+      }
+    }
+    if (!hasresponse) continue;
+
+    fMask[i / 32] |= (1u << (i % 32));
+
+    double weighterror = 0.0;
+    for (int j = 0; j < fNPars[i]; j++) {
+      fPacked[fNPacked] = block[j];
+
+      if (fFormat == SplineUtils::kSparseHalfCoeff) {
+        fPacked16[fNPacked] = SplineUtils::FloatToHalf(block[j]);
+
+        // Track the quantisation error
+        double err = fabs(SplineUtils::HalfToFloat(fPacked16[fNPacked]) - block[j]);
+        if (err > fMaxCoeffError) fMaxCoeffError = err;
+        if (block[j] != 0.0 and err / fabs(block[j]) > fMaxRelCoeffError) {
+          fMaxRelCoeffError = err / fabs(block[j]);
+        }
+
+        double scale = fCoeffScale[fOffsets[i] + j];
+        if (scale >= 0.0 and weighterror >= 0.0) weighterror += err * scale;
+        else weighterror = -1.0;
+      }
+
+      fNPacked++;
+    }
+
+    if (weighterror > fMaxWeightErrorBound) fMaxWeightErrorBound = weighterror;
+  }
+
+  fNEntries++;
+  fNPackedTotal += fNPacked;
+}
+
+void SplineCoeffPacker::Unpack(float* dense) {
+
+  const float* packed = GetPacked();
+  int count = 0;
+
+  for (int i = 0; i < fNSplines; i++) {
+    float* block = &dense[fOffsets[i]];
+
+    if (fMask[i / 32] & (1u << (i % 32))) {
+      for (int j = 0; j < fNPars[i]; j++) {
+        block[j] = packed[count++];
+      }
+    } else {
+      for (int j = 0; j < fNPars[i]; j++) {
+        block[j] = 0.0;
+      }
+    }
+  }
+}
+
+float* SplineCoeffPacker::GetPacked() {
+  if (fFormat == SplineUtils::kSparseHalfCoeff) {
+    for (int i = 0; i < fNPacked; i++) {
+      fPacked[i] = SplineUtils::HalfToFloat(fPacked16[i]);
+    }
+  }
+  return fPacked;
+}
+
+void SplineCoeffPacker::PrintSummary() {
+
+  if (fNEntries == 0) return;
+
+  double bytesdense = double(fNEntries) * fNCoeff * sizeof(float);
+  double bytespacked = double(fNEntries) * fNMaskWords * sizeof(UInt_t) +
+                       double(fNPackedTotal) *
+                       (fFormat == SplineUtils::kSparseHalfCoeff ? sizeof(UShort_t) : sizeof(float));
+
+  LOG(FIT) << "Packed " << fNEntries << " spline coefficient sets. Mean "
+           << double(fNPackedTotal) / fNEntries << "/" << fNCoeff
+           << " coefficients kept. Storage reduced by x"
+           << (bytespacked > 0.0 ? bytesdense / bytespacked : 0.0) << std::endl;
+
+  if (fFormat == SplineUtils::kSparseHalfCoeff) {
+    LOG(FIT) << "fp16 coefficient error : max abs = " << fMaxCoeffError
+             << ", max rel = " << fMaxRelCoeffError << std::endl;
+    if (fMaxWeightErrorBound >= 0.0) {
+      LOG(FIT) << "fp16 per-dial weight error bound over dial range : "
+               << fMaxWeightErrorBound << std::endl;
+    } else {
+      LOG(FIT) << "fp16 per-dial weight error bound unavailable for these spline forms." << std::endl;
+    }
+  }
+}
@@ -0,0 +1,85 @@
+#ifndef SPLINECOEFFPACKER_H
+#define SPLINECOEFFPACKER_H
+#include <vector>
+#include <string>
+
+#include "TTree.h"
+#include "FitLogger.h"
+
+namespace SplineUtils {
+
+// Spline coefficient storage formats
+enum coeff_formats {
+  kDenseCoeff = 0,   // SplineCoeff[npar]/F for every event
+  kSparseCoeff,      // Response bitmask + packed non-zero blocks as floats
+  kSparseHalfCoeff   // Response bitmask + packed non-zero blocks as fp16
+};
+
+int ParseCoeffFormat(std::string format);
+
+/// IEEE 754 binary16 conversions (round to nearest even)
+unsigned short FloatToHalf(float val);
+float HalfToFloat(unsigned short val);
+
+}
+
+/// Packs a dense spline coefficient array into a per-event dial response
+/// bitmask and a packed list of the coefficient blocks that have a response.
+/// A spline block is dropped when all of its coefficients are exactly zero,
+/// matching the no-response check in Spline::DoEval.
+class SplineCoeffPacker {
+public:
+  SplineCoeffPacker();
+  ~SplineCoeffPacker();
+
+  /// Setup block sizes and format. coeffscale gives, for each dense
+  /// coefficient, the max magnitude of its basis term over the dial range
+  /// (negative if unknown). Used only to report the fp16 error bound.
+  void Setup(std::vector<int> const& npars, int format,
+             std::vector<double> const& coeffscale = std::vector<double>());
+
+  /// Writer : add SplineMask, NSplineCoeff and SplinePacked(16) branches.
+  void AddBranchesToTree(TTree* tr);
+
+  /// Reader : attach to packed branches. Returns false if the tree is dense.
+  bool SetBranchAddresses(TTree* tr);
+
+  /// Fill the packed buffers from a dense coefficient array.
+  void Pack(const float* dense);
+
+  /// Expand the current packed buffers into a dense array.
+  void Unpack(float* dense);
+
+  /// Packed coefficients for the current entry as floats.
+  /// fp16 trees are decoded into the float buffer here.
+  float* GetPacked();
+
+  /// Print storage saving and quantisation error summary.
+  void PrintSummary();
+
+  inline int GetFormat() { return fFormat; };
+  inline int GetNMaskWords() { return fNMaskWords; };
+
+  int fFormat;
+  int fNSplines;
+  int fNMaskWords;
+  int fNCoeff;
+  std::vector<int> fNPars;
+  std::vector<int> fOffsets;
+  std::vector<double> fCoeffScale;
+
+  // Branch buffers
+  UInt_t* fMask;
+  Int_t fNPacked;
+  float* fPacked;
+  UShort_t* fPacked16;
+
+  // Bookkeeping for the summary
+  Long64_t fNEntries;
+  Long64_t fNPackedTotal;
+  double fMaxCoeffError;
+  double fMaxRelCoeffError;
+  double fMaxWeightErrorBound;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#include "SplineKernels.h"
+
+namespace SplineUtils {
+
+template <int T>
+static SplineKernelBinding MakeSplineKernelBinding() {
+  SplineKernelBinding bind;
+  bind.eval = &EvalSplineKernel<T>;
+  bind.batch = &EvalSplineBatch<T>;
+  bind.grad = SplineKernelGrad<T>::kHasGrad ? &EvalSplineGrad<T> : NULL;
+  return bind;
+}
+
+SplineKernelBinding GetSplineKernel(int type) {
+  switch (type) {
+  case k1DPol1:     { return MakeSplineKernelBinding<k1DPol1>(); }
+  case k1DPol2:     { return MakeSplineKernelBinding<k1DPol2>(); }
+  case k1DPol3:     { return MakeSplineKernelBinding<k1DPol3>(); }
+  case k1DPol4:     { return MakeSplineKernelBinding<k1DPol4>(); }
+  case k1DPol5:     { return MakeSplineKernelBinding<k1DPol5>(); }
+  case k1DPol6:     { return MakeSplineKernelBinding<k1DPol6>(); }
+  case k1DTSpline3: { return MakeSplineKernelBinding<k1DTSpline3>(); }
+  case k2DPol6:     { return MakeSplineKernelBinding<k2DPol6>(); }
+  }
+
+  // 2DGaus, 2DTSpline3 and anything new use Spline::DoEval
+  return MakeSplineKernelBinding<0>();
+}
+
+void UpdateSplineKernelState(Spline& spl, SplineKernelState& st) {
+
+  st.spl = &spl;
+  st.npar = spl.GetNPar();
+  st.x = spl.fVal[0];
+  st.y = spl.fNDim > 1 ? spl.fVal[1] : 0.0;
+  st.off = 0;
+  st.dx = 0.0;
+
+  // Reconfigure clamps to the spline limits, past them the response is flat.
+  // A dial sitting exactly on a limit is treated as clamped.
+  st.dxdv = (st.x > spl.fValMin[0] and st.x < spl.fValMax[0]) ? 1.0 : 0.0;
+  st.dydv = 0.0;
+  if (spl.fNDim > 1) {
+    st.dydv = (st.y > spl.fValMin[1] and st.y < spl.fValMax[1]) ? 1.0 : 0.0;
+  }
+
+  switch (spl.GetType()) {
+
+  // Same knot search as Spline::Spline1DTSpline3, done once per reconfigure
+  case k1DTSpline3: {
+    size_t nknots = spl.fXScan.size();
+    size_t low = 0;
+    while (low + 1 < nknots and
+           (st.x < spl.fXScan[low] or st.x >= spl.fXScan[low + 1])) {
+      st.off += 4;
+      low++;
+    }
+    st.dx = st.x - spl.fXScan[low];
+    break;
+  }
+
+  // Basis terms in the coefficient order of Spline::Spline2DPol
+  case k2DPol6: {
+    float wx = (spl.fVal[0] - spl.fValMin[0]) / (spl.fValMax[0] - spl.fValMin[0]);
+    float wy = (spl.fVal[1] - spl.fValMin[1]) / (spl.fValMax[1] - spl.fValMin[1]);
+    int count = 0;
+    for (int d = 0; d <= 6; d++) {
+      for (int k = 0; k <= d; k++) {
+        float term = 1.0;
+        float termx = (d - k);
+        float termy = k;
+        for (int a = 0; a < d - k; a++) {
+          term *= wx;
+          if (a > 0) termx *= wx;
+          termy *= wx;
+        }
+        for (int b = 0; b < k; b++) {
+          term *= wy;
+          termx *= wy;
+          if (b > 0) termy *= wy;
+        }
+        st.basis[count] = term;
+        st.dbasisx[count] = termx;
+        st.dbasisy[count] = termy;
+        count++;
+      }
+    }
+    st.x = wx;
+    st.y = wy;
+    st.dxdv /= (spl.fValMax[0] - spl.fValMin[0]);
+    st.dydv /= (spl.fValMax[1] - spl.fValMin[1]);
+    break;
+  }
+  }
+}
+
+}
@@ -0,0 +1,276 @@
+#ifndef SPLINEKERNELS_H
+#define SPLINEKERNELS_H
+
+#include "Spline.h"
+
+namespace SplineUtils {
+
+/// Per spline evaluation state. Everything that depends only on the dial
+/// values is computed here once per reconfigure, not per event.
+struct SplineKernelState {
+  float x;            ///< Clamped dial value (normalised to [0,1] for 2DPol)
+  float y;            ///< Second clamped dial value for 2D forms
+  int off;            ///< Coefficient offset of the active TSpline3 knot
+  float dx;           ///< Distance from the active TSpline3 knot
+  int npar;           ///< Coefficients in this block
+  float basis[28];    ///< 2DPol6 basis terms in coefficient order
+  float dbasisx[28];  ///< 2DPol6 basis derivatives in the normalised x
+  float dbasisy[28];  ///< 2DPol6 basis derivatives in the normalised y
+  float dxdv;         ///< d(x)/d(dial), zero when the dial is clamped
+  float dydv;         ///< d(y)/d(dial), zero when the dial is clamped
+  const Spline* spl;  ///< Used only by the generic kernel
+};
+
+/// Evaluate one coefficient block
+typedef float (*SplineKernelFunc)(const float* par, const SplineKernelState& st);
+
+/// Multiply weights[i] by the response of the block at coeff + i * stride
+typedef void (*SplineBatchFunc)(const float* coeff, int n, int stride,
+                                const SplineKernelState& st, double* weights);
+
+/// Evaluate one block and fill grad[0..ndim-1] with the derivatives
+/// of the block with respect to the raw dial values
+typedef float (*SplineGradFunc)(const float* par, const SplineKernelState& st,
+                                float* grad);
+
+/// Horner evaluation with the degree fixed at compile time
+template <int N>
+struct SplinePolHorner {
+  static inline float Eval(const float* par, float x) {
+    return par[0] + x * SplinePolHorner<N - 1>::Eval(par + 1, x);
+  }
+};
+
+template <>
+struct SplinePolHorner<0> {
+  static inline float Eval(const float* par, float x) {
+    (void)x;
+    return par[0];
+  }
+};
+
+/// Horner evaluation of the first derivative, sum_k k * par[k] * x^(k-1)
+template <int N, int K = 1>
+struct SplinePolHornerDeriv {
+  static inline float Eval(const float* par, float x) {
+    return K * par[K] + x * SplinePolHornerDeriv<N, K + 1>::Eval(par, x);
+  }
+};
+
+template <int N>
+struct SplinePolHornerDeriv<N, N> {
+  static inline float Eval(const float* par, float x) {
+    (void)x;
+    return N * par[N];
+  }
+};
+
+/// No response check unrolled for a fixed block size
+template <int N>
+struct SplineHasResponse {
+  static inline bool Check(const float* par, int npar) {
+    (void)npar;
+    return (par[0] != 0.0) or SplineHasResponse<N - 1>::Check(par + 1, npar);
+  }
+};
+
+template <>
+struct SplineHasResponse<0> {
+  static inline bool Check(const float* par, int npar) {
+    (void)par;
+    (void)npar;
+    return false;
+  }
+};
+
+/// Runtime sized blocks (TSpline3 and generic forms)
+template <>
+struct SplineHasResponse<-1> {
+  static inline bool Check(const float* par, int npar) {
+    for (int i = 0; i < npar; i++) {
+      if (par[i] != 0.0) return true;
+    }
+    return false;
+  }
+};
+
+/// Generic kernel. Forms without a specialisation go back to Spline::DoEval.
+template <int T>
+struct SplineKernel {
+  static const int kNPar = -1;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    return st.spl->DoEval(par, false);
+  }
+};
+
+template <>
+struct SplineKernel<k1DPol1> {
+  static const int kNPar = 2;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    return SplinePolHorner<1>::Eval(par, st.x);
+  }
+};
+
+template <>
+struct SplineKernel<k1DPol2> {
+  static const int kNPar = 3;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    return SplinePolHorner<2>::Eval(par, st.x);
+  }
+};
+
+template <>
+struct SplineKernel<k1DPol3> {
+  static const int kNPar = 4;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    return SplinePolHorner<3>::Eval(par, st.x);
+  }
+};
+
+template <>
+struct SplineKernel<k1DPol4> {
+  static const int kNPar = 5;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    return SplinePolHorner<4>::Eval(par, st.x);
+  }
+};
+
+template <>
+struct SplineKernel<k1DPol5> {
+  static const int kNPar = 6;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    return SplinePolHorner<5>::Eval(par, st.x);
+  }
+};
+
+template <>
+struct SplineKernel<k1DPol6> {
+  static const int kNPar = 7;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    return SplinePolHorner<6>::Eval(par, st.x);
+  }
+};
+
+template <>
+struct SplineKernel<k1DTSpline3> {
+  static const int kNPar = -1;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    const float* p = par + st.off;
+    return SplinePolHorner<3>::Eval(p, st.dx);
+  }
+};
+
+template <>
+struct SplineKernel<k2DPol6> {
+  static const int kNPar = 28;
+  static inline float Eval(const float* par, const SplineKernelState& st) {
+    float w = 0.0;
+    for (int i = 0; i < kNPar; i++) {
+      w += par[i] * st.basis[i];
+    }
+    return w;
+  }
+};
+
+/// Derivative kernels. Only forms with a closed form derivative are
+/// specialised, anything else has no gradient binding.
+template <int T>
+struct SplineKernelGrad {
+  static const bool kHasGrad = false;
+  static inline float Eval(const float* par, const SplineKernelState& st, float* grad) {
+    (void)grad;
+    return SplineKernel<T>::Eval(par, st);
+  }
+};
+
+template <int N>
+struct SplinePolKernelGrad {
+  static const bool kHasGrad = true;
+  static inline float Eval(const float* par, const SplineKernelState& st, float* grad) {
+    grad[0] = SplinePolHornerDeriv<N>::Eval(par, st.x) * st.dxdv;
+    return SplinePolHorner<N>::Eval(par, st.x);
+  }
+};
+
+template <> struct SplineKernelGrad<k1DPol1> : public SplinePolKernelGrad<1> {};
+template <> struct SplineKernelGrad<k1DPol2> : public SplinePolKernelGrad<2> {};
+template <> struct SplineKernelGrad<k1DPol3> : public SplinePolKernelGrad<3> {};
+template <> struct SplineKernelGrad<k1DPol4> : public SplinePolKernelGrad<4> {};
+template <> struct SplineKernelGrad<k1DPol5> : public SplinePolKernelGrad<5> {};
+template <> struct SplineKernelGrad<k1DPol6> : public SplinePolKernelGrad<6> {};
+
+template <>
+struct SplineKernelGrad<k1DTSpline3> {
+  static const bool kHasGrad = true;
+  static inline float Eval(const float* par, const SplineKernelState& st, float* grad) {
+    const float* p = par + st.off;
+    grad[0] = SplinePolHornerDeriv<3>::Eval(p, st.dx) * st.dxdv;
+    return SplinePolHorner<3>::Eval(p, st.dx);
+  }
+};
+
+template <>
+struct SplineKernelGrad<k2DPol6> {
+  static const bool kHasGrad = true;
+  static inline float Eval(const float* par, const SplineKernelState& st, float* grad) {
+    float w = 0.0;
+    float gx = 0.0;
+    float gy = 0.0;
+    for (int i = 0; i < 28; i++) {
+      w += par[i] * st.basis[i];
+      gx += par[i] * st.dbasisx[i];
+      gy += par[i] * st.dbasisy[i];
+    }
+    grad[0] = gx * st.dxdv;
+    grad[1] = gy * st.dydv;
+    return w;
+  }
+};
+
+/// Single block evaluation including the no response check
+template <int T>
+float EvalSplineKernel(const float* par, const SplineKernelState& st) {
+  if (!SplineHasResponse<SplineKernel<T>::kNPar>::Check(par, st.npar)) return 1.0;
+  return SplineKernel<T>::Eval(par, st);
+}
+
+/// Batched evaluation over n blocks spaced by stride
+template <int T>
+void EvalSplineBatch(const float* coeff, int n, int stride,
+                     const SplineKernelState& st, double* weights) {
+  for (int i = 0; i < n; i++) {
+    const float* par = coeff + i * stride;
+    if (!SplineHasResponse<SplineKernel<T>::kNPar>::Check(par, st.npar)) continue;
+    weights[i] *= SplineKernel<T>::Eval(par, st);
+  }
+}
+
+/// Single block value and derivatives. Blocks with no response are 1.0
+/// with zero derivative.
+template <int T>
+float EvalSplineGrad(const float* par, const SplineKernelState& st, float* grad) {
+  if (!SplineHasResponse<SplineKernel<T>::kNPar>::Check(par, st.npar)) {
+    grad[0] = 0.0;
+    if (st.spl->fNDim > 1) grad[1] = 0.0;
+    return 1.0;
+  }
+  return SplineKernelGrad<T>::Eval(par, st, grad);
+}
+
+/// Kernels bound to a spline block. grad is NULL for forms without
+/// an analytic derivative.
+struct SplineKernelBinding {
+  SplineKernelFunc eval;
+  SplineBatchFunc batch;
+  SplineGradFunc grad;
+};
+
+/// Registry lookup from Spline type to its specialised kernels
+SplineKernelBinding GetSplineKernel(int type);
+
+/// Refresh the state after the spline's dial values changed
+void UpdateSplineKernelState(Spline& spl, SplineKernelState& st);
+
+}
+
+#endif
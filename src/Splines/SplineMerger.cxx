@@ -49,6 +49,9 @@ void SplineMerger::SetupSplineSet(){
   for (size_t i = 0; i < fSplineSizeList.size(); i++){
     float* add = &(fCoEffStorer[off]);
     TTree* tree = (fSplineTreeList[i]);
+    if (!tree->GetBranch("SplineCoeff")){
+      THROW("SplineMerger can only merge dense spline sets. Regenerate with spline_coeff_format=dense.");
+    }
     tree->SetBranchAddress("SplineCoeff", add);
     off += fSplineSizeList[i];
   }
@@ -94,3 +97,70 @@ void SplineMerger::FillMergedSplines(int entry){
   }
 }
 
+
+void SplineMerger::AddChunkFile(std::string filename){
+  fChunkFileList.push_back(filename);
+}
+
+Long64_t SplineMerger::ConcatenateChunkTrees(std::string treename, TFile* outfile){
+
+  TTree* outtree = NULL;
+  Long64_t nfilled = 0;
+
+  for (size_t i = 0; i < fChunkFileList.size(); i++){
+
+    TFile* chunkfile = new TFile(fChunkFileList[i].c_str(), "READ");
+    if (!chunkfile or chunkfile->IsZombie()){
+      THROW("Cannot open spline chunk file " << fChunkFileList[i]);
+    }
+
+    TTree* intree = (TTree*) chunkfile->Get(treename.c_str());
+    if (!intree){
+      THROW("No " << treename << " tree in spline chunk file " << fChunkFileList[i]);
+    }
+
+    // First chunk defines the branch layout, later chunks share its addresses
+    if (!outtree){
+      outfile->cd();
+      outtree = intree->CloneTree(0);
+      outtree->SetDirectory(outfile);
+    } else {
+      intree->CopyAddresses(outtree);
+    }
+
+    // Entry by entry copy so whole trees are never loaded
+    Long64_t nentries = intree->GetEntries();
+    for (Long64_t j = 0; j < nentries; j++){
+      intree->GetEntry(j);
+      outtree->Fill();
+    }
+    nfilled += nentries;
+
+    intree->CopyAddresses(outtree, true);
+    chunkfile->Close();
+    delete chunkfile;
+
+    LOG(REC) << "Merged " << nentries << " " << treename << " entries from chunk " << i << std::endl;
+  }
+
+  if (outtree){
+    outfile->cd();
+    outtree->Write();
+  }
+
+  return nfilled;
+}
+
+void SplineMerger::CopyChunkObject(std::string objname, TFile* outfile){
+
+  if (fChunkFileList.empty()) return;
+
+  TFile* chunkfile = new TFile(fChunkFileList[0].c_str(), "READ");
+  TObject* obj = chunkfile->Get(objname.c_str());
+  if (obj){
+    outfile->cd();
+    obj->Write(objname.c_str());
+  }
+  chunkfile->Close();
+  delete chunkfile;
+}
@@ -20,6 +20,17 @@ class SplineMerger : public SplineReader {
 
   void FillMergedSplines(int entry);
 
+  /// Add a chunk file covering a disjoint event range. Chunks are
+  /// concatenated in the order they are added.
+  void AddChunkFile(std::string filename);
+
+  /// Stream every entry of treename from each chunk file into a single
+  /// tree inside outfile. Only one entry is held in memory at a time.
+  Long64_t ConcatenateChunkTrees(std::string treename, TFile* outfile);
+
+  /// Copy a named object (e.g. the flux histogram) from the first chunk.
+  void CopyChunkObject(std::string objname, TFile* outfile);
+
   float* fCoEffStorer;
   int fNCoEff;
 
@@ -32,6 +43,8 @@ class SplineMerger : public SplineReader {
   std::vector< double > fWeightList;
   std::vector< double > fValList;
 
+  std::vector< std::string > fChunkFileList;
+
   
 };
 
@@ -23,7 +23,7 @@ void SplineReader::AddSpline(nuiskey splinekey) {
   fForm.push_back(form);
   fPoints.push_back(points);
 
-
+  BindKernels();
 }
 
 
@@ -55,6 +55,39 @@ void SplineReader::Read(TTree* tr) {
     LOG(SAM) << "Registering Input Spline " << fSpline[i] << " " << fForm[i] << " " << fPoints[i] << std::endl;
     fAllSplines.push_back( Spline(fSpline[i], fForm[i], fPoints[i]) );
   }
+
+  BindKernels();
+}
+
+void SplineReader::BindKernels() {
+
+  fKernels.clear();
+  fKernelStates.clear();
+  fCoeffOffsets.clear();
+  fGradOffsets.clear();
+
+  int off = 0;
+  int slot = 0;
+  for (size_t i = 0; i < fAllSplines.size(); i++) {
+    fKernels.push_back(SplineUtils::GetSplineKernel(fAllSplines[i].GetType()));
+    fKernelStates.push_back(SplineUtils::SplineKernelState());
+    fCoeffOffsets.push_back(off);
+    fGradOffsets.push_back(slot);
+    off += fAllSplines[i].GetNPar();
+    slot += fAllSplines[i].GetNDim();
+  }
+
+  fGradVals.resize(fAllSplines.size());
+  fGradPrefix.resize(fAllSplines.size());
+  fGradTerms.resize(slot);
+
+  UpdateKernelStates();
+}
+
+void SplineReader::UpdateKernelStates() {
+  for (size_t i = 0; i < fAllSplines.size(); i++) {
+    SplineUtils::UpdateSplineKernelState(fAllSplines[i], fKernelStates[i]);
+  }
 }
 
 
@@ -74,6 +107,7 @@ void SplineReader::Reconfigure(std::map< std::string, double >& vals) {
     }
   }
 
+  UpdateKernelStates();
   fNeedsReconfigure = false;
 }
 
@@ -87,36 +121,33 @@ void SplineReader::SetNeedsReconfigure(bool val) {
 
 double SplineReader::CalcWeight(float* coeffs) {
 
-  int off = 0;
   double rw_weight = 1.0;
 
-  // Form Offset list
-  std::vector<int> offsets;
-  for (size_t i = 0; i < fAllSplines.size(); i++) {
-    offsets.push_back(off);
-    off +=  fAllSplines[i].GetNPar();
-  }
-
-  // #pragma omp parrallel for
-  for (size_t i = 0; i < fAllSplines.size(); i++) {
-
-    // std::cout << "Evaluating spline " << fAllSplines[i].GetName() << " at coeff offset " << off <<  "(" << coeffs << ")" << std::endl;
-    // for (int j = 0; j < fAllSplines[i].GetNPar(); j++){
-    // std::cout << "Coeff " << j+off << " " << coeffs[off+j] << std::endl;
-    // }
-
-    double w = fAllSplines[i].DoEval( &coeffs[offsets[i]] );
+  // Kernels were bound at Read so there is no per spline type switch here
+  for (size_t i = 0; i < fKernels.size(); i++) {
+    double w = fKernels[i].eval( &coeffs[fCoeffOffsets[i]], fKernelStates[i] );
     rw_weight *= w;
-    
-    // std::cout << "Spline RW Weight = " << rw_weight << " " << w << std::endl;
   }
 
   if (rw_weight <= 0.0) rw_weight = 1.0;
-  // std::cout << "Returning spline rw_weight = " << rw_weight << std::endl;
 
   return rw_weight;
 }
 
+void SplineReader::CalcWeights(const float* coeffs, int n, int stride, double* weights) {
+
+  for (int i = 0; i < n; i++) weights[i] = 1.0;
+
+  // Spline major so each batch kernel runs over a whole block of sets
+  for (size_t i = 0; i < fKernels.size(); i++) {
+    fKernels[i].batch( coeffs + fCoeffOffsets[i], n, stride, fKernelStates[i], weights );
+  }
+
+  for (int i = 0; i < n; i++) {
+    if (weights[i] <= 0.0) weights[i] = 1.0;
+  }
+}
+
 
 
 int SplineReader::GetNPar(){
@@ -133,3 +164,112 @@ int SplineReader::GetNPar(){
 
 
 
+
+std::vector<int> SplineReader::GetNParList(){
+  std::vector<int> npars;
+  for (size_t i = 0; i < fAllSplines.size(); i++){
+    npars.push_back(fAllSplines[i].GetNPar());
+  }
+  return npars;
+}
+
+double SplineReader::CalcWeight(const UInt_t* mask, const float* packed) {
+
+  double rw_weight = 1.0;
+  int off = 0;
+
+  // Only splines flagged in the mask carry coefficients, the rest are 1.0
+  for (size_t i = 0; i < fAllSplines.size(); i++) {
+    if (!(mask[i / 32] & (1u << (i % 32)))) continue;
+
+    double w = fKernels[i].eval( &packed[off], fKernelStates[i] );
+    rw_weight *= w;
+    off += fAllSplines[i].GetNPar();
+  }
+
+  if (rw_weight <= 0.0) rw_weight = 1.0;
+  return rw_weight;
+}
+
+int SplineReader::GetNPacked(const UInt_t* mask){
+  int n = 0;
+  for (size_t i = 0; i < fAllSplines.size(); i++){
+    if (mask[i / 32] & (1u << (i % 32))) n += fAllSplines[i].GetNPar();
+  }
+  return n;
+}
+
+bool SplineReader::HasGradient(){
+  for (size_t i = 0; i < fKernels.size(); i++){
+    if (!fKernels[i].grad) return false;
+  }
+  return true;
+}
+
+std::vector<std::string> SplineReader::GetGradSlotNames(){
+  std::vector<std::string> names;
+  for (size_t i = 0; i < fAllSplines.size(); i++){
+    for (int j = 0; j < fAllSplines[i].GetNDim(); j++){
+      names.push_back(fAllSplines[i].fSplitNames[j]);
+    }
+  }
+  return names;
+}
+
+double SplineReader::CombineGradient(double* grad) {
+
+  // prod_{j != i} w_j from a forward prefix and a running suffix product
+  size_t nspl = fAllSplines.size();
+  double prefix = 1.0;
+  for (size_t i = 0; i < nspl; i++) {
+    fGradPrefix[i] = prefix;
+    prefix *= fGradVals[i];
+  }
+
+  // Same clamp as CalcWeight, the weight is flat there
+  if (prefix <= 0.0) {
+    for (size_t i = 0; i < fGradTerms.size(); i++) grad[i] = 0.0;
+    return 1.0;
+  }
+
+  double suffix = 1.0;
+  for (size_t i = nspl; i-- > 0;) {
+    double others = fGradPrefix[i] * suffix;
+    for (int j = 0; j < fAllSplines[i].GetNDim(); j++) {
+      grad[fGradOffsets[i] + j] = fGradTerms[fGradOffsets[i] + j] * others;
+    }
+    suffix *= fGradVals[i];
+  }
+
+  return prefix;
+}
+
+double SplineReader::CalcWeightGradient(const float* coeffs, double* grad) {
+
+  for (size_t i = 0; i < fKernels.size(); i++) {
+    fGradVals[i] = fKernels[i].grad( &coeffs[fCoeffOffsets[i]], fKernelStates[i],
+                                     &fGradTerms[fGradOffsets[i]] );
+  }
+
+  return CombineGradient(grad);
+}
+
+double SplineReader::CalcWeightGradient(const UInt_t* mask, const float* packed, double* grad) {
+
+  int off = 0;
+  for (size_t i = 0; i < fAllSplines.size(); i++) {
+    if (!(mask[i / 32] & (1u << (i % 32)))) {
+      fGradVals[i] = 1.0;
+      for (int j = 0; j < fAllSplines[i].GetNDim(); j++) {
+        fGradTerms[fGradOffsets[i] + j] = 0.0;
+      }
+      continue;
+    }
+
+    fGradVals[i] = fKernels[i].grad( &packed[off], fKernelStates[i],
+                                     &fGradTerms[fGradOffsets[i]] );
+    off += fAllSplines[i].GetNPar();
+  }
+
+  return CombineGradient(grad);
+}
@@ -2,6 +2,7 @@
 #define SPLINEREADER_H
 // #include "FitWeight.h"
 #include "Spline.h"
+#include "SplineKernels.h"
 #include "TTree.h"
 #include "FitLogger.h"
 #include "NuisConfig.h"
@@ -24,6 +25,34 @@ public:
   int GetNPar();
   double CalcWeight(float* coeffs);
 
+  /// Batched weights for n dense coefficient sets spaced by stride floats
+  void CalcWeights(const float* coeffs, int n, int stride, double* weights);
+
+  /// Number of coefficients in each spline block
+  std::vector<int> GetNParList();
+
+  /// Evaluate from a packed response bitmask and non-zero coefficient blocks
+  double CalcWeight(const UInt_t* mask, const float* packed);
+
+  /// Number of packed coefficients for a given response bitmask
+  int GetNPacked(const UInt_t* mask);
+
+  /// True if every spline form has an analytic derivative kernel
+  bool HasGradient();
+
+  /// Gradient slots, one per spline dimension, named by the dial they follow
+  std::vector<std::string> GetGradSlotNames();
+
+  /// Weight and its derivative with respect to each gradient slot.
+  /// Slots of splines clamped to their limits have zero derivative.
+  double CalcWeightGradient(const float* coeffs, double* grad);
+
+  /// Packed response bitmask form of CalcWeightGradient
+  double CalcWeightGradient(const UInt_t* mask, const float* packed, double* grad);
+
+  /// Number of 32 bit words in a response bitmask
+  inline int GetNMaskWords() { return fAllSplines.empty() ? 1 : (fAllSplines.size() + 31) / 32; };
+
   std::vector<Spline> fAllSplines;
   std::vector<std::string> fSpline;
   std::vector<std::string> fType;
@@ -35,6 +64,26 @@ public:
 
   bool fNeedsReconfigure;
 
+  /// Bind each spline to its specialised kernel. Called when splines are added.
+  void BindKernels();
+
+  /// Refresh kernel states from the current spline dial values
+  void UpdateKernelStates();
+
+  std::vector<SplineUtils::SplineKernelBinding> fKernels;
+  std::vector<SplineUtils::SplineKernelState> fKernelStates;
+  std::vector<int> fCoeffOffsets;
+  std::vector<int> fGradOffsets;
+
+private:
+
+  /// Combine the per spline values and derivatives into the weight gradient
+  double CombineGradient(double* grad);
+
+  std::vector<double> fGradVals;
+  std::vector<double> fGradPrefix;
+  std::vector<float> fGradTerms;
+
 
 
 };
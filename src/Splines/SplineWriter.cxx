@@ -33,6 +33,13 @@ void SplineWriter::ReadWeightsFromTree(TTree* tr) {
 
 
 void SplineWriter::AddCoefficientsToTree(TTree* tr) {
+
+  // Packed formats store a response mask and only the non-zero blocks
+  if (fCoeffFormat != kDenseCoeff) {
+    fPacker.AddBranchesToTree(tr);
+    return;
+  }
+
   // Add only the fitted spline coefficients to the ttree
   std::cout << "Saving Spline Coeff to TTree = " << Form("SplineCoeff[%d]/F", fNCoEff) << std::endl;
   //  sleep(1);
@@ -40,6 +47,11 @@ void SplineWriter::AddCoefficientsToTree(TTree* tr) {
 }
 
 
+void SplineWriter::PackCoefficients() {
+  if (fCoeffFormat != kDenseCoeff) fPacker.Pack(fCoEffStorer);
+}
+
+
 void SplineWriter::SetupSplineSet() {
   std::cout << "Setting up spline set" << std::endl;
   fDrawSplines = FitPar::Config().GetParB("draw_splines");
@@ -52,6 +64,16 @@ void SplineWriter::SetupSplineSet() {
 
   std::cout << "NCoeff = " << fNCoEff << std::endl;
 
+  // Setup the coefficient packing if requested
+  fCoeffFormat = SplineUtils::ParseCoeffFormat(FitPar::Config().GetParS("spline_coeff_format"));
+  std::vector<double> coeffscale;
+  for (size_t i = 0; i < fAllSplines.size(); i++) {
+    for (int j = 0; j < fAllSplines[i].GetNPar(); j++) {
+      coeffscale.push_back(fAllSplines[i].GetCoeffScale(j));
+    }
+  }
+  fPacker.Setup(GetNParList(), fCoeffFormat, coeffscale);
+
   // Calculate the grid of parsets
   // Setup the list of parameter coefficients.
   std::vector<double> nomvals = fRW->GetDialValues();
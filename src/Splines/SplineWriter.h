@@ -4,6 +4,7 @@
 #include "Spline.h"
 
 #include "SplineUtils.h"
+#include "SplineCoeffPacker.h"
 #ifdef __MINUIT2_ENABLED__
 #include "TFitterMinuit.h"
 #endif
@@ -33,12 +34,14 @@ public:
   SplineWriter(FitWeight* fw) {
     fRW = fw;
     fDrawSplines = FitPar::Config().GetParB("drawsplines");
+    fCoeffFormat = SplineUtils::kDenseCoeff;
   };
   ~SplineWriter() {};
 
   void SetupSplineSet();
   void Write(std::string name);
   void AddCoefficientsToTree(TTree* tree);
+  void PackCoefficients();
   void FitSplinesForEvent(TCanvas* fitcanvas = NULL, bool saveplot = false);
   void AddWeightsToTree(TTree* tr);
   void ReadWeightsFromTree(TTree* tr);
@@ -57,6 +60,9 @@ public:
   //  double* fCoEffStorer;
   float* fCoEffStorer;
 
+  int fCoeffFormat;
+  SplineCoeffPacker fPacker;
+
   std::vector< std::vector<double> > fParVect;
   std::vector< int > fSetIndex;
   double* fWeightList;
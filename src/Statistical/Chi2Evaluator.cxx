@@ -0,0 +1,598 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include <algorithm>
+#include <limits>
+
+#include "Chi2Evaluator.h"
+#include "StatUtils.h"
+#include "NuisConfig.h"
+#include "TArrayD.h"
+#include "OpenMPWrapper.h"
+
+//*******************************************************************
+Chi2Evaluator::Chi2Evaluator() {
+//*******************************************************************
+  fCache = NULL;
+  Reset();
+}
+
+//*******************************************************************
+void Chi2Evaluator::Reset() {
+//*******************************************************************
+  fType = -1;
+  fNBins = 0;
+  fAddMCError = false;
+  fDataScale = 1.0;
+  fCovarScale = 1E76;
+  fGeneration = -1;
+  fCholOK = false;
+  fNThreads = 1;
+}
+
+//*******************************************************************
+void Chi2Evaluator::Setup(int type, int generation, TH1D* data, TMatrixDSym* mat,
+                          TH1I* mask, double data_scale, double covar_scale) {
+//*******************************************************************
+
+  fType = type;
+  fGeneration = generation;
+  fDataScale = data_scale;
+  fCovarScale = covar_scale;
+
+  // Same bin removal as StatUtils::ApplyHistogramMasking
+  fBins.clear();
+  for (int i = 0; i < data->GetNbinsX(); i++) {
+    if (mask and mask->GetBinContent(i + 1)) continue;
+    fBins.push_back(i + 1);
+  }
+
+  if (type == kChi2Cov) {
+    std::vector<int> rows;
+    for (int i = 0; i < int(fBins.size()); i++) rows.push_back(fBins[i] - 1);
+    if (SetupFromCache(rows)) return;
+  }
+
+  TMatrixDSym* masked = NULL;
+  if (type == kChi2Cov) {
+    masked = mask ? StatUtils::ApplyInvertedMatrixMasking(mat, mask)
+             : (TMatrixDSym*) mat->Clone();
+  } else if (type == kChi2SVD) {
+    masked = mask ? StatUtils::ApplyMatrixMasking(mat, mask)
+             : (TMatrixDSym*) mat->Clone();
+  }
+
+  SetupMatrix(masked);
+  if (masked) delete masked;
+
+  // As in StatUtils before, a masked diagonal chi2 uses the data errors only
+  if (type == kChi2Diag and mask) fAddMCError = false;
+}
+
+//*******************************************************************
+void Chi2Evaluator::Setup(int type, int generation, TH2D* data, TMatrixDSym* mat,
+                          TH2I* map, TH2I* mask, double data_scale, double covar_scale) {
+//*******************************************************************
+
+  fType = type;
+  fGeneration = generation;
+  fDataScale = data_scale;
+  fCovarScale = covar_scale;
+
+  // Map index -> global 2D bin, the ordering used by StatUtils::MapToTH1D
+  std::vector<int> mapbins;
+  std::vector<bool> mapmask;
+  StatUtils::GenerateMapBins(data, map, mask, mapbins, mapmask);
+
+  int nmap = mapbins.size();
+  fBins.clear();
+  std::vector<int> rows;
+  for (int i = 0; i < nmap; i++) {
+    if (mapmask[i] or mapbins[i] < 0) continue;
+    fBins.push_back(mapbins[i]);
+    rows.push_back(i);
+  }
+
+  if (type == kChi2Cov and SetupFromCache(rows)) return;
+
+  TH1I* mask_1D = mask ? StatUtils::MapToMask(mask, map) : NULL;
+
+  TMatrixDSym* masked = NULL;
+  if (type == kChi2Cov) {
+    masked = mask_1D ? StatUtils::ApplyInvertedMatrixMasking(mat, mask_1D)
+             : (TMatrixDSym*) mat->Clone();
+  } else if (type == kChi2SVD) {
+    masked = mask_1D ? StatUtils::ApplyMatrixMasking(mat, mask_1D)
+             : (TMatrixDSym*) mat->Clone();
+  }
+
+  SetupMatrix(masked);
+  if (masked) delete masked;
+  if (mask_1D) delete mask_1D;
+
+  // As in StatUtils before, a masked diagonal chi2 uses the data errors only
+  if (type == kChi2Diag and mask) fAddMCError = false;
+}
+
+//*******************************************************************
+bool Chi2Evaluator::SetupFromCache(const std::vector<int>& rows) {
+//*******************************************************************
+
+  if (!fCache or !fCache->IsSetup(fGeneration)) return false;
+
+  TMatrixDSym* inv = fCache->GetMaskedInverse(rows);
+  if (!inv) return false;
+
+  SetupMatrix(inv, FitPar::Config().GetSnapshot().addmcerror ?
+              fCache->GetMasked(rows) : NULL);
+  return true;
+}
+
+//*******************************************************************
+void Chi2Evaluator::SetupMatrix(TMatrixDSym* mat, TMatrixDSym* cov) {
+//*******************************************************************
+
+  fNBins = fBins.size();
+  fAddMCError = FitPar::Config().GetSnapshot().addmcerror;
+
+  fData.assign(fNBins, 0.0);
+  fDataErr.assign(fNBins, 0.0);
+  fMC.assign(fNBins, 0.0);
+  fMCErr.assign(fNBins, 0.0);
+  fDiff.assign(fNBins, 0.0);
+
+  // NaN never compares equal so every term is computed on the first call
+  fDataRef.assign(fNBins, std::numeric_limits<double>::quiet_NaN());
+  fDataLog.assign(fNBins, 0.0);
+
+  fPacked.clear();
+  fMaskedInv.clear();
+  fCov.clear();
+  fChol.clear();
+  fCholWork.clear();
+  fCholVec.clear();
+  fCholOK = false;
+  fU.clear();
+  fSig.clear();
+
+  if (fType == kChi2Cov) {
+    if (mat->GetNrows() != fNBins) {
+      ERR(FTL) << "Chi2Evaluator covariance has " << mat->GetNrows()
+               << " rows but " << fNBins << " bins are used." << std::endl;
+      throw;
+    }
+
+    // Upper triangle, off diagonal terms doubled so the quadratic form
+    // only needs one pass over j >= i.
+    const double* m = mat->GetMatrixArray();
+    fPacked.reserve(fNBins * (fNBins + 1) / 2);
+    for (int i = 0; i < fNBins; i++) {
+      fPacked.push_back(m[i * fNBins + i] * fCovarScale);
+      for (int j = i + 1; j < fNBins; j++) {
+        fPacked.push_back(2.0 * m[i * fNBins + j] * fCovarScale);
+      }
+    }
+
+    fNThreads = omp_get_max_threads();
+    fQuadWork.assign(fNBins * fNThreads, 0.0);
+
+    // MC errors are added to the covariance itself. Invert back once here,
+    // unless it is already known, and keep its Cholesky factor so each call
+    // only needs an update.
+    if (fAddMCError) {
+      fMaskedInv.assign(mat->GetMatrixArray(),
+                        mat->GetMatrixArray() + fNBins * fNBins);
+
+      if (cov) {
+        fCov.assign(cov->GetMatrixArray(), cov->GetMatrixArray() + fNBins * fNBins);
+      } else {
+        TMatrixDSym* calc_cov = StatUtils::GetInvert(mat);
+        fCov.assign(calc_cov->GetMatrixArray(),
+                    calc_cov->GetMatrixArray() + fNBins * fNBins);
+        delete calc_cov;
+      }
+
+      fChol = fCov;
+      fCholOK = CholeskyFactor(fNBins ? &fChol[0] : NULL, fNBins);
+      fCholWork.assign(fNBins * fNBins, 0.0);
+      fCholVec.assign(fNBins, 0.0);
+
+      if (!fCholOK) {
+        ERR(WRN) << "Chi2Evaluator covariance is not positive definite, "
+                 << "addmcerror will use full matrix inversion." << std::endl;
+      }
+    }
+
+  } else if (fType == kChi2SVD) {
+    TDecompSVD LU = TDecompSVD(*mat);
+    LU.Decompose();
+    TMatrixD U = LU.GetU();
+    TVectorD S = LU.GetSig();
+
+    fU.assign(U.GetMatrixArray(), U.GetMatrixArray() + fNBins * fNBins);
+    fSig.assign(S.GetMatrixArray(), S.GetMatrixArray() + fNBins);
+  }
+}
+
+//*******************************************************************
+void Chi2Evaluator::Gather(TH1* data, TH1* mc, double mcscale) {
+//*******************************************************************
+
+  // TH1D and TH2D keep their contents in TArrayD, indexed by global bin
+  const TArrayD* dataarr = dynamic_cast<const TArrayD*>(data);
+  const TArrayD* mcarr = dynamic_cast<const TArrayD*>(mc);
+
+  if (dataarr and mcarr) {
+    const double* dt = dataarr->GetArray();
+    const double* mcv = mcarr->GetArray();
+    for (int i = 0; i < fNBins; i++) {
+      fData[i] = dt[fBins[i]];
+      fMC[i] = mcv[fBins[i]] * mcscale;
+    }
+  } else {
+    for (int i = 0; i < fNBins; i++) {
+      fData[i] = data->GetBinContent(fBins[i]);
+      fMC[i] = mc->GetBinContent(fBins[i]) * mcscale;
+    }
+  }
+
+  if (fType == kChi2Diag) {
+    for (int i = 0; i < fNBins; i++) fDataErr[i] = data->GetBinError(fBins[i]);
+  }
+  if (fAddMCError) {
+    for (int i = 0; i < fNBins; i++) fMCErr[i] = mc->GetBinError(fBins[i]) * mcscale;
+  }
+}
+
+//*******************************************************************
+double Chi2Evaluator::Eval(TH1* data, TH1* mc, double mcscale) {
+//*******************************************************************
+
+  Gather(data, mc, mcscale);
+
+  switch (fType) {
+  case kChi2Diag:      return EvalDiag();
+  case kChi2Cov:       return EvalCov();
+  case kChi2EventRate: return EvalEventRate();
+  case kChi2SVD:       return EvalSVD();
+  }
+
+  ERR(FTL) << "Chi2Evaluator::Eval called before Setup" << std::endl;
+  throw;
+  return 0.0;
+}
+
+//*******************************************************************
+bool Chi2Evaluator::CanProfile() const {
+//*******************************************************************
+  if (fType == kChi2Diag or fType == kChi2EventRate) return true;
+  return (fType == kChi2Cov and !fAddMCError);
+}
+
+//*******************************************************************
+double Chi2Evaluator::ProfileScale(TH1* data, TH1* mc) {
+//*******************************************************************
+
+  if (!CanProfile()) {
+    ERR(FTL) << "Chi2Evaluator cannot profile the MC scale for this chi2" << std::endl;
+    throw;
+  }
+
+  Gather(data, mc);
+
+  // Same bins as the chi2 itself, see EvalDiag and EvalEventRate
+  double num = 0.0;
+  double den = 0.0;
+  if (fType == kChi2Diag) {
+    for (int i = 0; i < fNBins; i++) {
+      double err = fDataErr[i];
+      if (err <= 0.0 or fData[i] == 0.0) continue;
+      num += fMC[i] * fData[i] / (err * err);
+      den += fMC[i] * fMC[i] / (err * err);
+    }
+
+  } else if (fType == kChi2EventRate) {
+    for (int i = 0; i < fNBins; i++) {
+      if (fMC[i] <= 0) continue;
+      num += fData[i];
+      den += fMC[i];
+    }
+
+  } else if (fNBins > 0) {
+    // fDiff holds V^-1 m, the data scale cancels in the ratio
+    PackedSymMult(&fPacked[0], &fMC[0], fNBins, &fDiff[0]);
+    for (int i = 0; i < fNBins; i++) {
+      num += fData[i] * fDiff[i];
+      den += fMC[i] * fDiff[i];
+    }
+  }
+
+  if (den <= 0.0) return 0.0;
+  return num / den;
+}
+
+//*******************************************************************
+void Chi2Evaluator::PackedSymMult(const double* packed, const double* x, int n,
+                                  double* y) {
+//*******************************************************************
+
+  for (int i = 0; i < n; i++) y[i] = 0.0;
+
+  // Off diagonal terms are stored doubled
+  const double* row = packed;
+  for (int i = 0; i < n; i++) {
+    double xi = 0.5 * x[i];
+    double sum = row[0] * x[i];
+    for (int j = i + 1; j < n; j++) {
+      sum += 0.5 * row[j - i] * x[j];
+      y[j] += row[j - i] * xi;
+    }
+    y[i] += sum;
+    row += n - i;
+  }
+}
+
+//*******************************************************************
+double Chi2Evaluator::EvalDiag() {
+//*******************************************************************
+
+  double chi2 = 0.0;
+  for (int i = 0; i < fNBins; i++) {
+    double err = fDataErr[i];
+    if (fAddMCError and err > 0.0) err = sqrt(err * err + fMCErr[i] * fMCErr[i]);
+
+    // Ignore bins with zero data or zero bin error
+    if (err <= 0.0 or fData[i] == 0.0) continue;
+
+    double diff = fData[i] - fMC[i];
+    chi2 += (diff * diff) / (err * err);
+  }
+  return chi2;
+}
+
+//*******************************************************************
+double Chi2Evaluator::EvalCov() {
+//*******************************************************************
+
+  // Bins with zero data and zero MC have a zero difference so they drop
+  // out of the quadratic form without a separate check.
+  for (int i = 0; i < fNBins; i++) {
+    fDiff[i] = (fData[i] - fMC[i]) * fDataScale;
+  }
+
+  double chi2 = 0.0;
+
+  if (fNBins == 0) return 0.0;
+
+  if (!fAddMCError) {
+    return PackedQuadForm(&fPacked[0], &fDiff[0], fNBins, &fQuadWork[0], fNThreads);
+  }
+
+  if (!fCholOK) return EvalCovInvert();
+
+  // addmcerror : chi2 = r^T (C + s e^2)^-1 r s, from the factor of C + s e^2
+  int nerr = 0;
+  for (int i = 0; i < fNBins; i++) {
+    if (fMCErr[i] != 0.0) nerr++;
+  }
+
+  int n = fNBins;
+  double* l = &fCholWork[0];
+  double* x = &fCholVec[0];
+
+  // A diagonal term on bin i costs ~(n-i)^2 as a rank one update,
+  // refactorising costs ~n^3/3.
+  if (6 * nerr < n) {
+    std::copy(fChol.begin(), fChol.end(), fCholWork.begin());
+    for (int i = 0; i < n; i++) {
+      if (fMCErr[i] == 0.0) continue;
+      std::fill(x + i, x + n, 0.0);
+      x[i] = fMCErr[i] * sqrt(fCovarScale);
+      CholeskyUpdate(l, x, n, i);
+    }
+  } else {
+    std::copy(fCov.begin(), fCov.end(), fCholWork.begin());
+    for (int i = 0; i < n; i++) {
+      l[i * n + i] += fMCErr[i] * fMCErr[i] * fCovarScale;
+    }
+    if (!CholeskyFactor(l, n)) return EvalCovInvert();
+  }
+
+  // Forward solve L y = r, chi2 = y^T y
+  for (int i = 0; i < n; i++) {
+    const double* row = l + i * n;
+    double sum = fDiff[i];
+    for (int k = 0; k < i; k++) sum -= row[k] * x[k];
+    x[i] = sum / row[i];
+    chi2 += x[i] * x[i];
+  }
+
+  return chi2 * fCovarScale;
+}
+
+//*******************************************************************
+double Chi2Evaluator::PackedQuadForm(const double* packed, const double* r, int n,
+                                     double* work, int nthreads) {
+//*******************************************************************
+
+  // r^T P r = sum_j r_j w_j with w_j = sum_{i <= j} P_ij r_i. w is built one
+  // block of rows at a time as w += P_i. r_i, which streams through the
+  // packed rows once and keeps the inner loop free of reductions.
+  const int nblock = 4;
+  int nblocks = (n + nblock - 1) / nblock;
+  double chi2 = 0.0;
+
+#ifdef __USE_OPENMP__
+  #pragma omp parallel for schedule(static, 1) num_threads(nthreads) \
+    reduction(+ : chi2) if (n >= 256 and nthreads > 1)
+#endif
+  for (int t = 0; t < nthreads; t++) {
+    double* w = work + t * n;
+    for (int j = 0; j < n; j++) w[j] = 0.0;
+
+    // Interleave blocks over threads to balance the triangle
+    for (int b = t; b < nblocks; b += nthreads) {
+      int i0 = b * nblock;
+      int i1 = i0 + nblock < n ? i0 + nblock : n;
+
+      // Row i starts at offset i*n - i*(i-1)/2, shift so p[j] = P_ij
+      const double* p[nblock];
+      for (int i = i0; i < i1; i++) {
+        p[i - i0] = packed + (i * n - (i * (i - 1)) / 2) - i;
+      }
+
+      // Triangle inside the block
+      for (int i = i0; i < i1; i++) {
+        const double* pi = p[i - i0];
+        for (int j = i; j < i1; j++) w[j] += pi[j] * r[i];
+      }
+
+      if (i1 - i0 < nblock) continue;
+
+      // Full block rows beyond it
+      const double* p0 = p[0];
+      const double* p1 = p[1];
+      const double* p2 = p[2];
+      const double* p3 = p[3];
+      double r0 = r[i0];
+      double r1 = r[i0 + 1];
+      double r2 = r[i0 + 2];
+      double r3 = r[i0 + 3];
+      for (int j = i1; j < n; j++) {
+        w[j] += p0[j] * r0 + p1[j] * r1 + p2[j] * r2 + p3[j] * r3;
+      }
+    }
+
+    double sum = 0.0;
+    for (int j = 0; j < n; j++) sum += r[j] * w[j];
+    chi2 += sum;
+  }
+
+  return chi2;
+}
+
+//*******************************************************************
+double Chi2Evaluator::EvalCovInvert() {
+//*******************************************************************
+
+  // invert, add the MC errors to the diagonal and invert back
+  TMatrixDSym inv(fNBins, &fMaskedInv[0]);
+  TMatrixDSym* cov = StatUtils::GetInvert(&inv);
+  for (int i = 0; i < fNBins; i++) {
+    double mcerr = fMCErr[i] * sqrt(fCovarScale);
+    (*cov)(i, i) += mcerr * mcerr;
+  }
+  TMatrixDSym* newinv = StatUtils::GetInvert(cov);
+
+  double chi2 = 0.0;
+  for (int i = 0; i < fNBins; i++) {
+    for (int j = 0; j < fNBins; j++) {
+      chi2 += fDiff[i] * (*newinv)(i, j) * fCovarScale * fDiff[j];
+    }
+  }
+
+  delete cov;
+  delete newinv;
+  return chi2;
+}
+
+//*******************************************************************
+bool Chi2Evaluator::CholeskyFactor(double* a, int n) {
+//*******************************************************************
+
+  for (int j = 0; j < n; j++) {
+    double* rowj = a + j * n;
+
+    double diag = rowj[j];
+    for (int k = 0; k < j; k++) diag -= rowj[k] * rowj[k];
+    if (!(diag > 0.0)) return false;
+    rowj[j] = sqrt(diag);
+
+    for (int i = j + 1; i < n; i++) {
+      double* rowi = a + i * n;
+      double sum = rowi[j];
+      for (int k = 0; k < j; k++) sum -= rowi[k] * rowj[k];
+      rowi[j] = sum / rowj[j];
+    }
+  }
+  return true;
+}
+
+//*******************************************************************
+void Chi2Evaluator::CholeskyUpdate(double* l, double* x, int n, int first) {
+//*******************************************************************
+
+  for (int k = first; k < n; k++) {
+    double lkk = l[k * n + k];
+    double r = sqrt(lkk * lkk + x[k] * x[k]);
+    double c = r / lkk;
+    double s = x[k] / lkk;
+    l[k * n + k] = r;
+
+    for (int j = k + 1; j < n; j++) {
+      double& ljk = l[j * n + k];
+      ljk = (ljk + s * x[j]) / c;
+      x[j] = c * x[j] - s * ljk;
+    }
+  }
+}
+
+//*******************************************************************
+double Chi2Evaluator::EvalEventRate() {
+//*******************************************************************
+
+  // 2 (mc - dt + dt log(dt/mc)), with dt log dt cached while the data is
+  // unchanged so only log(mc) is needed per call.
+  double chi2 = 0.0;
+  for (int i = 0; i < fNBins; i++) {
+    double dt = fData[i];
+    double mc = fMC[i];
+
+    if (dt != fDataRef[i]) {
+      fDataRef[i] = dt;
+      fDataLog[i] = dt > 0 ? dt * log(dt) : 0.0;
+    }
+
+    if (mc <= 0) continue;
+
+    double term = mc - dt;
+    if (dt > 0) term += fDataLog[i] - dt * log(mc);
+    chi2 += term;
+  }
+  return 2 * chi2;
+}
+
+//*******************************************************************
+double Chi2Evaluator::EvalSVD() {
+//*******************************************************************
+
+  double chi2 = 0.0;
+  for (int i = 0; i < fNBins; i++) {
+
+    // Rotate basis of Data - MC
+    double rotated = 0.0;
+    for (int j = 0; j < fNBins; j++) {
+      rotated += (fData[j] - fMC[j]) * fU[j * fNBins + i];
+    }
+
+    // Divide by rotated error
+    chi2 += rotated * rotated * fCovarScale / fSig[i];
+  }
+  return chi2;
+}
@@ -0,0 +1,178 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef CHI2EVALUATOR_H
+#define CHI2EVALUATOR_H
+
+#include <vector>
+
+#include "TH1.h"
+#include "TH1D.h"
+#include "TH1I.h"
+#include "TH2D.h"
+#include "TH2I.h"
+#include "TMatrixDSym.h"
+
+#include "CovarianceCache.h"
+
+/*!
+ *  \addtogroup Statistical
+ *  @{
+ */
+
+//! Precompiled chi2 for one data histogram.
+//!
+//! Masking, 2D bin maps and covariance inversion are resolved once in Setup.
+//! The masked inverse covariance is kept as a packed upper triangle with the
+//! off diagonal terms pre-doubled. Eval only reads bin contents into
+//! preallocated buffers and does not allocate. Bin contents are read straight
+//! from the histogram arrays, and data dependent logs for the event rate
+//! likelihood are only recomputed for bins whose data changed.
+//!
+//! With addmcerror a covariance chi2 keeps the Cholesky factor of the masked
+//! data covariance. The MC errors are folded in each call by rank one factor
+//! updates when few bins carry them, or by refactorising C + diag(mcerr^2)
+//! otherwise, and the quadratic form comes from one triangular solve.
+class Chi2Evaluator {
+public:
+
+  enum Chi2Type {
+    kChi2Diag = 0,   //!< Diagonal data errors
+    kChi2Cov,        //!< Inverted covariance
+    kChi2EventRate,  //!< Poisson -2lnL on raw event rates
+    kChi2SVD         //!< SVD rotated covariance
+  };
+
+  Chi2Evaluator();
+  ~Chi2Evaluator() {};
+
+  //! Setup for 1D histograms. mat is the inverted covariance for kChi2Cov,
+  //! the covariance for kChi2SVD and ignored otherwise. generation is the
+  //! owner's counter for its covariance, mask and map, bumped whenever any of
+  //! them is replaced or changed. One off evaluations pass -1.
+  void Setup(int type, int generation, TH1D* data, TMatrixDSym* mat,
+             TH1I* mask = NULL, double data_scale = 1, double covar_scale = 1E76);
+
+  //! Setup for 2D histograms flattened through a bin map (see StatUtils::GenerateMap)
+  void Setup(int type, int generation, TH2D* data, TMatrixDSym* mat, TH2I* map,
+             TH2I* mask = NULL, double data_scale = 1, double covar_scale = 1E76);
+
+  //! Check the evaluator was built for this type and generation of the inputs
+  inline bool IsSetup(int type, int generation) const {
+    return (fGeneration >= 0 and fType == type and fGeneration == generation);
+  };
+
+  //! Forget the current setup, forcing a rebuild on the next IsSetup check
+  void Reset();
+
+  //! Covariance forms of the sample. A kChi2Cov setup at a generation the cache
+  //! is current for masks the covariance directly rather than inverting twice,
+  //! and takes the covariance for addmcerror from it. Kept across Reset.
+  inline void SetCovarianceCache(CovarianceCache* cache) { fCache = cache; };
+
+  //! Chi2 of mc * mcscale against data. Both must have the binning used in Setup.
+  double Eval(TH1* data, TH1* mc, double mcscale = 1.0);
+
+  //! Whether ProfileScale has a closed form for this setup. Not the case for
+  //! SVD or a covariance with addmcerror.
+  bool CanProfile() const;
+
+  //! Scale of mc minimising the chi2 : r^T V^-1 m / m^T V^-1 m for the
+  //! Gaussian forms, sum(data) / sum(mc) over the used bins for event rates.
+  //! Returns 0 if the MC is empty in the used bins.
+  double ProfileScale(TH1* data, TH1* mc);
+
+  //! Number of bins entering the chi2
+  inline int GetNBins() const { return fNBins; };
+
+  //! r^T P r for P stored as a packed upper triangle, row by row, with the
+  //! off diagonal terms already doubled (the fPacked layout).
+  //! work must hold n * nthreads doubles. Rows are processed four at a time
+  //! as column updates, so inner loops vectorise without reassociating sums.
+  //! With OpenMP enabled rows are split over nthreads for n >= 256.
+  static double PackedQuadForm(const double* packed, const double* r, int n,
+                               double* work, int nthreads = 1);
+
+private:
+
+  //! Common setup once the global bins have been chosen. cov is the
+  //! covariance mat inverts if known, otherwise it is recovered from mat.
+  void SetupMatrix(TMatrixDSym* mat, TMatrixDSym* cov = NULL);
+
+  //! Masked inverse and covariance for the covariance rows used, taken from
+  //! fCache if it is current for fGeneration. Returns false if the cache can't
+  //! be used.
+  bool SetupFromCache(const std::vector<int>& rows);
+
+  //! Read data and MC bins into the evaluation buffers
+  void Gather(TH1* data, TH1* mc, double mcscale = 1.0);
+
+  //! y = P x for the fPacked layout
+  static void PackedSymMult(const double* packed, const double* x, int n, double* y);
+
+  double EvalDiag();
+  double EvalCov();
+  double EvalEventRate();
+  double EvalSVD();
+
+  //! In place Cholesky of the row major n x n matrix a, lower triangle only.
+  //! Returns false if a is not positive definite.
+  static bool CholeskyFactor(double* a, int n);
+
+  //! L -> L' with L'L'^T = LL^T + x x^T, x is overwritten.
+  //! Only rows from first onwards are touched, x must be zero before that.
+  static void CholeskyUpdate(double* l, double* x, int n, int first);
+
+  //! Fallback for a covariance that is not positive definite
+  double EvalCovInvert();
+
+  int fType;
+  int fNBins;
+  bool fAddMCError;
+  double fDataScale;
+  double fCovarScale;
+
+  int fGeneration;  //!< Owner generation of the setup inputs, used by IsSetup
+
+  std::vector<int> fBins;          //!< Global histogram bin of each chi2 bin
+  std::vector<double> fPacked;     //!< Scaled inverse, packed upper triangle
+  std::vector<double> fMaskedInv;  //!< Unscaled masked inverse, row major (addmcerror)
+  std::vector<double> fCov;        //!< Unscaled masked covariance, row major (addmcerror)
+  std::vector<double> fChol;       //!< Cholesky factor of fCov, lower, row major
+  std::vector<double> fCholWork;   //!< Per call factor including MC errors
+  std::vector<double> fCholVec;    //!< Update vector / solve buffer
+  bool fCholOK;                    //!< fCov was positive definite
+  std::vector<double> fU;          //!< SVD rotation, row major
+  std::vector<double> fSig;        //!< SVD singular values
+
+  std::vector<double> fData;
+  std::vector<double> fDataErr;
+  std::vector<double> fMC;
+  std::vector<double> fMCErr;
+  std::vector<double> fDiff;
+  std::vector<double> fDataRef;    //!< Data each fDataLog entry was computed for
+  std::vector<double> fDataLog;    //!< d log d for the event rate likelihood
+  std::vector<double> fQuadWork;   //!< PackedQuadForm workspace
+  int fNThreads;
+
+  CovarianceCache* fCache;         //!< Not owned, may be NULL
+};
+
+/*! @} */
+#endif
@@ -0,0 +1,182 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include <cmath>
+
+#include "CovarianceCache.h"
+#include "StatUtils.h"
+#include "TMath.h"
+
+//*******************************************************************
+CovarianceCache::CovarianceCache() {
+//*******************************************************************
+  fFull = NULL;
+  fInv = NULL;
+  fDecomp = NULL;
+  fMasked = NULL;
+  fMaskedInv = NULL;
+  Reset();
+}
+
+//*******************************************************************
+CovarianceCache::~CovarianceCache() {
+//*******************************************************************
+  Reset();
+}
+
+//*******************************************************************
+void CovarianceCache::Clear(TMatrixDSym*& mat) {
+//*******************************************************************
+  if (mat) delete mat;
+  mat = NULL;
+}
+
+//*******************************************************************
+void CovarianceCache::Reset() {
+//*******************************************************************
+  fGeneration = -1;
+  fMaskRows.clear();
+
+  Clear(fFull);
+  Clear(fInv);
+  Clear(fDecomp);
+  Clear(fMasked);
+  Clear(fMaskedInv);
+}
+
+//*******************************************************************
+void CovarianceCache::Setup(int generation, TMatrixDSym* full, TMatrixDSym* inv,
+                            TMatrixDSym* decomp) {
+//*******************************************************************
+  Reset();
+
+  fGeneration = generation;
+  fFull = new TMatrixDSym(*full);
+  if (inv) fInv = new TMatrixDSym(*inv);
+  if (decomp) fDecomp = new TMatrixDSym(*decomp);
+}
+
+//*******************************************************************
+TMatrixDSym* CovarianceCache::GetFull() {
+//*******************************************************************
+  return fFull;
+}
+
+//*******************************************************************
+TMatrixDSym* CovarianceCache::GetInverse() {
+//*******************************************************************
+  if (!fInv and fFull) fInv = StatUtils::GetInvert(fFull);
+  return fInv;
+}
+
+//*******************************************************************
+TMatrixDSym* CovarianceCache::GetDecomp() {
+//*******************************************************************
+  if (!fDecomp and fFull) fDecomp = StatUtils::GetDecomp(fFull);
+  return fDecomp;
+}
+
+//*******************************************************************
+bool CovarianceCache::IsAllRows(const std::vector<int>& rows) const {
+//*******************************************************************
+  if (!fFull or int(rows.size()) != fFull->GetNrows()) return false;
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (rows[i] != int(i)) return false;
+  }
+  return true;
+}
+
+//*******************************************************************
+TMatrixDSym* CovarianceCache::GetMasked(const std::vector<int>& rows) {
+//*******************************************************************
+  if (!fFull) return NULL;
+  if (IsAllRows(rows)) return fFull;
+
+  if (fMasked and rows == fMaskRows) return fMasked;
+
+  Clear(fMasked);
+  Clear(fMaskedInv);
+  fMaskRows = rows;
+
+  int n = rows.size();
+  fMasked = new TMatrixDSym(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      (*fMasked)(i, j) = (*fFull)(rows[i], rows[j]);
+    }
+  }
+  return fMasked;
+}
+
+//*******************************************************************
+TMatrixDSym* CovarianceCache::GetMaskedInverse(const std::vector<int>& rows) {
+//*******************************************************************
+  if (IsAllRows(rows)) return GetInverse();
+
+  TMatrixDSym* masked = GetMasked(rows);
+  if (!fMaskedInv and masked) fMaskedInv = StatUtils::GetInvert(masked);
+  return fMaskedInv;
+}
+
+//*******************************************************************
+void CovarianceCache::Scale(double scale) {
+//*******************************************************************
+  if (fFull) (*fFull) *= scale;
+  if (fInv) (*fInv) *= 1.0 / scale;
+  if (fDecomp) (*fDecomp) *= sqrt(scale);
+  if (fMasked) (*fMasked) *= scale;
+  if (fMaskedInv) (*fMaskedInv) *= 1.0 / scale;
+}
+
+//*******************************************************************
+void CovarianceCache::ScaleBins(const std::vector<double>& alpha) {
+//*******************************************************************
+
+  if (!fFull) return;
+  int n = fFull->GetNrows();
+
+  // D C D has inverse D^-1 C^-1 D^-1 only if no alpha is zero
+  bool invertible = (int(alpha.size()) == n);
+  for (size_t i = 0; i < alpha.size(); i++) {
+    if (alpha[i] == 0.0 or !TMath::Finite(alpha[i])) invertible = false;
+  }
+
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      (*fFull)(i, j) *= alpha[i] * alpha[j];
+      if (fInv and invertible) (*fInv)(i, j) /= alpha[i] * alpha[j];
+
+      // C = U^T U, so D C D = (U D)^T (U D)
+      if (fDecomp) (*fDecomp)(j, i) *= alpha[i];
+    }
+  }
+  if (!invertible) Clear(fInv);
+
+  if (fMasked) {
+    int m = fMaskRows.size();
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < m; j++) {
+        double a = alpha[fMaskRows[i]] * alpha[fMaskRows[j]];
+        (*fMasked)(i, j) *= a;
+        if (fMaskedInv and invertible) (*fMaskedInv)(i, j) /= a;
+      }
+    }
+  }
+  if (!invertible) Clear(fMaskedInv);
+}
@@ -0,0 +1,101 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef COVARIANCECACHE_H
+#define COVARIANCECACHE_H
+
+#include <vector>
+
+#include "TMatrixDSym.h"
+
+/*!
+ *  \addtogroup Statistical
+ *  @{
+ */
+
+//! Full, inverted, decomposed and masked forms of one sample covariance.
+//!
+//! Forms are computed on first use and kept. The masked forms are kept for the
+//! last set of rows asked for. Scale and ScaleBins rescale every cached form
+//! analytically, so a rescaled covariance needs no new inversion or
+//! decomposition. The cache holds its own copies. The owner keeps a generation
+//! counter bumped whenever it replaces or changes its matrices, and the cache
+//! is only current for the generation it was seeded or marked with.
+class CovarianceCache {
+public:
+
+  CovarianceCache();
+  ~CovarianceCache();
+
+  //! Seed from a full covariance at the owner's generation. inv and decomp, if
+  //! given, must be its inverse and StatUtils::GetDecomp and are copied rather
+  //! than recomputed. While the generation is current the owner's inverse
+  //! covariance must be the inverse of full.
+  void Setup(int generation, TMatrixDSym* full, TMatrixDSym* inv = NULL,
+             TMatrixDSym* decomp = NULL);
+
+  //! Check the cache is current for this generation of the owner's matrices
+  inline bool IsSetup(int generation) const {
+    return (fGeneration >= 0 and fGeneration == generation);
+  };
+
+  //! Mark the cache current for a new generation, once the owner has changed
+  //! its matrices in step with Scale or ScaleBins
+  inline void SetGeneration(int generation) { fGeneration = generation; };
+
+  //! Drop every cached form
+  void Reset();
+
+  TMatrixDSym* GetFull();
+  TMatrixDSym* GetInverse();
+  TMatrixDSym* GetDecomp();
+
+  //! Covariance restricted to rows, and the inverse of that. Masking the
+  //! covariance directly avoids inverting the inverse first.
+  TMatrixDSym* GetMasked(const std::vector<int>& rows);
+  TMatrixDSym* GetMaskedInverse(const std::vector<int>& rows);
+
+  //! C -> scale * C for every cached form
+  void Scale(double scale);
+
+  //! C_ij -> alpha_i alpha_j C_ij for every cached form. Inverses are dropped
+  //! and recomputed on use if an alpha is zero.
+  void ScaleBins(const std::vector<double>& alpha);
+
+private:
+
+  //! Delete a cached form and clear the pointer
+  static void Clear(TMatrixDSym*& mat);
+
+  //! Whether rows is every row in order
+  bool IsAllRows(const std::vector<int>& rows) const;
+
+  int fGeneration;  //!< Owner generation the forms are current for, -1 if none
+
+  TMatrixDSym* fFull;
+  TMatrixDSym* fInv;
+  TMatrixDSym* fDecomp;
+
+  std::vector<int> fMaskRows; //!< Rows of the masked forms
+  TMatrixDSym* fMasked;
+  TMatrixDSym* fMaskedInv;
+};
+
+/*! @} */
+#endif
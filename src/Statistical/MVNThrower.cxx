@@ -0,0 +1,263 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "MVNThrower.h"
+#include "StatUtils.h"
+#include "FitLogger.h"
+#include "TArrayD.h"
+#include "TRandom.h"
+#include "OpenMPWrapper.h"
+
+// Golden ratio increment and finaliser of SplitMix64
+static const ULong64_t kMVNGolden = 0x9E3779B97F4A7C15ULL;
+
+static inline ULong64_t MVNMix(ULong64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Uniform in (0, 1), never 0 so the log in Box-Muller is safe
+static inline double MVNUniform(ULong64_t key, ULong64_t count) {
+  return ((MVNMix(key + count * kMVNGolden) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+//*******************************************************************
+MVNThrower::MVNThrower() {
+//*******************************************************************
+  fSeed = 0;
+  fSeedSet = false;
+  fNextToy = 0;
+  Reset();
+}
+
+//*******************************************************************
+void MVNThrower::Reset() {
+//*******************************************************************
+  fSource = NULL;
+  fNBins = 0;
+  fBins.clear();
+  fDecomp.clear();
+  fRowBegin.clear();
+  fRowEnd.clear();
+  fBatchSize = 0;
+  fBatchFirst = 0;
+  fBatchToys = 0;
+}
+
+//*******************************************************************
+bool MVNThrower::IsSetup(TMatrixDSym* cov) const {
+//*******************************************************************
+  return (fSource and fSource == cov);
+}
+
+//*******************************************************************
+void MVNThrower::SetSeed(ULong64_t seed) {
+//*******************************************************************
+  fSeed = seed;
+  fSeedSet = true;
+  fNextToy = 0;
+  fBatchToys = 0;
+}
+
+//*******************************************************************
+void MVNThrower::Setup(TMatrixDSym* cov, TH1D* hist, TH1I* mask, double scale) {
+//*******************************************************************
+
+  std::vector<int> bins;
+  for (int i = 0; i < hist->GetNbinsX(); i++) {
+    if (mask and mask->GetBinContent(i + 1)) continue;
+    bins.push_back(i + 1);
+  }
+
+  if (!mask) {
+    Setup(cov, bins, scale);
+    return;
+  }
+
+  TMatrixDSym* calc_cov = StatUtils::ApplyMatrixMasking(cov, mask);
+  Setup(calc_cov, bins, scale);
+  delete calc_cov;
+
+  // Keyed on the covariance the caller holds, not the masked copy
+  fSource = cov;
+}
+
+//*******************************************************************
+void MVNThrower::Setup(TMatrixDSym* cov, const std::vector<int>& bins, double scale) {
+//*******************************************************************
+
+  // Same decomposition the single throws in StatUtils use, cov = U^T U
+  TMatrixDSym* decomp = StatUtils::GetDecomp(cov);
+  SetupDecomp(cov, decomp, bins, scale);
+  delete decomp;
+}
+
+//*******************************************************************
+void MVNThrower::SetupDecomp(TMatrixDSym* cov, TMatrixDSym* decomp,
+                             const std::vector<int>& bins, double scale) {
+//*******************************************************************
+
+  Reset();
+
+  fNBins = bins.size();
+  if (cov->GetNrows() != fNBins or decomp->GetNrows() != fNBins) {
+    ERR(FTL) << "MVNThrower covariance has " << cov->GetNrows()
+             << " rows but " << fNBins << " bins are thrown." << std::endl;
+    throw;
+  }
+
+  fSource = cov;
+  fBins = bins;
+
+  fDecomp.assign(decomp->GetMatrixArray(),
+                 decomp->GetMatrixArray() + fNBins * fNBins);
+
+  // U is upper triangular, or diagonal for uncorrelated errors
+  fRowBegin.assign(fNBins, 0);
+  fRowEnd.assign(fNBins, 0);
+  for (int j = 0; j < fNBins; j++) {
+    int begin = fNBins;
+    int end = 0;
+    for (int i = 0; i < fNBins; i++) {
+      fDecomp[j * fNBins + i] *= scale;
+      if (fDecomp[j * fNBins + i] == 0.0) continue;
+      begin = std::min(begin, i);
+      end = i + 1;
+    }
+    fRowBegin[j] = std::min(begin, end);
+    fRowEnd[j] = end;
+  }
+
+  if (!fSeedSet) {
+    SetSeed(gRandom->Integer(4294967295u));
+  }
+
+  // Keep a batch to around 8 MB of toys
+  fBatchSize = std::max(1, std::min(256, (1 << 20) / std::max(1, fNBins)));
+  fBatchToys = 0;
+}
+
+//*******************************************************************
+void MVNThrower::ThrowNormals(ULong64_t seed, Long64_t toy, int n, double* z) {
+//*******************************************************************
+
+  ULong64_t key = MVNMix(seed + (ULong64_t(toy) + 1) * kMVNGolden);
+
+  // Box-Muller, one pair of uniforms for each pair of normals
+  for (int i = 0; i < n; i += 2) {
+    double r = sqrt(-2.0 * log(MVNUniform(key, i)));
+    double phi = 2.0 * M_PI * MVNUniform(key, i + 1);
+    z[i] = r * cos(phi);
+    if (i + 1 < n) z[i + 1] = r * sin(phi);
+  }
+}
+
+//*******************************************************************
+void MVNThrower::ThrowBatch(Long64_t first, int ntoys) {
+//*******************************************************************
+
+  if (!fSource) {
+    ERR(FTL) << "MVNThrower::ThrowBatch called before Setup" << std::endl;
+    throw;
+  }
+
+  int n = fNBins;
+  fNormals.resize(ntoys * n);
+  fToys.assign(ntoys * n, 0.0);
+  fBatchFirst = first;
+  fBatchToys = ntoys;
+  if (!n) return;
+
+  // Y = Z U over blocks of toys, so each row of U is reused across the
+  // block while it is in cache. Toys are independent so blocks are split
+  // over threads without changing the result.
+  const int kToyBlock = 8;
+  int nblocks = (ntoys + kToyBlock - 1) / kToyBlock;
+
+#ifdef __USE_OPENMP__
+#pragma omp parallel for schedule(static) if (nblocks > 1 and ntoys * n >= 4096)
+#endif
+  for (int b = 0; b < nblocks; b++) {
+    int tbegin = b * kToyBlock;
+    int tend = std::min(tbegin + kToyBlock, ntoys);
+
+    for (int t = tbegin; t < tend; t++) {
+      ThrowNormals(fSeed, first + t, n, &fNormals[t * n]);
+    }
+
+    for (int j = 0; j < n; j++) {
+      const double* urow = &fDecomp[j * n];
+      int begin = fRowBegin[j];
+      int end = fRowEnd[j];
+
+      for (int t = tbegin; t < tend; t++) {
+        double zj = fNormals[t * n + j];
+        double* y = &fToys[t * n];
+        for (int i = begin; i < end; i++) y[i] += zj * urow[i];
+      }
+    }
+  }
+}
+
+//*******************************************************************
+const double* MVNThrower::NextToy() {
+//*******************************************************************
+
+  int index = fNextToy - fBatchFirst;
+  if (!fBatchToys or index < 0 or index >= fBatchToys) {
+    ThrowBatch(fNextToy, fBatchSize);
+    index = 0;
+  }
+
+  fNextToy++;
+  return GetToy(index);
+}
+
+//*******************************************************************
+void MVNThrower::FillHistogram(TH1* hist, TH1* base, const double* toy) const {
+//*******************************************************************
+
+  TArrayD* histarr = dynamic_cast<TArrayD*>(hist);
+  const TArrayD* basearr = dynamic_cast<const TArrayD*>(base);
+  if (!histarr or !basearr or histarr->GetSize() != basearr->GetSize()) {
+    ERR(FTL) << "MVNThrower can only fill TH1D/TH2D histograms with the "
+             << "binning of the base histogram." << std::endl;
+    throw;
+  }
+
+  // Reset to the base contents and errors in place
+  double* val = histarr->GetArray();
+  const double* baseval = basearr->GetArray();
+  for (int i = 0; i < histarr->GetSize(); i++) val[i] = baseval[i];
+
+  if (hist->GetSumw2N() and base->GetSumw2N()) {
+    double* err = hist->GetSumw2()->GetArray();
+    const double* baseerr = base->GetSumw2()->GetArray();
+    for (int i = 0; i < histarr->GetSize(); i++) err[i] = baseerr[i];
+  }
+
+  for (int i = 0; i < fNBins; i++) {
+    if (fBins[i] < 0) continue;
+    val[fBins[i]] += toy[i];
+  }
+}
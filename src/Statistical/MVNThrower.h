@@ -0,0 +1,112 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef MVNTHROWER_H
+#define MVNTHROWER_H
+
+#include <vector>
+
+#include "TH1.h"
+#include "TH1D.h"
+#include "TH1I.h"
+#include "TMatrixDSym.h"
+
+/*!
+ *  \addtogroup Statistical
+ *  @{
+ */
+
+//! Multivariate normal toys from a covariance decomposed once.
+//!
+//! Toys are thrown a batch at a time as Z U, with Z the batch of standard
+//! normals and U the decomposition from StatUtils::GetDecomp, into one
+//! contiguous buffer. Normals come from a counter based generator keyed on
+//! the seed and the toy number, so toy i is the same whatever the batch size
+//! or thread count. Toys are only copied into histograms by FillHistogram.
+class MVNThrower {
+public:
+
+  MVNThrower();
+  ~MVNThrower() {};
+
+  //! Decompose cov, whose rows fill the global histogram bins in bins
+  //! (-1 for rows that fill nothing). scale converts the square root of a
+  //! covariance entry to bin units, 1E-38 for the 1E76 sample covariances.
+  void Setup(TMatrixDSym* cov, const std::vector<int>& bins, double scale = 1E-38);
+
+  //! Setup from an already known decomposition of cov, as from
+  //! StatUtils::GetDecomp or CovarianceCache::GetDecomp.
+  void SetupDecomp(TMatrixDSym* cov, TMatrixDSym* decomp,
+                   const std::vector<int>& bins, double scale = 1E-38);
+
+  //! Setup for a 1D histogram, covariance rows are bins 1..N of hist.
+  //! Masked bins are dropped from the covariance and never thrown.
+  void Setup(TMatrixDSym* cov, TH1D* hist, TH1I* mask = NULL, double scale = 1E-38);
+
+  //! Check the thrower was built from this covariance
+  bool IsSetup(TMatrixDSym* cov) const;
+
+  //! Forget the current setup, forcing a rebuild on the next IsSetup check
+  void Reset();
+
+  //! Seed of the toy stream. Defaults to a value drawn from gRandom at the
+  //! first Setup, so runs seeded through gRandom stay reproducible.
+  void SetSeed(ULong64_t seed);
+
+  //! Throw toys first .. first + ntoys - 1 into the batch buffer
+  void ThrowBatch(Long64_t first, int ntoys);
+
+  //! Toy i of the last batch, GetNBins values in covariance row order
+  inline const double* GetToy(int i) const { return &fToys[i * fNBins]; };
+
+  //! Next toy of the stream, a new batch is thrown when the last one is used up
+  const double* NextToy();
+
+  //! hist = base + toy in place. hist and base must share a binning, bins
+  //! outside the throw keep the base contents.
+  void FillHistogram(TH1* hist, TH1* base, const double* toy) const;
+
+  //! Number of covariance rows thrown
+  inline int GetNBins() const { return fNBins; };
+
+  //! n standard normals for one toy of the stream keyed by seed
+  static void ThrowNormals(ULong64_t seed, Long64_t toy, int n, double* z);
+
+private:
+
+  TMatrixDSym* fSource;          //!< Covariance the setup was built from
+  int fNBins;
+  std::vector<int> fBins;        //!< Global histogram bin of each row, -1 if none
+  std::vector<double> fDecomp;   //!< Scaled decomposition, row major
+  std::vector<int> fRowBegin;    //!< First non zero column of each fDecomp row
+  std::vector<int> fRowEnd;      //!< One past the last non zero column
+
+  ULong64_t fSeed;
+  bool fSeedSet;
+  int fBatchSize;                //!< Toys thrown per batch by NextToy
+  Long64_t fBatchFirst;          //!< Stream number of the first toy in fToys
+  int fBatchToys;                //!< Toys held in fToys
+  Long64_t fNextToy;             //!< Stream number NextToy returns next
+
+  std::vector<double> fNormals;  //!< Standard normals of the batch
+  std::vector<double> fToys;     //!< Thrown batch, toy major
+};
+
+/*! @} */
+#endif
@@ -0,0 +1,83 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include <cmath>
+
+#include "SmearingMatrix.h"
+
+//*******************************************************************
+SmearingMatrix::SmearingMatrix() {
+//*******************************************************************
+  fNTrue = 0;
+  fNReco = 0;
+}
+
+//*******************************************************************
+void SmearingMatrix::Setup(const TMatrixD* smear, double tol) {
+//*******************************************************************
+
+  fNTrue = smear->GetNrows();
+  fNReco = smear->GetNcols();
+  fRowStart.assign(1, 0);
+  fTrueBin.clear();
+  fValue.clear();
+
+  // Transposed so each reco bin is one contiguous row
+  for (int r = 0; r < fNReco; r++) {
+    for (int t = 0; t < fNTrue; t++) {
+      double val = (*smear)(t, r);
+      if (fabs(val) <= tol) continue;
+      fTrueBin.push_back(t);
+      fValue.push_back(val);
+    }
+    fRowStart.push_back(fValue.size());
+  }
+
+  fTruth.resize(fNTrue);
+  fReco.resize(fNReco);
+}
+
+//*******************************************************************
+void SmearingMatrix::Apply(const double* truth, double* reco) const {
+//*******************************************************************
+
+  for (int r = 0; r < fNReco; r++) {
+    double val = 0.0;
+    for (int i = fRowStart[r]; i < fRowStart[r + 1]; i++) {
+      val += fValue[i] * truth[fTrueBin[i]];
+    }
+    reco[r] = val;
+  }
+}
+
+//*******************************************************************
+void SmearingMatrix::Apply(TH1D* hist) {
+//*******************************************************************
+
+  for (int t = 0; t < fNTrue; t++) {
+    fTruth[t] = hist->GetBinContent(t + 1);
+  }
+
+  Apply(&fTruth[0], &fReco[0]);
+
+  hist->Reset();
+  for (int r = 0; r < fNReco; r++) {
+    hist->SetBinContent(r + 1, fReco[r]);
+  }
+}
@@ -0,0 +1,76 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef SMEARINGMATRIX_H
+#define SMEARINGMATRIX_H
+
+#include <vector>
+
+#include "TH1D.h"
+#include "TMatrixD.h"
+
+/*!
+ *  \addtogroup Statistical
+ *  @{
+ */
+
+//! Sparse copy of a true to reco smearing matrix.
+//!
+//! The matrix is given with true bins as rows and reco bins as columns, the
+//! layout samples read it in. It is stored transposed in compressed sparse
+//! row form, one row per reco bin holding only the non-zero true bins, so
+//! smearing a prediction costs one multiply per non-zero element rather than
+//! one per element. Sums run over true bins in increasing order, so results
+//! match the dense loop with only the zero terms skipped.
+class SmearingMatrix {
+public:
+
+  SmearingMatrix();
+
+  //! Build from a (true x reco) matrix, dropping elements with |M| <= tol
+  void Setup(const TMatrixD* smear, double tol = 0.0);
+
+  //! Check the matrix has been setup
+  inline bool IsSetup() const { return !fRowStart.empty(); };
+
+  inline int GetNTrue() const { return fNTrue; };
+  inline int GetNReco() const { return fNReco; };
+  inline int GetNNonZero() const { return fValue.size(); };
+
+  //! reco[r] = sum_t M(t, r) * truth[t]
+  void Apply(const double* truth, double* reco) const;
+
+  //! Replace the contents of hist by its smeared contents. True bins are read
+  //! from 1..NTrue and reco bins written to 1..NReco of a reset histogram.
+  void Apply(TH1D* hist);
+
+private:
+
+  int fNTrue;
+  int fNReco;
+  std::vector<int> fRowStart;  //!< First element of each reco row, NReco + 1
+  std::vector<int> fTrueBin;   //!< True bin of each element
+  std::vector<double> fValue;  //!< Value of each element
+
+  std::vector<double> fTruth;  //!< Scratch true contents for Apply(TH1D*)
+  std::vector<double> fReco;   //!< Scratch reco contents for Apply(TH1D*)
+};
+
+/*! @} */
+#endif
@@ -19,6 +19,8 @@
 
 #include "TH1D.h"
 #include "StatUtils.h"
+#include "Chi2Evaluator.h"
+#include "MVNThrower.h"
 #include "NuisConfig.h"
 #include "GeneralUtils.h"
 
@@ -26,49 +28,10 @@
 Double_t StatUtils::GetChi2FromDiag(TH1D* data, TH1D* mc, TH1I* mask) {
 //*******************************************************************
 
-  Double_t Chi2 = 0.0;
-  TH1D* calc_data = (TH1D*)data->Clone();
-  TH1D* calc_mc   = (TH1D*)mc->Clone();
-
-  // Add MC Error to data if required
-  if (FitPar::Config().GetParB("addmcerror")) {
-    for (int i = 0; i < calc_data->GetNbinsX(); i++) {
-
-      double dterr = calc_data->GetBinError(i + 1);
-      double mcerr = calc_mc->GetBinError(i + 1);
-
-      if (dterr > 0.0) {
-        calc_data->SetBinError(i + 1, sqrt(dterr * dterr + mcerr * mcerr));
-      }
-    }
-  }
-
-  // Apply masking if required
-  if (mask) {
-    calc_data = ApplyHistogramMasking(data, mask);
-    calc_mc   = ApplyHistogramMasking(mc, mask);
-  }
-
-  // Iterate over bins in X
-  for (int i = 0; i < calc_data->GetNbinsX(); i++) {
-
-    // Ignore bins with zero data or zero bin error
-    if (calc_data->GetBinError(i + 1) <= 0.0 ||
-        calc_data->GetBinContent(i + 1) == 0.0) continue;
-
-    // Take mc data difference
-    double diff = calc_data->GetBinContent(i + 1) - calc_mc->GetBinContent(i + 1);
-    double err = calc_data->GetBinError(i + 1);
-    Chi2 += (diff * diff) / (err * err);
-
-  }
-
-  // cleanup
-  delete calc_data;
-  delete calc_mc;
-
-  return Chi2;
-};
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2Diag, -1, data, NULL, mask);
+  return eval.Eval(data, mc);
+}
 
 //*******************************************************************
 Double_t StatUtils::GetChi2FromDiag(TH2D* data, TH2D* mc,
@@ -76,23 +39,16 @@ Double_t StatUtils::GetChi2FromDiag(TH2D* data, TH2D* mc,
 //*******************************************************************
 
   // Generate a simple map
-  if (!map)  map = GenerateMap(data);
+  bool ownmap = !map;
+  if (ownmap) map = StatUtils::GenerateMap(data);
 
-  // Convert to 1D Histograms
-  TH1D* data_1D = MapToTH1D(data, map);
-  TH1D* mc_1D   = MapToTH1D(mc,   map);
-  TH1I* mask_1D = MapToMask(mask, map);
-
-  // Calculate 1D chi2 from 1D Plots
-  Double_t Chi2 = StatUtils:: GetChi2FromDiag(data_1D, mc_1D,  mask_1D);
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2Diag, -1, data, NULL, map, mask);
+  double chi2 = eval.Eval(data, mc);
 
-  // CleanUp
-  delete data_1D;
-  delete mc_1D;
-  delete mask_1D;
-
-  return Chi2;
-};
+  if (ownmap) delete map;
+  return chi2;
+}
 
 //*******************************************************************
 Double_t StatUtils::GetChi2FromCov(TH1D* data, TH1D* mc,
@@ -100,96 +56,9 @@ Double_t StatUtils::GetChi2FromCov(TH1D* data, TH1D* mc,
 				   double data_scale, double covar_scale) {
 //*******************************************************************
 
-  Double_t Chi2 = 0.0;
-  TMatrixDSym* calc_cov = (TMatrixDSym*) invcov->Clone();
-  TH1D* calc_data = (TH1D*) data->Clone();
-  TH1D* calc_mc   = (TH1D*) mc->Clone();
-
-  // If a mask if applied we need to apply it before the matrix is inverted
-  if (mask) {
-    calc_cov  = ApplyInvertedMatrixMasking(invcov, mask);
-    calc_data = ApplyHistogramMasking(data, mask);
-    calc_mc   = ApplyHistogramMasking(mc, mask);
-  }
-
-  // Add MC Error to data if required
-  if (FitPar::Config().GetParB("addmcerror")) {
-
-    // Make temp cov
-    TMatrixDSym* newcov = StatUtils::GetInvert(calc_cov);
-
-    // Add MC err to diag
-    for (int i = 0; i < calc_data->GetNbinsX(); i++) {
-
-      double mcerr = calc_mc->GetBinError(i + 1) * sqrt(covar_scale);
-      double oldval = (*newcov)(i, i);
-
-      std::cout << "Adding cov stat " << mcerr*mcerr << " to " << (*newcov)(i,i) << std::endl;
-      (*newcov)(i, i) = oldval + mcerr * mcerr;
-    }
-
-    // Reset the calc_cov to new invert
-    delete calc_cov;
-    calc_cov = GetInvert(newcov);
-
-    // Delete the tempcov
-    delete newcov;
-  }
-
-  calc_data->Scale(data_scale);
-  calc_mc  ->Scale(data_scale);
-  (*calc_cov) *= covar_scale;
-
-  // iterate over bins in X (i,j)
-  for (int i = 0; i < calc_data->GetNbinsX(); i++) {
-
-    for (int j = 0; j < calc_data->GetNbinsX(); j++) {
-
-      if (calc_data->GetBinContent(i + 1) != 0 || calc_mc->GetBinContent(i + 1) != 0) {
-
-        LOG(DEB) << "i j = " << i << " " << j << std::endl;
-        LOG(DEB) << "Calc_data mc i = " << calc_data->GetBinContent(i + 1)
-                 << " " << calc_mc->GetBinContent(i + 1)
-                 << "  Dif = "
-                 << ( calc_data->GetBinContent(i + 1) - calc_mc->GetBinContent(i + 1) )
-                 << std::endl;
-
-        LOG(DEB) << "Calc_data mc i = " << calc_data->GetBinContent(j + 1)
-                 << " " << calc_mc->GetBinContent(j + 1)
-                 << "  Dif = "
-                 << ( calc_data->GetBinContent(j + 1) - calc_mc->GetBinContent(j + 1) )
-                 << std::endl;
-
-        LOG(DEB) << "Covar = " <<    (*calc_cov)(i, j) << std::endl;
-
-        LOG(DEB) << "Cont chi2 = " \
-                 << ( ( calc_data->GetBinContent(i + 1) - calc_mc->GetBinContent(i + 1) ) \
-                      * (*calc_cov)(i, j) \
-                      *   ( calc_data->GetBinContent(j + 1) - calc_mc->GetBinContent(j + 1)))
-                 << " " << Chi2 << std::endl;
-
-        Chi2 += ( ( calc_data->GetBinContent(i + 1) - calc_mc->GetBinContent(i + 1) ) \
-		  * (*calc_cov)(i, j)					\
-		  * ( calc_data->GetBinContent(j + 1) - calc_mc->GetBinContent(j + 1) ) );
-
-      } else {
-
-        LOG(DEB) << "Error on bin (i,j) = (" << i << "," << j << ")" << std::endl;
-        LOG(DEB) << "data->GetBinContent(i+1) = " << calc_data->GetBinContent(i + 1) << std::endl;
-        LOG(DEB) << "mc->GetBinContent(i+1) = " << calc_mc->GetBinContent(i + 1) << std::endl;
-        LOG(DEB) << "Adding zero to chi2 instead of dying horrifically " << std::endl;
-
-        Chi2 += 0.;
-      }
-    }
-  }
-
-  // Cleanup
-  delete calc_cov;
-  delete calc_data;
-  delete calc_mc;
-
-  return Chi2;
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2Cov, -1, data, invcov, mask, data_scale, covar_scale);
+  return eval.Eval(data, mc);
 }
 
 
@@ -199,24 +68,15 @@ Double_t StatUtils::GetChi2FromCov( TH2D* data, TH2D* mc,
 //*******************************************************************
 
   // Generate a simple map
-  if (!map) {
-    map = StatUtils::GenerateMap(data);
-  }
+  bool ownmap = !map;
+  if (ownmap) map = StatUtils::GenerateMap(data);
 
-  // Convert to 1D Histograms
-  TH1D* data_1D = MapToTH1D(data, map);
-  TH1D* mc_1D   = MapToTH1D(mc,   map);
-  TH1I* mask_1D = MapToMask(mask, map);
-
-  // Calculate 1D chi2 from 1D Plots
-  Double_t Chi2 = StatUtils::GetChi2FromCov(data_1D, mc_1D,  invcov, mask_1D);
-
-  // CleanUp
-  delete data_1D;
-  delete mc_1D;
-  delete mask_1D;
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2Cov, -1, data, invcov, map, mask);
+  double chi2 = eval.Eval(data, mc);
 
-  return Chi2;
+  if (ownmap) delete map;
+  return chi2;
 }
 
 //*******************************************************************
@@ -224,119 +84,116 @@ Double_t StatUtils::GetChi2FromSVD( TH1D* data, TH1D* mc,
                                     TMatrixDSym* cov,  TH1I* mask) {
 //*******************************************************************
 
-  Double_t Chi2 = 0.0;
-  TMatrixDSym* calc_cov = (TMatrixDSym*) cov->Clone();
-  TH1D* calc_data = (TH1D*) data->Clone();
-  TH1D* calc_mc   = (TH1D*) mc->Clone();
-
-  // If a mask if applied we need to apply it before the matrix is inverted
-  if (mask) {
-    calc_cov  = StatUtils::ApplyMatrixMasking(cov, mask);
-    calc_data = StatUtils::ApplyHistogramMasking(data, mask);
-    calc_mc   = StatUtils::ApplyHistogramMasking(mc, mask);
-  }
-
-  // Decompose matrix
-  TDecompSVD LU = TDecompSVD((*calc_cov));
-  LU.Decompose();
-  TMatrixDSym* cov_U = new TMatrixDSym(calc_data->GetNbinsX(), LU .GetU().GetMatrixArray(), "");
-  TVectorD*    cov_S = new TVectorD( LU.GetSig() );
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2SVD, -1, data, cov, mask);
+  return eval.Eval(data, mc);
+}
 
-  // Apply basis rotation before adding up chi2
-  Double_t rotated_difference = 0.0;
 
-  for (int i = 0; i < calc_data->GetNbinsX(); i++) {
-    rotated_difference = 0.0;
+//*******************************************************************
+Double_t StatUtils::GetChi2FromSVD( TH2D* data, TH2D* mc,
+                                    TMatrixDSym* cov,    TH2I* map, TH2I* mask) {
+//*******************************************************************
 
-    // Rotate basis of Data - MC
-    for (int j = 0; j < calc_data->GetNbinsY(); j++)
-      rotated_difference += ( calc_data->GetBinContent(j + 1) - calc_mc  ->GetBinContent(j + 1) ) * (*cov_U)(j, i) ;
+  // Generate a simple map
+  bool ownmap = !map;
+  if (ownmap) map = StatUtils::GenerateMap(data);
 
-    // Divide by rotated error cov_S
-    Chi2 += rotated_difference * rotated_difference * 1E76 / (*cov_S)(i);
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2SVD, -1, data, cov, map, mask);
+  double chi2 = eval.Eval(data, mc);
 
-  }
+  if (ownmap) delete map;
+  return chi2;
+}
 
-  // Cleanup
-  delete calc_cov;
-  delete calc_data;
-  delete calc_mc;
-  delete cov_U;
-  delete cov_S;
+//*******************************************************************
+double StatUtils::GetChi2FromEventRate(TH1D* data, TH1D* mc, TH1I* mask) {
+//*******************************************************************
 
-  return Chi2;
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2EventRate, -1, data, NULL, mask);
+  return eval.Eval(data, mc);
 }
 
-
 //*******************************************************************
-Double_t StatUtils::GetChi2FromSVD( TH2D* data, TH2D* mc,
-                                    TMatrixDSym* cov,    TH2I* map, TH2I* mask) {
+void StatUtils::GetChi2GradientFromDiag(TH1D* data, TH1D* mc, TH1I* mask,
+                                        std::vector<double>& grad) {
 //*******************************************************************
 
-  // Generate a simple map
-  if (!map)
-    map = StatUtils::GenerateMap(data);
-
-  // Convert to 1D Histograms
-  TH1D* data_1D = MapToTH1D(data, map);
-  TH1D* mc_1D   = MapToTH1D(mc,   map);
-  TH1I* mask_1D = MapToMask(mask, map);
+  grad.assign(mc->GetNbinsX() + 2, 0.0);
 
-  // Calculate from 1D
-  Double_t Chi2 = StatUtils::GetChi2FromSVD(data_1D, mc_1D, cov, mask_1D);
+  for (int i = 0; i < data->GetNbinsX(); i++) {
+    if (mask and mask->GetBinContent(i + 1)) continue;
 
-  // CleanUp
-  delete data_1D;
-  delete mc_1D;
-  delete mask_1D;
+    // Same bin selection as GetChi2FromDiag
+    double err = data->GetBinError(i + 1);
+    if (err <= 0.0 || data->GetBinContent(i + 1) == 0.0) continue;
 
-  return Chi2;
+    double diff = data->GetBinContent(i + 1) - mc->GetBinContent(i + 1);
+    grad[i + 1] = -2.0 * diff / (err * err);
+  }
 }
 
 //*******************************************************************
-double StatUtils::GetChi2FromEventRate(TH1D* data, TH1D* mc, TH1I* mask) {
+void StatUtils::GetChi2GradientFromCov(TH1D* data, TH1D* mc,
+                                       TMatrixDSym* invcov, TH1I* mask,
+                                       std::vector<double>& grad,
+                                       double data_scale, double covar_scale) {
 //*******************************************************************
 
-  // If just an event rate, for chi2 just use Poission Likelihood to calculate the chi2 component
-  double chi2 = 0.0;
-  TH1D* calc_data = (TH1D*)data->Clone();
-  TH1D* calc_mc   = (TH1D*)mc->Clone();
+  grad.assign(mc->GetNbinsX() + 2, 0.0);
 
-  // Apply masking if required
-  if (mask) {
-    calc_data = ApplyHistogramMasking(data, mask);
-    calc_mc   = ApplyHistogramMasking(mc, mask);
+  // Histogram bins surviving the mask, in the compacted matrix order
+  std::vector<int> bins;
+  for (int i = 0; i < data->GetNbinsX(); i++) {
+    if (mask and mask->GetBinContent(i + 1)) continue;
+    bins.push_back(i + 1);
   }
 
-  // Iterate over bins in X
-  for (int i = 0; i < calc_data->GetNbinsX(); i++) {
-
-    double dt = calc_data->GetBinContent(i + 1);
-    double mc = calc_mc->GetBinContent(i + 1);
+  TMatrixDSym* calc_cov = mask ? ApplyInvertedMatrixMasking(invcov, mask) : invcov;
 
-    if (mc <= 0) continue;
+  int nbins = bins.size();
+  std::vector<double> diff(nbins);
+  std::vector<bool> used(nbins);
+  for (int i = 0; i < nbins; i++) {
+    double dt = data->GetBinContent(bins[i]) * data_scale;
+    double mcval = mc->GetBinContent(bins[i]) * data_scale;
+    diff[i] = dt - mcval;
+    used[i] = (dt != 0 || mcval != 0);
+  }
 
-    if (dt <= 0) {
-      // Only add difference
-      chi2 += 2 * (mc - dt);
-    } else {
-      // Do the chi2 for Poisson distributions
-      chi2 +=  2 * (mc - dt + (dt * log(dt / mc)));
+  // chi2 = sum_{i used} sum_j diff_i C_ij diff_j, so
+  // dchi2/dmc_k = -(sum_{i used} diff_i C_ik + [k used] sum_j C_kj diff_j)
+  for (int k = 0; k < nbins; k++) {
+    double d = 0.0;
+    for (int i = 0; i < nbins; i++) {
+      if (used[i]) d += diff[i] * (*calc_cov)(i, k);
+      if (used[k]) d += (*calc_cov)(k, i) * diff[i];
     }
-
-    /*
-        LOG(REC)<<"Evt Chi2 cont = "<<i<<" "
-          <<mc<<" "<<dt<<" "
-          <<2 * (mc - dt + (dt+0.) * log((dt+0.) / (mc+0.)))
-          <<" "<<Chi2<<std::endl;
-    */
+    grad[bins[k]] = -d * covar_scale * data_scale;
   }
 
-  // cleanup
-  delete calc_data;
-  delete calc_mc;
+  if (mask) delete calc_cov;
+}
 
-  return chi2;
+//*******************************************************************
+void StatUtils::GetChi2GradientFromEventRate(TH1D* data, TH1D* mc, TH1I* mask,
+                                             std::vector<double>& grad) {
+//*******************************************************************
+
+  grad.assign(mc->GetNbinsX() + 2, 0.0);
+
+  for (int i = 0; i < data->GetNbinsX(); i++) {
+    if (mask and mask->GetBinContent(i + 1)) continue;
+
+    double dt = data->GetBinContent(i + 1);
+    double mcval = mc->GetBinContent(i + 1);
+    if (mcval <= 0) continue;
+
+    if (dt <= 0) grad[i + 1] = 2.0;
+    else grad[i + 1] = 2.0 * (1.0 - dt / mcval);
+  }
 }
 
 //*******************************************************************
@@ -344,23 +201,15 @@ Double_t StatUtils::GetChi2FromEventRate(TH2D* data, TH2D* mc, TH2I* map, TH2I*
 //*******************************************************************
 
   // Generate a simple map
-  if (!map)
-    map = StatUtils::GenerateMap(data);
+  bool ownmap = !map;
+  if (ownmap) map = StatUtils::GenerateMap(data);
 
-  // Convert to 1D Histograms
-  TH1D* data_1D = MapToTH1D(data, map);
-  TH1D* mc_1D   = MapToTH1D(mc,   map);
-  TH1I* mask_1D = MapToMask(mask, map);
-
-  // Calculate from 1D
-  Double_t Chi2 = StatUtils::GetChi2FromEventRate(data_1D, mc_1D, mask_1D);
+  Chi2Evaluator eval;
+  eval.Setup(Chi2Evaluator::kChi2EventRate, -1, data, NULL, map, mask);
+  double chi2 = eval.Eval(data, mc);
 
-  // CleanUp
-  delete data_1D;
-  delete mc_1D;
-  delete mask_1D;
-
-  return Chi2;
+  if (ownmap) delete map;
+  return chi2;
 }
 
 
@@ -489,25 +338,9 @@ Double_t StatUtils::GetLikelihoodFromEventRate(TH1D* data, TH1D* mc, TH1I* mask)
 Double_t StatUtils::GetLikelihoodFromEventRate(TH2D* data, TH2D* mc, TH2I* map, TH2I* mask) {
 //*******************************************************************
 
-  // Generate a simple map
-  if (!map)
-    map = StatUtils::GenerateMap(data);
-
-  // Convert to 1D Histograms
-  TH1D* data_1D = MapToTH1D(data, map);
-  TH1D* mc_1D   = MapToTH1D(mc,   map);
-  TH1I* mask_1D = MapToMask(mask, map);
-
-  // Calculate from 1D
-  Double_t MLE = StatUtils::GetChi2FromEventRate(data_1D, mc_1D, mask_1D);
-
-  // CleanUp
-  delete data_1D;
-  delete mc_1D;
-  delete mask_1D;
-
-  return MLE;
-};
+  // No binned likelihood yet, same as the chi2 from event rates
+  return StatUtils::GetChi2FromEventRate(data, mc, map, mask);
+}
 
 
 
@@ -538,18 +371,19 @@ Int_t StatUtils::GetNDOF(TH1D* hist, TH1I* mask) {
 Int_t StatUtils::GetNDOF(TH2D* hist, TH2I* map, TH2I* mask) {
 //*******************************************************************
 
-  Int_t NDOF = 0;
-  if (!map) map = StatUtils::GenerateMap(hist);
-
-  for (int i = 0; i < hist->GetNbinsX(); i++) {
-    for (int j = 0; j < hist->GetNbinsY(); j++) {
-
-      if (mask->GetBinContent(i + 1, j + 1)) continue;
-      if (map->GetBinContent(i + 1, j + 1) <= 0) continue;
+  // Generate a simple map
+  bool ownmap = !map;
+  if (ownmap) map = StatUtils::GenerateMap(hist);
 
-      NDOF++;
+  std::vector<int> bins;
+  std::vector<bool> masked;
+  StatUtils::GenerateMapBins(hist, map, mask, bins, masked);
+  if (ownmap) delete map;
 
-    }
+  // NDOF is the number of mapped bins left after masking
+  Int_t NDOF = 0;
+  for (size_t i = 0; i < bins.size(); i++) {
+    if (bins[i] >= 0 and !masked[i]) NDOF++;
   }
 
   return NDOF;
@@ -615,20 +449,43 @@ TH1D* StatUtils::ThrowHistogram(TH1D* hist, TMatrixDSym* cov, bool throwdiag, TH
 TH2D* StatUtils::ThrowHistogram(TH2D* hist, TMatrixDSym* cov, TH2I* map, bool throwdiag, TH2I* mask) {
 //*******************************************************************
 
-  // PLACEHOLDER!!!!!!!!!
-  // Currently no support for throwing 2D Histograms from a covariance
-  (void) hist;
-  (void) cov;
-  (void) map;
+  // As in the 1D throw only the covariance is thrown
   (void) throwdiag;
-  (void) mask;
 
-  // /todo
-  // Sort maps if required
-  // Throw the covariance for a 1D plot
-  // Unmap back to 2D Histogram
+  TH2D* calc_hist = (TH2D*) hist->Clone( (std::string(hist->GetName()) + "_THROW" ).c_str() );
+  if (!cov) return calc_hist;
+
+  // Generate a simple map
+  bool ownmap = !map;
+  if (ownmap) map = StatUtils::GenerateMap(hist);
+
+  std::vector<int> bins;
+  std::vector<bool> masked;
+  StatUtils::GenerateMapBins(hist, map, mask, bins, masked);
+
+  // Masked bins are dropped from the covariance and left unthrown
+  TMatrixDSym* calc_cov = cov;
+  if (mask) {
+    TH1I* mask_1D = StatUtils::MapToMask(mask, map);
+    calc_cov = StatUtils::ApplyMatrixMasking(cov, mask_1D);
+    delete mask_1D;
+
+    std::vector<int> used;
+    for (size_t i = 0; i < bins.size(); i++) {
+      if (!masked[i]) used.push_back(bins[i]);
+    }
+    bins.swap(used);
+  }
+
+  MVNThrower thrower;
+  thrower.Setup(calc_cov, bins);
+  thrower.ThrowBatch(0, 1);
+  thrower.FillHistogram(calc_hist, hist, thrower.GetToy(0));
 
-  return hist;
+  if (calc_cov != cov) delete calc_cov;
+  if (ownmap) delete map;
+
+  return calc_hist;
 }
 
 
@@ -1002,6 +859,17 @@ TMatrixDSym* StatUtils::ExtractShapeOnlyCovar(TMatrixDSym* full_covar, TH1* data
 
   LOG(SAM) << "Norm error = " << sqrt(total_covar)/total_data << std::endl;
   
+  // Column and row sums only depend on one index, so sum them once.
+  // Summed in the same k order as before so results are unchanged.
+  std::vector<double> col_sum(nbins, 0.0);
+  std::vector<double> row_sum(nbins, 0.0);
+  for (int i = 0; i < nbins; ++i) {
+    for (int k = 0; k < nbins; ++k){
+      col_sum[i] += (*full_covar)(k,i);
+      row_sum[i] += (*full_covar)(i,k);
+    }
+  }
+
   // Now loop over and calculate the shape-only matrix
   for (int i = 0; i < nbins; ++i) {
     double data_i = data_hist->GetBinContent(i+1)*data_scale;
@@ -1010,13 +878,8 @@ TMatrixDSym* StatUtils::ExtractShapeOnlyCovar(TMatrixDSym* full_covar, TH1* data
       double data_j = data_hist->GetBinContent(j+1)*data_scale;
 	
       double norm_term = data_i*data_j*total_covar/total_data/total_data;
-      double mix_sum1 = 0;
-      double mix_sum2 = 0;
-      
-      for (int k = 0; k < nbins; ++k){
-	mix_sum1 += (*full_covar)(k,j);
-	mix_sum2 += (*full_covar)(i,k);
-      }
+      double mix_sum1 = col_sum[j];
+      double mix_sum2 = row_sum[i];
 
       double mix_term1 = data_i*(mix_sum1/total_data - total_covar*data_j/total_data/total_data);
       double mix_term2 = data_j*(mix_sum2/total_data - total_covar*data_i/total_data/total_data);
@@ -1085,6 +948,27 @@ TH1D* StatUtils::MapToTH1D(TH2D* hist, TH2I* map) {
 }
 
 
+//*******************************************************************
+void StatUtils::GenerateMapBins(TH2D* hist, TH2I* map, TH2I* mask,
+                                std::vector<int>& bins, std::vector<bool>& masked) {
+//*******************************************************************
+
+  Int_t Nbins = map->GetMaximum();
+  bins.assign(Nbins, -1);
+  masked.assign(Nbins, false);
+
+  for (int i = 0; i < map->GetNbinsX(); i++) {
+    for (int j = 0; j < map->GetNbinsY(); j++) {
+
+      int index = map->GetBinContent(i + 1, j + 1);
+      if (index <= 0) continue;
+
+      bins[index - 1] = hist->GetBin(i + 1, j + 1);
+      if (mask and mask->GetBinContent(i + 1, j + 1)) masked[index - 1] = true;
+    }
+  }
+}
+
 //*******************************************************************
 TH1I* StatUtils::MapToMask(TH2I* hist, TH2I* map) {
 //*******************************************************************
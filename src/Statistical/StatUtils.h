@@ -29,6 +29,7 @@
 #include <sstream>
 #include <iomanip>
 #include <deque>
+#include <vector>
 #include "assert.h"
 
 // Root Includes
@@ -91,6 +92,25 @@ namespace StatUtils{
   //! Plots converted to 1D histograms before using 1D calculation.
   Double_t GetChi2FromEventRate(TH2D* data, TH2D* mc, TH2I* map=NULL, TH2I* mask=NULL);
 
+  /*
+    Chi2 Gradient Functions
+  */
+
+  //! Derivative of GetChi2FromDiag with respect to each MC bin content.
+  //! grad is indexed by histogram bin number, masked bins are left at zero.
+  //! The addmcerror option is not included.
+  void GetChi2GradientFromDiag(TH1D* data, TH1D* mc, TH1I* mask, std::vector<double>& grad);
+
+  //! Derivative of GetChi2FromCov with respect to each MC bin content.
+  //! grad is indexed by histogram bin number, masked bins are left at zero.
+  //! The addmcerror option is not included.
+  void GetChi2GradientFromCov(TH1D* data, TH1D* mc, TMatrixDSym* invcov, TH1I* mask,
+                              std::vector<double>& grad, double data_scale=1, double covar_scale=1E76);
+
+  //! Derivative of GetChi2FromEventRate with respect to each MC bin content.
+  //! grad is indexed by histogram bin number, masked bins are left at zero.
+  void GetChi2GradientFromEventRate(TH1D* data, TH1D* mc, TH1I* mask, std::vector<double>& grad);
+
   // Likelihood Functions
 
   //! Placeholder for 1D binned likelihood method
@@ -133,7 +153,8 @@ namespace StatUtils{
   TH1D* ThrowHistogram(TH1D* hist, TMatrixDSym* cov, bool throwdiag=true, TH1I* mask=NULL);
 
   //! Given a full covariance for a 2D data set throw the decomposition to generate fake data.
-  //! Plots are converted to 1D histograms and the 1D ThrowHistogram is used, before being converted back to 2D histograms.
+  //! Bins are flattened with GenerateMapBins and thrown with an MVNThrower.
+  //! For repeated throws keep an MVNThrower instead, this decomposes cov every call.
   TH2D* ThrowHistogram(TH2D* hist, TMatrixDSym* cov, TH2I* map=NULL, bool throwdiag=true, TH2I* mask=NULL);
 
 
@@ -209,6 +230,13 @@ namespace StatUtils{
   //! Apply a map to a 2D mask convering it into a 1D mask.
   TH1I* MapToMask(TH2I* hist, TH2I* map);
 
+  //! Flatten a map once into index arrays : bins holds the global bin of hist
+  //! for each map index (the MapToTH1D ordering), -1 if no bin uses it, and
+  //! masked flags the indices a mask removes. Contents can then be read
+  //! straight from hist->GetArray() without building 1D histograms.
+  void GenerateMapBins(TH2D* hist, TH2I* map, TH2I* mask,
+                       std::vector<int>& bins, std::vector<bool>& masked);
+
 
   /// \brief Read TMatrixD from a text file
   ///
@@ -0,0 +1,74 @@
+#include <cassert>
+#include <vector>
+
+#include "FitLogger.h"
+#include "JointFCN.h"
+#include "NuisConfig.h"
+
+int main(int argc, char const *argv[]) {
+  LOG_VERB(SAM);
+  LOG(FIT) << "*            Running Config Tests" << std::endl;
+  LOG(FIT) << "***************************************************"
+           << std::endl;
+
+  LOG(FIT) << "    *        Test snapshot follows config edits" << std::endl;
+  Config::SetPar("addmcerror", false);
+  unsigned int version = Config::Get().GetVersion();
+  assert(!Config::GetSnapshot().addmcerror);
+  assert(Config::GetSnapshot().version == version);
+
+  Config::SetPar("addmcerror", true);
+  assert(Config::Get().GetVersion() != version);
+  assert(Config::GetSnapshot().addmcerror);
+
+  Config::SetPar("logging.ConfigTests.cxx", 2);
+  assert(Config::GetSnapshot().logging.find("logging.ConfigTests.cxx")->second == 2);
+
+  Config::SetPar("addmcerror", false);
+  assert(!Config::GetSnapshot().addmcerror);
+
+  LOG(FIT) << "    *        Test snapshot reads skip the DOM" << std::endl;
+  unsigned long reads = Config::Get().GetNDOMReads();
+  bool addmcerror = false;
+  for (int i = 0; i < 100; i++) {
+    addmcerror = addmcerror or Config::GetSnapshot().addmcerror;
+  }
+  assert(!addmcerror);
+  assert(Config::Get().GetNDOMReads() == reads);
+
+  LOG(FIT) << "    *        Test JointFCN::DoEval skips the DOM" << std::endl;
+  std::vector<nuiskey> samplekeys;
+  JointFCN fcn(samplekeys);
+
+  // A dial pull needs no input events, its dial is left at zero
+  std::vector<nuiskey> pullkeys;
+  pullkeys.push_back(Config::CreateKey("covar"));
+  pullkeys[0].Set("name", std::string("ConfigTests_pull"));
+  pullkeys[0].Set("input", std::string("DIAL:ConfigTests_dial;1.0;0.5"));
+  pullkeys[0].Set("type", std::string("GAUSPULL"));
+  fcn.LoadPulls(pullkeys);
+
+  // First call sets up the reweight engine, which may read the config
+  double x[1] = {0.0};
+  double like = fcn.DoEval(x);
+  LOG(FIT) << "        *        DoEval : " << like << " vs GetLikelihood : "
+           << fcn.GetLikelihood() << std::endl;
+  assert(like > 0.0);
+  assert(like == fcn.GetLikelihood());
+
+  reads = Config::Get().GetNDOMReads();
+  for (int i = 0; i < 10; i++) {
+    double newlike = fcn.DoEval(x);
+    assert(newlike == like);
+  }
+
+  if (Config::Get().GetNDOMReads() != reads) {
+    ERR(FTL) << "JointFCN::DoEval made "
+             << Config::Get().GetNDOMReads() - reads
+             << " config DOM reads after setup." << std::endl;
+  }
+  assert(Config::Get().GetNDOMReads() == reads);
+
+  LOG(FIT) << "*            Config Tests passed" << std::endl;
+  return 0;
+}
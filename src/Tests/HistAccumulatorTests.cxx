@@ -0,0 +1,263 @@
+#include "HistAccumulator.h"
+#include "StandardStacks.h"
+
+#include "FitLogger.h"
+
+#include "TArrayD.h"
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// x values covering the axis, its edges, under/overflow and NaN
+double ThrowX(const TAxis* axis, TRandom3& rand) {
+  double lo = axis->GetXmin();
+  double hi = axis->GetXmax();
+  double u = rand.Uniform();
+  if (u < 0.02) return std::numeric_limits<double>::quiet_NaN();
+  if (u < 0.04) return (u < 0.03 ? -1.0 : 1.0) * std::numeric_limits<double>::infinity();
+  if (u < 0.15) return axis->GetBinLowEdge(rand.Integer(axis->GetNbins() + 1) + 1);
+  return rand.Uniform(lo - 0.1 * (hi - lo), hi + 0.1 * (hi - lo));
+}
+
+// Unit weights first, so TH1::Fill switches to Sumw2 part way through
+double ThrowW(int i, TRandom3& rand) {
+  if (i < 200) return 1.0;
+  return rand.Gaus(1.0, 0.5);
+}
+
+// Contents, errors, statistics and entries must match bit for bit
+bool SameHist(TH1* a, TH1* b) {
+  int ncells = dynamic_cast<TArrayD*>(a)->GetSize();
+  if (dynamic_cast<TArrayD*>(b)->GetSize() != ncells) return false;
+  if (a->GetSumw2N() != b->GetSumw2N()) return false;
+
+  for (int i = 0; i < ncells; i++) {
+    if (a->GetBinContent(i) != b->GetBinContent(i)) return false;
+    if (a->GetSumw2N() and a->GetSumw2()->GetAt(i) != b->GetSumw2()->GetAt(i)) {
+      return false;
+    }
+  }
+
+  double sa[13] = {0.0};
+  double sb[13] = {0.0};
+  a->GetStats(sa);
+  b->GetStats(sb);
+  for (int i = 0; i < 13; i++) {
+    if (sa[i] != sb[i]) return false;
+  }
+
+  return a->GetEntries() == b->GetEntries();
+}
+
+int main(int argc, char const *argv[]) {
+  LOG_VERB(SAM);
+  LOG(FIT) << "*            Running HistAccumulator Tests" << std::endl;
+  LOG(FIT) << "***************************************************"
+           << std::endl;
+
+  TRandom3 rand(4321);
+  int nfill = 20000;
+
+  double varedges[] = {0.0, 0.05, 0.1, 0.101, 0.3, 0.7, 0.71, 1.0, 2.5, 10.0};
+  double emptyedges[] = {0.0, 0.2, 0.2, 0.5, 1.0};
+  double yedges[] = {-1.0, -0.5, 0.0, 0.2, 0.25, 1.0};
+
+  LOG(FIT) << "    *        Test AxisLookup against TAxis::FindBin" << std::endl;
+  {
+    TH1D fixed("fixed", "fixed", 37, -2.0, 3.0);
+    TH1D var("var", "var", 9, varedges);
+    TH1D empty("empty", "empty", 4, emptyedges);
+    TH1D* hists[] = {&fixed, &var, &empty};
+
+    for (int h = 0; h < 3; h++) {
+      AxisLookup lookup;
+      lookup.Setup(hists[h]->GetXaxis());
+      for (int i = 0; i < nfill; i++) {
+        double x = ThrowX(hists[h]->GetXaxis(), rand);
+        assert(lookup.FindBin(x) == hists[h]->GetXaxis()->FindBin(x));
+      }
+    }
+  }
+
+  LOG(FIT) << "    *        Test 1D fills match TH1D::Fill" << std::endl;
+  {
+    TH1D var("var", "var", 9, varedges);
+    TH1D* ref = (TH1D*)var.Clone("ref");
+    TH1D* stat = (TH1D*)var.Clone("stat");
+    TH1D* statref = (TH1D*)var.Clone("statref");
+    TH1D fine("fine", "fine", 72, 0.0, 10.0);
+    TH1D* fineref = (TH1D*)fine.Clone("fineref");
+
+    HistAccumulator acc;
+    acc.Setup(&var);
+    int statslot = acc.Add(stat);
+    HistAccumulator fineacc;
+    fineacc.Setup(&fine);
+
+    // Two passes check Reset and Flush leave the accumulator reusable
+    for (int pass = 0; pass < 2; pass++) {
+      var.Reset();
+      ref->Reset();
+      stat->Reset();
+      statref->Reset();
+      fine.Reset();
+      fineref->Reset();
+      acc.Reset();
+      fineacc.Reset();
+
+      for (int i = 0; i < nfill; i++) {
+        double x = ThrowX(var.GetXaxis(), rand);
+        double w = ThrowW(i, rand);
+
+        ref->Fill(x, w);
+        statref->Fill(x, 1.0);
+        fineref->Fill(x, w);
+
+        int bin = acc.FindBin(x);
+        acc.FillBin(0, bin, x, w);
+        acc.FillBin(statslot, bin, x, 1.0);
+        fineacc.Fill(0, x, w);
+      }
+      acc.Flush();
+      fineacc.Flush();
+
+      assert(SameHist(&var, ref));
+      assert(SameHist(stat, statref));
+      assert(SameHist(&fine, fineref));
+    }
+
+    delete ref;
+    delete stat;
+    delete statref;
+    delete fineref;
+  }
+
+  LOG(FIT) << "    *        Test flush after the stats were reset" << std::endl;
+  {
+    TH1D hist("statreset", "statreset", 9, varedges);
+    for (int i = 0; i < 100; i++) hist.Fill(rand.Uniform(0.0, 10.0), 2.0);
+
+    // Zeroed stats make ROOT rebuild them from the bins, as after ResetStats
+    double zero[13] = {0.0};
+    hist.PutStats(zero);
+
+    HistAccumulator acc;
+    acc.Setup(&hist);
+    for (int i = 0; i < 100; i++) acc.Fill(0, rand.Uniform(0.0, 10.0), 0.5);
+    acc.Flush();
+
+    TH1D* ref = (TH1D*)hist.Clone("statresetref");
+    ref->ResetStats();
+
+    double sa[13] = {0.0};
+    double sb[13] = {0.0};
+    hist.GetStats(sa);
+    ref->GetStats(sb);
+    for (int i = 0; i < 4; i++) {
+      assert(fabs(sa[i] - sb[i]) <= 1E-9 * fabs(sb[i]));
+    }
+    delete ref;
+  }
+
+  LOG(FIT) << "    *        Test 2D fills match TH2D::Fill" << std::endl;
+  {
+    TH2D hist("hist2d", "hist2d", 9, varedges, 5, yedges);
+    TH2D* ref = (TH2D*)hist.Clone("ref2d");
+    TH2D fixed("fixed2d", "fixed2d", 13, 0.0, 10.0, 7, -1.0, 1.0);
+    TH2D* fixedref = (TH2D*)fixed.Clone("fixedref2d");
+
+    HistAccumulator acc;
+    acc.Setup(&hist);
+    HistAccumulator fixedacc;
+    fixedacc.Setup(&fixed);
+
+    for (int i = 0; i < nfill; i++) {
+      double x = ThrowX(hist.GetXaxis(), rand);
+      double y = ThrowX(hist.GetYaxis(), rand);
+      double w = ThrowW(i, rand);
+
+      ref->Fill(x, y, w);
+      fixedref->Fill(x, y, w);
+      acc.Fill(0, x, y, w);
+      fixedacc.Fill(0, x, y, w);
+    }
+    acc.Flush();
+    fixedacc.Flush();
+
+    assert(SameHist(&hist, ref));
+    assert(SameHist(&fixed, fixedref));
+
+    delete ref;
+    delete fixedref;
+  }
+
+  LOG(FIT) << "    *        Test mode stack fills match TH1D::Fill" << std::endl;
+  {
+    TH1D var("varstack", "varstack", 9, varedges);
+    TrueModeStack stack("modestack", "modestack", &var);
+    int nmodes = stack.fAllLabels.size();
+
+    std::vector<TH1D*> refs;
+    for (int i = 0; i < nmodes; i++) {
+      refs.push_back((TH1D*)var.Clone(Form("modestackref_%i", i)));
+    }
+
+    for (int i = 0; i < nfill; i++) {
+      double x = ThrowX(var.GetXaxis(), rand);
+      double w = ThrowW(i, rand);
+      int mode = rand.Integer(121) - 60;
+
+      refs[stack.ConvertModeToIndex(mode)]->Fill(x, w);
+      stack.Fill(mode, x, w);
+    }
+
+    for (int i = 0; i < nmodes; i++) {
+      assert(SameHist(stack.GetHist(i), refs[i]));
+      delete refs[i];
+    }
+  }
+
+  LOG(FIT) << "    *        Timing fill paths" << std::endl;
+  {
+    TH1D var("var", "var", 9, varedges);
+    TH1D stat("stat", "stat", 9, varedges);
+    HistAccumulator acc;
+    acc.Setup(&var);
+    int statslot = acc.Add(&stat);
+
+    int nevt = 2000000;
+    std::vector<double> xs(nevt);
+    for (int i = 0; i < nevt; i++) xs[i] = rand.Uniform(-0.5, 10.5);
+
+    TStopwatch clock;
+    clock.Start();
+    for (int i = 0; i < nevt; i++) {
+      var.Fill(xs[i], 0.5);
+      stat.Fill(xs[i], 1.0);
+    }
+    clock.Stop();
+    double troot = clock.RealTime();
+
+    clock.Start();
+    for (int i = 0; i < nevt; i++) {
+      int bin = acc.FindBin(xs[i]);
+      acc.FillBin(0, bin, xs[i], 0.5);
+      acc.FillBin(statslot, bin, xs[i], 1.0);
+    }
+    acc.Flush();
+    clock.Stop();
+    double tacc = clock.RealTime();
+
+    LOG(FIT) << "        *        " << nevt << " events : TH1::Fill " << troot
+             << " s, accumulator " << tacc << " s" << std::endl;
+  }
+
+  LOG(FIT) << "*            HistAccumulator Tests passed" << std::endl;
+  return 0;
+}
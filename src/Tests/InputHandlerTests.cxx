@@ -0,0 +1,118 @@
+#include <cassert>
+
+#include "FitEvent.h"
+#include "FitLogger.h"
+#include "InputHandler.h"
+#include "NuisConfig.h"
+
+// Minimal handler, only the preselection bookkeeping is exercised
+struct TestInputHandler : public InputHandlerBase {
+  TestInputHandler() { fNUISANCEEvent = new FitEvent(); }
+  ~TestInputHandler() { delete fNUISANCEEvent; }
+  FitEvent* GetNuisanceEvent(const UInt_t entry, const bool lightweight) {
+    (void)entry;
+    (void)lightweight;
+    return fNUISANCEEvent;
+  }
+};
+
+int main(int argc, char const *argv[]) {
+  LOG_VERB(SAM);
+  LOG(FIT) << "*            Running InputHandler Tests" << std::endl;
+  LOG(FIT) << "***************************************************"
+           << std::endl;
+
+  Config::SetPar("input_preselection", true);
+
+  LOG(FIT) << "    *        Test InputPreselection::Accept" << std::endl;
+  InputPreselection any;
+  assert(!any.IsSet());
+  assert(any.Accept(14, 500.0, 1));
+  assert(any.Accept(-12, 1E5, 52));
+
+  InputPreselection numucc;
+  numucc.fNuPDG.push_back(14);
+  numucc.fNC = false;
+  numucc.fEnuMin = 100.0;
+  numucc.fEnuMax = 1000.0;
+  assert(numucc.IsSet());
+  assert(numucc.Accept(14, 500.0, 1));
+  assert(numucc.Accept(14, 100.0, -26));
+  assert(numucc.Accept(14, 1000.0, 30));
+  assert(!numucc.Accept(-14, 500.0, 1));
+  assert(!numucc.Accept(14, 500.0, 31));
+  assert(!numucc.Accept(14, 99.0, 1));
+  assert(!numucc.Accept(14, 1001.0, 1));
+
+  InputPreselection numubarnc;
+  numubarnc.fNuPDG.push_back(-14);
+  numubarnc.fCC = false;
+  assert(numubarnc.Accept(-14, 1E5, -51));
+  assert(!numubarnc.Accept(-14, 500.0, -1));
+
+  LOG(FIT) << "    *        Test the union over users of an input" << std::endl;
+  TestInputHandler input;
+  int usera = 0;
+  int userb = 0;
+  int userc = 0;
+  assert(input.PassesPreselection(-12, 500.0, 1));
+
+  input.SetPreselection(&usera, numucc);
+  input.SetPreselection(&userb, numubarnc);
+  assert(input.PassesPreselection(14, 500.0, 1));
+  assert(input.PassesPreselection(-14, 500.0, 31));
+  assert(!input.PassesPreselection(-14, 500.0, 1));
+  assert(!input.PassesPreselection(12, 500.0, 1));
+
+  LOG(FIT) << "    *        Test PreselectEvent" << std::endl;
+  FitEvent* event = input.fNUISANCEEvent;
+  event->fPreselected = true;
+
+  // Every event is decoded until all users have checked their cuts
+  assert(input.PreselectEvent(-14, 500.0, 1));
+  input.SetPreselectionChecked(&usera);
+  assert(input.PreselectEvent(-14, 500.0, 1));
+  input.SetPreselectionChecked(&userb);
+  assert(input.PreselectEvent(14, 500.0, 1));
+  assert(event->fPreselected);
+
+  // Rejected events keep their header only
+  assert(!input.PreselectEvent(-14, 500.0, 1));
+  assert(!event->fPreselected);
+  assert(event->Mode == 1);
+  assert(event->probe_pdg == -14);
+  assert(event->probe_E == 500.0);
+
+  // A user without cuts needs every event, until it is removed
+  input.SetPreselection(&userc, any);
+  input.SetPreselectionChecked(&userc);
+  assert(input.PreselectEvent(-14, 500.0, 1));
+  input.RemovePreselection(&userc);
+  assert(!input.PreselectEvent(-14, 500.0, 1));
+
+  // New cuts have to be checked again
+  input.SetPreselection(&userb, numubarnc);
+  assert(input.PreselectEvent(-14, 500.0, 1));
+  input.SetPreselectionChecked(&userb);
+  assert(!input.PreselectEvent(-14, 500.0, 1));
+
+  // Unknown users are not recorded as checked
+  input.SetPreselectionChecked(&userc);
+  assert(!input.fPreselectionChecked.count(&userc));
+
+  // With no users left nothing is skipped
+  input.RemovePreselection(&usera);
+  input.RemovePreselection(&userb);
+  assert(input.fPreselections.empty());
+  assert(input.fPreselectionChecked.empty());
+  assert(input.PreselectEvent(-14, 500.0, 1));
+
+  // The config switch turns it off
+  Config::SetPar("input_preselection", false);
+  input.SetPreselection(&usera, numucc);
+  input.SetPreselectionChecked(&usera);
+  assert(input.PreselectEvent(-14, 500.0, 1));
+
+  LOG(FIT) << "*            InputHandler Tests passed" << std::endl;
+  return 0;
+}
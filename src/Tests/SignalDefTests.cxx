@@ -443,5 +443,26 @@ int main(int argc, char const *argv[]) {
     }
   }
 
+  LOG(FIT) << "*            Testing: FitEvent memo" << std::endl;
+
+  // Results are reused per event and argument set until the stack changes
+  double memo = 0.0;
+  assert(SignalDef::isCC0pi(&fe_CC0pi_1, 14));
+  assert(fe_CC0pi_1.GetMemo(kMemoCC0pi, memo, 14));
+  assert(memo == 1.0);
+  assert(!fe_CC0pi_1.GetMemo(kMemoCC0pi, memo, -14));
+  assert(!SignalDef::isCC0pi(&fe_CC0pi_1, -14));
+  assert(fe_CC0pi_1.GetMemo(kMemoCC0pi, memo, -14));
+  assert(memo == 0.0);
+
+  double PionMom[4] = {0, 0, 200, 250};
+  fe_CC0pi_1.AddPart(PionMom, kFinalState, 211);
+  fe_CC0pi_1.OrderStack();
+  assert(!fe_CC0pi_1.GetMemo(kMemoCC0pi, memo, 14));
+  assert(!SignalDef::isCC0pi(&fe_CC0pi_1, 14));
+  assert(SignalDef::isCC1pi(&fe_CC0pi_1, 14, 211));
+
+  LOG(FIT) << "*            SignalDef Tests passed" << std::endl;
+
   // SignalDef::isCCWithFS(&fe,14);
 }
@@ -0,0 +1,380 @@
+#include "Chi2Evaluator.h"
+#include "CovarianceCache.h"
+#include "MVNThrower.h"
+#include "SmearingMatrix.h"
+#include "StatUtils.h"
+
+#include "FitLogger.h"
+#include "NuisConfig.h"
+
+#include "TH1D.h"
+#include "TH1I.h"
+#include "TH2D.h"
+#include "TH2I.h"
+#include "TMatrixDSym.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Inverted covariance in the units the samples use (chi2 = r^T M r * 1E76)
+TMatrixDSym* MakeInvCovar(int nbins, TRandom3& rand) {
+  TMatrixD B(nbins, nbins);
+  for (int i = 0; i < nbins; i++) {
+    for (int j = 0; j < nbins; j++) {
+      B(i, j) = rand.Gaus(0.0, 1.0) / sqrt(double(nbins));
+    }
+  }
+
+  TMatrixDSym* inv = new TMatrixDSym(nbins);
+  for (int i = 0; i < nbins; i++) {
+    for (int j = 0; j <= i; j++) {
+      double val = 0.0;
+      for (int k = 0; k < nbins; k++) val += B(i, k) * B(j, k);
+      if (i == j) val += 1.0;
+      (*inv)(i, j) = val * 1E-76;
+      (*inv)(j, i) = val * 1E-76;
+    }
+  }
+  return inv;
+}
+
+// The scalar double loop GetChi2FromCov used before Chi2Evaluator
+double ReferenceChi2(TH1D* data, TH1D* mc, TMatrixDSym* invcov, TH1I* mask) {
+  TMatrixDSym* calc_cov = mask ? StatUtils::ApplyInvertedMatrixMasking(invcov, mask)
+                          : (TMatrixDSym*)invcov->Clone();
+  TH1D* calc_data = mask ? StatUtils::ApplyHistogramMasking(data, mask)
+                    : (TH1D*)data->Clone();
+  TH1D* calc_mc = mask ? StatUtils::ApplyHistogramMasking(mc, mask)
+                  : (TH1D*)mc->Clone();
+  (*calc_cov) *= 1E76;
+
+  double chi2 = 0.0;
+  for (int i = 0; i < calc_data->GetNbinsX(); i++) {
+    for (int j = 0; j < calc_data->GetNbinsX(); j++) {
+      chi2 += (calc_data->GetBinContent(i + 1) - calc_mc->GetBinContent(i + 1)) *
+              (*calc_cov)(i, j) *
+              (calc_data->GetBinContent(j + 1) - calc_mc->GetBinContent(j + 1));
+    }
+  }
+
+  delete calc_cov;
+  delete calc_data;
+  delete calc_mc;
+  return chi2;
+}
+
+// The Poisson event-rate chi2 summed bin by bin, without cached data terms
+double ReferenceEventRate(TH1* data, TH1* mc) {
+  double chi2 = 0.0;
+  for (int i = 0; i < data->GetNcells(); i++) {
+    double dt = data->GetBinContent(i);
+    double mcval = mc->GetBinContent(i);
+    if (mcval <= 0) continue;
+    if (dt <= 0) chi2 += 2 * (mcval - dt);
+    else chi2 += 2 * (mcval - dt + (dt * log(dt / mcval)));
+  }
+  return chi2;
+}
+
+void FillHists(TH1D* data, TH1D* mc, TRandom3& rand) {
+  for (int i = 0; i < data->GetNbinsX(); i++) {
+    double val = rand.Uniform(1.0, 10.0);
+    data->SetBinContent(i + 1, val);
+    data->SetBinError(i + 1, 0.1 * val);
+    mc->SetBinContent(i + 1, val * rand.Gaus(1.0, 0.1));
+  }
+}
+
+int main(int argc, char const *argv[]) {
+  LOG_VERB(SAM);
+  LOG(FIT) << "*            Running StatUtils Tests" << std::endl;
+  LOG(FIT) << "***************************************************"
+           << std::endl;
+
+  double tol = 1E-12;
+  TRandom3 rand(1234);
+
+  LOG(FIT) << "    *        Test covariance chi2 against scalar loop" << std::endl;
+  int sizes[] = {1, 5, 64, 333};
+  for (int s = 0; s < 4; s++) {
+    int nbins = sizes[s];
+    TH1D data("data", "data", nbins, 0.0, 1.0);
+    TH1D mc("mc", "mc", nbins, 0.0, 1.0);
+    TH1I mask("mask", "mask", nbins, 0.0, 1.0);
+    for (int i = 0; i < nbins; i += 7) mask.SetBinContent(i + 2, 1);
+    TMatrixDSym* invcov = MakeInvCovar(nbins, rand);
+
+    Chi2Evaluator eval;
+    for (int t = 0; t < 3; t++) {
+      FillHists(&data, &mc, rand);
+
+      double ref = ReferenceChi2(&data, &mc, invcov, NULL);
+      double chi2 = StatUtils::GetChi2FromCov(&data, &mc, invcov, NULL);
+      LOG(FIT) << "        *        " << nbins << " bins : " << chi2
+               << " vs " << ref << std::endl;
+      assert(fabs(chi2 - ref) <= tol * fabs(ref));
+
+      // Cached evaluator, setup once and reused as the MC changes
+      if (!eval.IsSetup(Chi2Evaluator::kChi2Cov, 0)) {
+        eval.Setup(Chi2Evaluator::kChi2Cov, 0, &data, invcov, NULL);
+      }
+      // A new generation of the inputs forces a rebuild
+      assert(!eval.IsSetup(Chi2Evaluator::kChi2Cov, 1));
+      assert(!eval.IsSetup(Chi2Evaluator::kChi2Diag, 0));
+      chi2 = eval.Eval(&data, &mc);
+      assert(fabs(chi2 - ref) <= tol * fabs(ref));
+
+      if (nbins < 2) continue;
+      ref = ReferenceChi2(&data, &mc, invcov, &mask);
+      chi2 = StatUtils::GetChi2FromCov(&data, &mc, invcov, &mask);
+      LOG(FIT) << "        *        " << nbins << " bins masked : " << chi2
+               << " vs " << ref << std::endl;
+      assert(fabs(chi2 - ref) <= tol * fabs(ref));
+    }
+
+    delete invcov;
+  }
+
+  LOG(FIT) << "    *        Test shape-only covar is not taken from the cache" << std::endl;
+  {
+    // As Measurement1D with UseShapeCovar: the cache holds fFullCovar while
+    // covar is the inverse of a different (shape-only) matrix
+    int nbins = 12;
+    TH1D data("data", "data", nbins, 0.0, 1.0);
+    TH1D mc("mc", "mc", nbins, 0.0, 1.0);
+    TH1I mask("mask", "mask", nbins, 0.0, 1.0);
+    mask.SetBinContent(4, 1);
+    FillHists(&data, &mc, rand);
+
+    TMatrixDSym* invfull = MakeInvCovar(nbins, rand);
+    TMatrixDSym* full = StatUtils::GetInvert(invfull);
+    TMatrixDSym* invshape = MakeInvCovar(nbins, rand);
+
+    CovarianceCache cache;
+    cache.Setup(1, full, NULL, NULL);
+
+    TH1I* masks[] = {NULL, &mask};
+    for (int m = 0; m < 2; m++) {
+      double ref = StatUtils::GetChi2FromCov(&data, &mc, invshape, masks[m]);
+
+      // Attached to the cache the full covariance wins
+      Chi2Evaluator cached;
+      cached.SetCovarianceCache(&cache);
+      cached.Setup(Chi2Evaluator::kChi2Cov, 1, &data, invshape, masks[m]);
+      assert(fabs(cached.Eval(&data, &mc) - ref) > 1E-6 * fabs(ref));
+
+      Chi2Evaluator shape;
+      shape.Setup(Chi2Evaluator::kChi2Cov, 1, &data, invshape, masks[m]);
+      double chi2 = shape.Eval(&data, &mc);
+      LOG(FIT) << "        *        shape covar : " << chi2 << " vs " << ref << std::endl;
+      assert(fabs(chi2 - ref) <= tol * fabs(ref));
+    }
+
+    delete invfull;
+    delete full;
+    delete invshape;
+  }
+
+  LOG(FIT) << "    *        Test masked diagonal chi2 ignores addmcerror" << std::endl;
+  {
+    int nbins = 10;
+    TH1D data("data", "data", nbins, 0.0, 1.0);
+    TH1D mc("mc", "mc", nbins, 0.0, 1.0);
+    TH1I mask("mask", "mask", nbins, 0.0, 1.0);
+    mask.SetBinContent(3, 1);
+    FillHists(&data, &mc, rand);
+    for (int i = 0; i < nbins; i++) mc.SetBinError(i + 1, 0.2 * mc.GetBinContent(i + 1));
+
+    double refmasked = 0.0;
+    double refmcerr = 0.0;
+    for (int i = 0; i < nbins; i++) {
+      double diff = data.GetBinContent(i + 1) - mc.GetBinContent(i + 1);
+      double dterr = data.GetBinError(i + 1);
+      double mcerr = mc.GetBinError(i + 1);
+      refmcerr += diff * diff / (dterr * dterr + mcerr * mcerr);
+      if (!mask.GetBinContent(i + 1)) refmasked += diff * diff / (dterr * dterr);
+    }
+
+    Config::SetPar("addmcerror", true);
+    double chi2 = StatUtils::GetChi2FromDiag(&data, &mc, NULL);
+    assert(fabs(chi2 - refmcerr) <= tol * fabs(refmcerr));
+    chi2 = StatUtils::GetChi2FromDiag(&data, &mc, &mask);
+    LOG(FIT) << "        *        masked diag : " << chi2 << " vs " << refmasked << std::endl;
+    assert(fabs(chi2 - refmasked) <= tol * fabs(refmasked));
+    Config::SetPar("addmcerror", false);
+  }
+
+  LOG(FIT) << "    *        Test batched toys against the covariance" << std::endl;
+  {
+    int nbins = 12;
+    int ntoys = 20000;
+    TH1D data("data", "data", nbins, 0.0, 1.0);
+    TH1D mc("mc", "mc", nbins, 0.0, 1.0);
+    FillHists(&data, &mc, rand);
+
+    // Covariance in sample units, toys come out in bin units
+    TMatrixDSym* cov = MakeInvCovar(nbins, rand);
+    (*cov) *= 1E76;
+
+    MVNThrower thrower;
+    thrower.SetSeed(42);
+    thrower.Setup(cov, &data);
+
+    std::vector<double> sum(nbins * nbins, 0.0);
+    for (int t = 0; t < ntoys; t++) {
+      thrower.FillHistogram(&mc, &data, thrower.NextToy());
+      for (int i = 0; i < nbins; i++) {
+        double di = mc.GetBinContent(i + 1) - data.GetBinContent(i + 1);
+        for (int j = 0; j < nbins; j++) {
+          sum[i * nbins + j] += di * (mc.GetBinContent(j + 1) - data.GetBinContent(j + 1));
+        }
+      }
+    }
+
+    // Sample covariance agrees to a few standard errors
+    for (int i = 0; i < nbins; i++) {
+      for (int j = 0; j < nbins; j++) {
+        double expect = (*cov)(i, j) * 1E-76;
+        double err = sqrt(((*cov)(i, i) * (*cov)(j, j) * 1E-152 + expect * expect) / ntoys);
+        assert(fabs(sum[i * nbins + j] / ntoys - expect) < 6.0 * err);
+      }
+    }
+
+    // Toy numbers fix the throw, whatever the batch they are thrown in
+    MVNThrower single;
+    single.SetSeed(42);
+    single.Setup(cov, &data);
+    single.ThrowBatch(137, 1);
+    thrower.ThrowBatch(130, 16);
+    for (int i = 0; i < nbins; i++) {
+      assert(single.GetToy(0)[i] == thrower.GetToy(7)[i]);
+    }
+
+    delete cov;
+  }
+
+  LOG(FIT) << "    *        Test sparse smearing against the dense loop" << std::endl;
+  {
+    // Rectangular band matrix, true = row; reco = column
+    int ntrue = 40;
+    int nreco = 30;
+    TMatrixD smear(ntrue, nreco);
+    for (int t = 0; t < ntrue; t++) {
+      for (int r = 0; r < nreco; r++) {
+        if (abs(t - r) <= 2) smear(t, r) = rand.Uniform(0.0, 0.5);
+      }
+    }
+
+    TH1D mc("mc", "mc", ntrue, 0.0, 1.0);
+    for (int t = 0; t < ntrue; t++) mc.SetBinContent(t + 1, rand.Uniform(1.0, 10.0));
+
+    std::vector<double> ref(nreco, 0.0);
+    for (int r = 0; r < nreco; r++) {
+      for (int t = 0; t < ntrue; t++) {
+        ref[r] += smear(t, r) * mc.GetBinContent(t + 1);
+      }
+    }
+
+    SmearingMatrix csr;
+    csr.Setup(&smear);
+    LOG(FIT) << "        *        " << csr.GetNNonZero() << "/" << ntrue * nreco
+             << " non-zero elements" << std::endl;
+    assert(csr.GetNNonZero() < ntrue * nreco / 4);
+
+    csr.Apply(&mc);
+    for (int r = 0; r < nreco; r++) {
+      assert(mc.GetBinContent(r + 1) == ref[r]);
+    }
+    for (int b = nreco + 1; b <= ntrue + 1; b++) {
+      assert(mc.GetBinContent(b) == 0.0);
+    }
+  }
+
+  LOG(FIT) << "    *        Test event rate chi2 against scalar loop" << std::endl;
+  {
+    int nbins = 20;
+    TH1D data("data", "data", nbins, 0.0, 1.0);
+    TH1D mc("mc", "mc", nbins, 0.0, 1.0);
+    FillHists(&data, &mc, rand);
+    data.SetBinContent(3, 0.0);
+
+    Chi2Evaluator eval;
+    eval.Setup(Chi2Evaluator::kChi2EventRate, 0, &data, NULL, NULL);
+    double ref = ReferenceEventRate(&data, &mc);
+    assert(fabs(eval.Eval(&data, &mc) - ref) <= tol * fabs(ref));
+    assert(fabs(StatUtils::GetChi2FromEventRate(&data, &mc, NULL) - ref) <=
+           tol * fabs(ref));
+
+    // Cached data terms follow changed data without a new setup
+    data.SetBinContent(5, 2.5);
+    data.SetBinContent(3, 4.0);
+    ref = ReferenceEventRate(&data, &mc);
+    assert(fabs(eval.Eval(&data, &mc) - ref) <= tol * fabs(ref));
+
+    // The binned likelihood is still a placeholder
+    assert(StatUtils::GetLikelihoodFromEventRate(&data, &mc, NULL) == 0.0);
+
+    TH2D data2("data2", "data2", 4, 0.0, 1.0, 5, 0.0, 1.0);
+    TH2D mc2("mc2", "mc2", 4, 0.0, 1.0, 5, 0.0, 1.0);
+    for (int i = 1; i <= 4; i++) {
+      for (int j = 1; j <= 5; j++) {
+        double val = rand.Uniform(1.0, 10.0);
+        data2.SetBinContent(i, j, val);
+        mc2.SetBinContent(i, j, val * rand.Gaus(1.0, 0.1));
+      }
+    }
+    ref = ReferenceEventRate(&data2, &mc2);
+    double chi2 = StatUtils::GetChi2FromEventRate(&data2, &mc2, NULL, NULL);
+    LOG(FIT) << "        *        2D : " << chi2 << " vs " << ref << std::endl;
+    assert(fabs(chi2 - ref) <= tol * fabs(ref));
+  }
+
+  // Not a pass/fail check, shows how the chi2 scales with bin count
+  LOG(FIT) << "    *        Benchmark covariance chi2" << std::endl;
+  int benchsizes[] = {100, 200, 400, 800, 1600};
+  for (int s = 0; s < 5; s++) {
+    int nbins = benchsizes[s];
+    int ncalls = 2E7 / (nbins * nbins) + 1;
+
+    TH1D data("data", "data", nbins, 0.0, 1.0);
+    TH1D mc("mc", "mc", nbins, 0.0, 1.0);
+    FillHists(&data, &mc, rand);
+    TMatrixDSym* invcov = MakeInvCovar(nbins, rand);
+    (*invcov) *= 1E76;
+
+    TStopwatch clock;
+    double sum = 0.0;
+    clock.Start();
+    for (int c = 0; c < ncalls; c++) {
+      for (int i = 0; i < nbins; i++) {
+        double ri = data.GetBinContent(i + 1) - mc.GetBinContent(i + 1);
+        for (int j = 0; j < nbins; j++) {
+          sum += ri * (*invcov)(i, j) *
+                 (data.GetBinContent(j + 1) - mc.GetBinContent(j + 1));
+        }
+      }
+    }
+    clock.Stop();
+    double tloop = clock.RealTime() / ncalls;
+
+    (*invcov) *= 1E-76;
+    Chi2Evaluator eval;
+    eval.Setup(Chi2Evaluator::kChi2Cov, -1, &data, invcov, NULL);
+    clock.Start();
+    for (int c = 0; c < ncalls; c++) sum += eval.Eval(&data, &mc);
+    clock.Stop();
+    double teval = clock.RealTime() / ncalls;
+
+    LOG(FIT) << "        *        " << nbins << " bins : scalar loop "
+             << tloop * 1E6 << " us, evaluator " << teval * 1E6
+             << " us (" << sum << ")" << std::endl;
+    delete invcov;
+  }
+
+  LOG(FIT) << "*            StatUtils Tests passed" << std::endl;
+  return 0;
+}
@@ -556,7 +556,8 @@ double FitUtils::SumTE_PartVect(std::vector<FitParticle *> const fps) {
 /*
   E Recoil
 */
-double FitUtils::GetErecoil_TRUE(FitEvent *event) {
+// Event level kinematics shared between samples through the FitEvent memo
+static double CalcErecoil_TRUE(FitEvent *event) {
   // Get total energy of hadronic system.
   double Erecoil = 0.0;
   for (unsigned int i = 2; i < event->Npart(); i++) {
@@ -580,7 +581,13 @@ double FitUtils::GetErecoil_TRUE(FitEvent *event) {
   return Erecoil;
 }
 
-double FitUtils::GetErecoil_CHARGED(FitEvent *event) {
+double FitUtils::GetErecoil_TRUE(FitEvent *event) {
+  double memo;
+  if (event->GetMemo(kMemoErecoilTRUE, memo)) return memo;
+  return event->SetMemo(kMemoErecoilTRUE, CalcErecoil_TRUE(event));
+}
+
+static double CalcErecoil_CHARGED(FitEvent *event) {
   // Get total energy of hadronic system.
   double Erecoil = 0.0;
   for (unsigned int i = 2; i < event->Npart(); i++) {
@@ -609,8 +616,14 @@ double FitUtils::GetErecoil_CHARGED(FitEvent *event) {
   return Erecoil;
 }
 
+double FitUtils::GetErecoil_CHARGED(FitEvent *event) {
+  double memo;
+  if (event->GetMemo(kMemoErecoilCHARGED, memo)) return memo;
+  return event->SetMemo(kMemoErecoilCHARGED, CalcErecoil_CHARGED(event));
+}
+
 // MOVE TO MINERVA Utils!
-double FitUtils::GetErecoil_MINERvA_LowRecoil(FitEvent *event) {
+static double CalcErecoil_MINERvA_LowRecoil(FitEvent *event) {
   // Get total energy of hadronic system.
   double Erecoil = 0.0;
 
@@ -644,6 +657,13 @@ double FitUtils::GetErecoil_MINERvA_LowRecoil(FitEvent *event) {
   return Erecoil;
 }
 
+double FitUtils::GetErecoil_MINERvA_LowRecoil(FitEvent *event) {
+  double memo;
+  if (event->GetMemo(kMemoErecoilMINERvALowRecoil, memo)) return memo;
+  return event->SetMemo(kMemoErecoilMINERvALowRecoil,
+                        CalcErecoil_MINERvA_LowRecoil(event));
+}
+
 TVector3 GetVectorInTPlane(const TVector3 &inp, const TVector3 &planarNormal) {
   TVector3 pnUnit = planarNormal.Unit();
   double inpProjectPN = inp.Dot(pnUnit);
@@ -683,7 +703,7 @@ Double_t GetDeltaAlphaT(TVector3 const &V_lepton, TVector3 const &V_other,
   return GetDeltaPhiT(V_lepton, DeltaPT, Normal, PiMinus);
 }
 
-double FitUtils::Get_STV_dpt(FitEvent *event, int ISPDG, bool Is0pi) {
+static double Calc_STV_dpt(FitEvent *event, int ISPDG, bool Is0pi) {
   // Check that the neutrino exists
   if (event->NumISParticle(ISPDG) == 0) {
     return -9999;
@@ -710,7 +730,14 @@ double FitUtils::Get_STV_dpt(FitEvent *event, int ISPDG, bool Is0pi) {
   return GetDeltaPT(LeptonP, HadronP, NuP).Mag();
 }
 
-double FitUtils::Get_STV_dphit(FitEvent *event, int ISPDG, bool Is0pi) {
+double FitUtils::Get_STV_dpt(FitEvent *event, int ISPDG, bool Is0pi) {
+  double memo;
+  if (event->GetMemo(kMemoSTVdpt, memo, ISPDG, Is0pi)) return memo;
+  return event->SetMemo(kMemoSTVdpt, Calc_STV_dpt(event, ISPDG, Is0pi),
+                        ISPDG, Is0pi);
+}
+
+static double Calc_STV_dphit(FitEvent *event, int ISPDG, bool Is0pi) {
   // Check that the neutrino exists
   if (event->NumISParticle(ISPDG) == 0) {
     return -9999;
@@ -736,7 +763,15 @@ double FitUtils::Get_STV_dphit(FitEvent *event, int ISPDG, bool Is0pi) {
   }
   return GetDeltaPhiT(LeptonP, HadronP, NuP);
 }
-double FitUtils::Get_STV_dalphat(FitEvent *event, int ISPDG, bool Is0pi) {
+
+double FitUtils::Get_STV_dphit(FitEvent *event, int ISPDG, bool Is0pi) {
+  double memo;
+  if (event->GetMemo(kMemoSTVdphit, memo, ISPDG, Is0pi)) return memo;
+  return event->SetMemo(kMemoSTVdphit, Calc_STV_dphit(event, ISPDG, Is0pi),
+                        ISPDG, Is0pi);
+}
+
+static double Calc_STV_dalphat(FitEvent *event, int ISPDG, bool Is0pi) {
   // Check that the neutrino exists
   if (event->NumISParticle(ISPDG) == 0) {
     return -9999;
@@ -763,6 +798,13 @@ double FitUtils::Get_STV_dalphat(FitEvent *event, int ISPDG, bool Is0pi) {
   return GetDeltaAlphaT(LeptonP, HadronP, NuP);
 }
 
+double FitUtils::Get_STV_dalphat(FitEvent *event, int ISPDG, bool Is0pi) {
+  double memo;
+  if (event->GetMemo(kMemoSTVdalphat, memo, ISPDG, Is0pi)) return memo;
+  return event->SetMemo(kMemoSTVdalphat, Calc_STV_dalphat(event, ISPDG, Is0pi),
+                        ISPDG, Is0pi);
+}
+
 // Get Cos theta with Adler angles
 double FitUtils::CosThAdler(TLorentzVector Pnu, TLorentzVector Pmu, TLorentzVector Ppi, TLorentzVector Pprot) {
   // Get the "resonance" lorentz vector (pion proton system)
@@ -0,0 +1,221 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "HistAccumulator.h"
+#include "FitLogger.h"
+#include "TArrayD.h"
+
+//*******************************************************************
+AxisLookup::AxisLookup() {
+//*******************************************************************
+  fNBins = 0;
+  fMin = 0.0;
+  fMax = 0.0;
+  fNGrid = 0;
+  fGridScale = 0.0;
+}
+
+//*******************************************************************
+void AxisLookup::Setup(const TAxis* axis) {
+//*******************************************************************
+
+  fNBins = axis->GetNbins();
+  fMin = axis->GetXmin();
+  fMax = axis->GetXmax();
+  fEdges.clear();
+  fGrid.clear();
+  fNGrid = 0;
+  fGridScale = 0.0;
+
+  const TArrayD* xbins = axis->GetXbins();
+  if (!xbins->GetSize()) return;
+
+  fEdges.assign(xbins->GetArray(), xbins->GetArray() + xbins->GetSize());
+
+  double minwidth = fMax - fMin;
+  for (int i = 0; i < fNBins; i++) {
+    minwidth = std::min(minwidth, fEdges[i + 1] - fEdges[i]);
+  }
+  if (!(minwidth > 0.0)) return;
+
+  // Grid cells no wider than the narrowest bin, capped for extreme binnings
+  double ngrid = ceil((fMax - fMin) / minwidth);
+  fNGrid = std::max(fNBins, int(std::min(ngrid, 64.0 * fNBins)));
+  fGridScale = fNGrid / (fMax - fMin);
+
+  fGrid.resize(fNGrid);
+  int bin = 1;
+  for (int g = 0; g < fNGrid; g++) {
+    double low = fMin + g / fGridScale;
+    while (bin < fNBins and low >= fEdges[bin]) bin++;
+    fGrid[g] = bin;
+  }
+}
+
+//*******************************************************************
+HistAccumulator::HistAccumulator() {
+//*******************************************************************
+  fNDim = 0;
+  fNCells = 0;
+}
+
+//*******************************************************************
+void HistAccumulator::Setup(TH1* hist) {
+//*******************************************************************
+
+  fNDim = hist->GetDimension();
+  if (fNDim > 2) {
+    ERR(FTL) << "HistAccumulator only supports 1D and 2D histograms, "
+             << hist->GetName() << " has " << fNDim << " dimensions." << std::endl;
+    throw;
+  }
+
+  fXAxis.Setup(hist->GetXaxis());
+  if (fNDim == 2) fYAxis.Setup(hist->GetYaxis());
+  else fYAxis = AxisLookup();
+
+  int nx = fXAxis.GetNbins() + 2;
+  int ny = (fNDim == 2) ? fYAxis.GetNbins() + 2 : 1;
+  fNCells = nx * ny;
+
+  // Fills in these cells count towards the histogram statistics
+  fInRange.assign(fNCells, 0);
+  for (int i = 1; i < nx - 1; i++) {
+    if (fNDim == 1) {
+      fInRange[i] = 1;
+      continue;
+    }
+    for (int j = 1; j < ny - 1; j++) fInRange[j * nx + i] = 1;
+  }
+
+  fHists.clear();
+  fSumw.clear();
+  fSumw2.clear();
+  fStats.clear();
+  fEntries.clear();
+  fWeighted.clear();
+  Add(hist);
+}
+
+//*******************************************************************
+bool HistAccumulator::SameBinning(TH1* hist) const {
+//*******************************************************************
+
+  if (fHists.empty()) return true;
+  TH1* base = fHists[0];
+  if (hist->GetDimension() != base->GetDimension()) return false;
+
+  for (int d = 0; d < fNDim; d++) {
+    const TAxis* a = d ? hist->GetYaxis() : hist->GetXaxis();
+    const TAxis* b = d ? base->GetYaxis() : base->GetXaxis();
+    if (a->GetNbins() != b->GetNbins() or a->GetXmin() != b->GetXmin() or
+        a->GetXmax() != b->GetXmax()) {
+      return false;
+    }
+
+    const TArrayD* ea = a->GetXbins();
+    const TArrayD* eb = b->GetXbins();
+    if (ea->GetSize() != eb->GetSize()) return false;
+    for (int i = 0; i < ea->GetSize(); i++) {
+      if (ea->GetAt(i) != eb->GetAt(i)) return false;
+    }
+  }
+  return true;
+}
+
+//*******************************************************************
+int HistAccumulator::Add(TH1* hist) {
+//*******************************************************************
+
+  if (!dynamic_cast<TArrayD*>(hist) or !SameBinning(hist)) {
+    ERR(FTL) << "HistAccumulator can only fill TH1D/TH2D histograms sharing "
+             << "one binning, " << hist->GetName() << " does not." << std::endl;
+    throw;
+  }
+
+  fHists.push_back(hist);
+  fSumw.resize(fSumw.size() + fNCells, 0.0);
+  fSumw2.resize(fSumw2.size() + fNCells, 0.0);
+  fStats.resize(fStats.size() + kNStats, 0.0);
+  fEntries.push_back(0.0);
+  fWeighted.push_back(0);
+
+  return fHists.size() - 1;
+}
+
+//*******************************************************************
+TH1* HistAccumulator::GetHist(int slot) const {
+//*******************************************************************
+  if (slot < 0 or slot >= int(fHists.size())) return NULL;
+  return fHists[slot];
+}
+
+//*******************************************************************
+void HistAccumulator::Flush() {
+//*******************************************************************
+
+  for (size_t slot = 0; slot < fHists.size(); slot++) {
+    if (!fEntries[slot]) continue;
+
+    TH1* hist = fHists[slot];
+    double* sumw = &fSumw[slot * fNCells];
+    double* sumw2 = &fSumw2[slot * fNCells];
+
+    // TH1::Fill switches to weighted errors at the first weight other than 1
+    if (!hist->GetSumw2N() and fWeighted[slot] and !hist->TestBit(TH1::kIsNotW)) {
+      hist->Sumw2();
+    }
+
+    // Read the stats first. Once they are reset ROOT rebuilds them from the
+    // bin contents, which must not yet include the pending fills.
+    double stats[13] = {0.0};  // Large enough for any TH1::GetStats layout
+    hist->GetStats(stats);
+
+    double* val = dynamic_cast<TArrayD*>(hist)->GetArray();
+    for (int i = 0; i < fNCells; i++) val[i] += sumw[i];
+
+    if (hist->GetSumw2N()) {
+      double* err = hist->GetSumw2()->GetArray();
+      for (int i = 0; i < fNCells; i++) err[i] += sumw2[i];
+    }
+
+    for (int i = 0; i < kNStats; i++) stats[i] += fStats[slot * kNStats + i];
+    hist->PutStats(stats);
+    hist->SetEntries(hist->GetEntries() + fEntries[slot]);
+
+    std::fill(sumw, sumw + fNCells, 0.0);
+    std::fill(sumw2, sumw2 + fNCells, 0.0);
+    std::fill(&fStats[slot * kNStats], &fStats[slot * kNStats] + kNStats, 0.0);
+    fEntries[slot] = 0.0;
+    fWeighted[slot] = 0;
+  }
+}
+
+//*******************************************************************
+void HistAccumulator::Reset() {
+//*******************************************************************
+  std::fill(fSumw.begin(), fSumw.end(), 0.0);
+  std::fill(fSumw2.begin(), fSumw2.end(), 0.0);
+  std::fill(fStats.begin(), fStats.end(), 0.0);
+  std::fill(fEntries.begin(), fEntries.end(), 0.0);
+  std::fill(fWeighted.begin(), fWeighted.end(), 0);
+}
@@ -0,0 +1,170 @@
+// Copyright 2016 L. Pickering, P Stowell, R. Terri, C. Wilkinson, C. Wret
+
+/*******************************************************************************
+*    This file is part of NUISANCE.
+*
+*    NUISANCE is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU General Public License as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    NUISANCE is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU General Public License for more details.
+*
+*    You should have received a copy of the GNU General Public License
+*    along with NUISANCE.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+#ifndef HISTACCUMULATOR_H
+#define HISTACCUMULATOR_H
+
+#include <vector>
+
+#include "TAxis.h"
+#include "TH1.h"
+#include "TMath.h"
+
+//! Constant time TAxis::FindBin for a fixed axis.
+//!
+//! Uniform axes use the same expression as TAxis. Variable width axes look
+//! up a uniform grid no coarser than the narrowest bin, so at most one edge
+//! comparison is needed either side. Axes with empty bins fall back to the
+//! binary search. Results match TAxis::FindBin exactly, including NaN going
+//! to the overflow bin.
+class AxisLookup {
+public:
+
+  AxisLookup();
+
+  void Setup(const TAxis* axis);
+
+  inline int FindBin(double x) const {
+    if (x < fMin) return 0;
+    if (!(x < fMax)) return fNBins + 1;
+    if (fEdges.empty()) return 1 + int(fNBins * (x - fMin) / (fMax - fMin));
+    if (fGrid.empty()) return 1 + TMath::BinarySearch(fNBins + 1, &fEdges[0], x);
+
+    int g = int((x - fMin) * fGridScale);
+    if (g >= fNGrid) g = fNGrid - 1;
+
+    // fEdges[b - 1] <= x < fEdges[b] for bin b
+    int bin = fGrid[g];
+    while (x >= fEdges[bin]) bin++;
+    while (x < fEdges[bin - 1]) bin--;
+    return bin;
+  };
+
+  inline int GetNbins() const { return fNBins; };
+
+private:
+
+  int fNBins;
+  double fMin;
+  double fMax;
+  std::vector<double> fEdges;  //!< Bin edges, empty for uniform axes
+  std::vector<int> fGrid;      //!< Bin holding the low edge of each grid cell,
+                               //!< empty if a bin has zero width
+  int fNGrid;
+  double fGridScale;           //!< Grid cells per unit x
+};
+
+//! Plain array accumulator for TH1D and TH2D fills sharing one binning.
+//!
+//! Fills go to per histogram sumw, sumw2 and statistics arrays, and the bin
+//! is found once for all histograms filled with the same x (and y). Flush
+//! adds everything into the histograms, giving the same contents, errors,
+//! statistics and entries as filling them directly through TH1::Fill when
+//! the histograms were empty. Statistics skip under and overflow fills, the
+//! ROOT default.
+class HistAccumulator {
+public:
+
+  HistAccumulator();
+
+  //! Take the binning from hist and add it as slot 0. Pending fills are dropped.
+  void Setup(TH1* hist);
+
+  //! Add a histogram with the binning of slot 0, returns its slot
+  int Add(TH1* hist);
+
+  //! Histogram of a slot, NULL if not setup
+  TH1* GetHist(int slot = 0) const;
+
+  inline int GetNSlots() const { return fHists.size(); };
+
+  inline int FindBin(double x) const { return fXAxis.FindBin(x); };
+  inline int FindBin(double x, double y) const {
+    return fYAxis.FindBin(y) * (fXAxis.GetNbins() + 2) + fXAxis.FindBin(x);
+  };
+
+  //! hist->Fill(x, w) for the slot's histogram, bin from FindBin(x)
+  inline void FillBin(int slot, int bin, double x, double w) {
+    if (!FillCell(slot, bin, w)) return;
+    double* st = &fStats[slot * kNStats];
+    st[0] += w;
+    st[1] += w * w;
+    st[2] += w * x;
+    st[3] += w * x * x;
+  };
+
+  //! hist->Fill(x, y, w) for the slot's histogram, bin from FindBin(x, y)
+  inline void FillBin(int slot, int bin, double x, double y, double w) {
+    if (!FillCell(slot, bin, w)) return;
+    double* st = &fStats[slot * kNStats];
+    st[0] += w;
+    st[1] += w * w;
+    st[2] += w * x;
+    st[3] += w * x * x;
+    st[4] += w * y;
+    st[5] += w * y * y;
+    st[6] += w * x * y;
+  };
+
+  inline void Fill(int slot, double x, double w) {
+    FillBin(slot, FindBin(x), x, w);
+  };
+  inline void Fill(int slot, double x, double y, double w) {
+    FillBin(slot, FindBin(x, y), x, y, w);
+  };
+
+  //! Add pending fills into the histograms and clear them
+  void Flush();
+
+  //! Drop pending fills
+  void Reset();
+
+private:
+
+  //! Statistics kept per slot, the TH2 layout of TH1::GetStats
+  static const int kNStats = 7;
+
+  //! Contents and entries of a fill, returns whether the statistics count it
+  inline bool FillCell(int slot, int bin, double w) {
+    int cell = slot * fNCells + bin;
+    fSumw[cell] += w;
+    fSumw2[cell] += w * w;
+    fEntries[slot] += 1.0;
+    if (w != 1.0) fWeighted[slot] = true;
+    return fInRange[bin];
+  };
+
+  //! Whether hist has the binning of slot 0
+  bool SameBinning(TH1* hist) const;
+
+  AxisLookup fXAxis;
+  AxisLookup fYAxis;
+  int fNDim;
+  int fNCells;
+
+  std::vector<char> fInRange;      //!< Cell is not under or overflow
+  std::vector<TH1*> fHists;
+  std::vector<double> fSumw;       //!< Slot major, fNCells per slot
+  std::vector<double> fSumw2;
+  std::vector<double> fStats;      //!< kNStats per slot
+  std::vector<double> fEntries;
+  std::vector<char> fWeighted;     //!< A weight other than 1 was filled
+};
+
+#endif
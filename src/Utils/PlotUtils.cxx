@@ -296,101 +296,118 @@ void PlotUtils::ResetNeutModeArray(TH1* hist[]) {
 };
 
 //********************************************************************
-// This assumes the Enu axis is the x axis, as is the case for MiniBooNE 2D
-// distributions
-void PlotUtils::FluxUnfoldedScaling(TH2D* fMCHist, TH1D* fhist, TH1D* ehist,
-                                    double scalefactor) {
+// Flux content between lo and hi, sharing partially covered flux bins by width
+static double FluxIntegralInRange(TH1D* flux, double lo, double hi) {
   //********************************************************************
 
-  // Make clones to avoid changing stuff
-  TH1D* eventhist = (TH1D*)ehist->Clone();
-  TH1D* fFluxHist = (TH1D*)fhist->Clone();
-
-  // Undo width integral in SF
-  fMCHist->Scale(scalefactor /
-                 eventhist->Integral(1, eventhist->GetNbinsX() + 1, "width"));
+  double fluxint = 0.0;
+  for (int j = 0; j < flux->GetNbinsX(); j++) {
+    double Fl = flux->GetXaxis()->GetBinLowEdge(j + 1);
+    double Fh = flux->GetXaxis()->GetBinLowEdge(j + 2);
+    double Fe = flux->GetBinContent(j + 1);
+    double Fw = flux->GetXaxis()->GetBinWidth(j + 1);
+
+    if (Fl >= lo and Fh <= hi) {
+      fluxint += Fe;
+    } else if (Fl < lo and Fl < hi and Fh > lo and Fh < hi) {
+      fluxint += Fe * (Fh - lo) / Fw;
+    } else if (Fh > hi and Fl < hi and Fh > lo and Fl > lo) {
+      fluxint += Fe * (hi - Fl) / Fw;
+    } else if (lo >= Fl and hi <= Fh) {
+      fluxint += Fe * (hi - lo) / Fw;
+    }
+  }
+  return fluxint;
+}
 
-  // Standardise The Flux
-  eventhist->Scale(1.0 / fFluxHist->Integral());
-  fFluxHist->Scale(1.0 / fFluxHist->Integral());
+//********************************************************************
+// Scale applied to every cell before dividing by the flux in each Enu bin
+static double FluxUnfoldedNorm(TH1D* fhist, TH1D* ehist, double scalefactor) {
+  //********************************************************************
 
-  // Do interpolation for 2D plots?
-  // fFluxHist = PlotUtils::InterpolateFineHistogram(fFluxHist,100,"width");
-  // eventhist = PlotUtils::InterpolateFineHistogram(eventhist,100,"width");
+  // Undo width integral in SF
+  double norm =
+      scalefactor / ehist->Integral(1, ehist->GetNbinsX() + 1, "width");
 
-  // eventhist->Scale(1.0/fFluxHist->Integral());
-  // fFluxHist->Scale(1.0/fFluxHist->Integral());
+  // Scale by the event rate integral of the standardised flux
+  return norm * ehist->Integral(1, ehist->GetNbinsX() + 1) / fhist->Integral();
+}
 
-  // Scale fMCHist by eventhist integral
-  fMCHist->Scale(eventhist->Integral(1, eventhist->GetNbinsX() + 1));
+//********************************************************************
+// This assumes the Enu axis is the x axis, as is the case for MiniBooNE 2D
+// distributions
+std::vector<double> PlotUtils::GetFluxUnfoldedFactors(TH2D* plot, TH1D* fhist,
+                                                      TH1D* ehist,
+                                                      double scalefactor) {
+  //********************************************************************
 
-  // Now Get a flux PDF assuming X axis is Enu
-  TH1D* pdfflux = (TH1D*)fMCHist->ProjectionX()->Clone();
-  //  pdfflux->Write( (std::string(fMCHist->GetName()) + "_PROJX").c_str());
-  pdfflux->Reset();
+  double norm = FluxUnfoldedNorm(fhist, ehist, scalefactor);
+  double fluxnorm = fhist->Integral();
+  std::vector<double> factors(plot->GetSize(), norm);
 
   // Awful MiniBooNE Check for the time being
   bool ismb =
-      std::string(fMCHist->GetName()).find("MiniBooNE") != std::string::npos;
+      std::string(plot->GetName()).find("MiniBooNE") != std::string::npos;
 
-  for (int i = 0; i < pdfflux->GetNbinsX(); i++) {
-    double Ml = pdfflux->GetXaxis()->GetBinLowEdge(i + 1);
-    double Mh = pdfflux->GetXaxis()->GetBinLowEdge(i + 2);
-    // double Mc = pdfflux->GetXaxis()->GetBinCenter(i+1);
-    // double Mw = pdfflux->GetBinWidth(i+1);
-    double fluxint = 0.0;
+  // Flux PDF assuming X axis is Enu
+  for (int i = 0; i < plot->GetNbinsX(); i++) {
+    double Ml = plot->GetXaxis()->GetBinLowEdge(i + 1);
+    double Mh = plot->GetXaxis()->GetBinLowEdge(i + 2);
 
     // Scaling to match flux for MB
     if (ismb) {
       Ml /= 1.E3;
       Mh /= 1.E3;
-      //  Mc /= 1.E3;
-      //  Mw /= 1.E3;
     }
 
-    for (int j = 0; j < fFluxHist->GetNbinsX(); j++) {
-      // double Fc = fFluxHist->GetXaxis()->GetBinCenter(j+1);
-      double Fl = fFluxHist->GetXaxis()->GetBinLowEdge(j + 1);
-      double Fh = fFluxHist->GetXaxis()->GetBinLowEdge(j + 2);
-      double Fe = fFluxHist->GetBinContent(j + 1);
-      double Fw = fFluxHist->GetXaxis()->GetBinWidth(j + 1);
-
-      if (Fl >= Ml and Fh <= Mh) {
-        fluxint += Fe;
-      } else if (Fl < Ml and Fl < Mh and Fh > Ml and Fh < Mh) {
-        fluxint += Fe * (Fh - Ml) / Fw;
-      } else if (Fh > Mh and Fl < Mh and Fh > Ml and Fl > Ml) {
-        fluxint += Fe * (Mh - Fl) / Fw;
-      } else if (Ml >= Fl and Mh <= Fh) {
-        fluxint += Fe * (Mh - Ml) / Fw;
-      } else {
-        continue;
-      }
-    }
+    double fluxint = FluxIntegralInRange(fhist, Ml, Mh) / fluxnorm;
+    if (fluxint == 0.0) continue;
 
-    pdfflux->SetBinContent(i + 1, fluxint);
+    for (int j = 0; j < plot->GetNbinsY(); j++) {
+      double binWidth = plot->GetYaxis()->GetBinLowEdge(j + 2) -
+                        plot->GetYaxis()->GetBinLowEdge(j + 1);
+      factors[plot->GetBin(i + 1, j + 1)] = norm / fluxint / binWidth;
+    }
   }
 
-  for (int i = 0; i < fMCHist->GetNbinsX(); i++) {
-    for (int j = 0; j < fMCHist->GetNbinsY(); j++) {
-      if (pdfflux->GetBinContent(i + 1) == 0.0) continue;
-
-      double binWidth = fMCHist->GetYaxis()->GetBinLowEdge(j + 2) -
-                        fMCHist->GetYaxis()->GetBinLowEdge(j + 1);
-      fMCHist->SetBinContent(i + 1, j + 1,
-                             fMCHist->GetBinContent(i + 1, j + 1) /
-                                 pdfflux->GetBinContent(i + 1) / binWidth);
-      fMCHist->SetBinError(i + 1, j + 1, fMCHist->GetBinError(i + 1, j + 1) /
-                                             pdfflux->GetBinContent(i + 1) /
-                                             binWidth);
+  return factors;
+}
+
+//********************************************************************
+void PlotUtils::FluxUnfoldedScaling(TH2D* fMCHist, TH1D* fhist, TH1D* ehist,
+                                    double scalefactor) {
+  //********************************************************************
+  ScaleByBinFactors(fMCHist,
+                    GetFluxUnfoldedFactors(fMCHist, fhist, ehist, scalefactor));
+};
+
+//********************************************************************
+void PlotUtils::ScaleByBinFactors(TH1* hist,
+                                  const std::vector<double>& factors) {
+  //********************************************************************
+
+  if (!hist->GetSumw2N()) hist->Sumw2();
+  int ncells = factors.size();
+
+  // Double histograms are scaled in place, anything else bin by bin
+  TArrayD* cells = dynamic_cast<TArrayD*>(hist);
+  if (!cells) {
+    for (int i = 0; i < ncells; i++) {
+      hist->SetBinContent(i, hist->GetBinContent(i) * factors[i]);
+      hist->SetBinError(i, hist->GetBinError(i) * factors[i]);
     }
+    return;
   }
 
-  delete eventhist;
-  delete fFluxHist;
+  double* val = cells->GetArray();
+  double* err = hist->GetSumw2()->GetArray();
+  for (int i = 0; i < ncells; i++) {
+    val[i] *= factors[i];
+    err[i] *= factors[i] * factors[i];
+  }
 
-  return;
-};
+  hist->ResetStats();
+}
 
 TH1D* PlotUtils::InterpolateFineHistogram(TH1D* hist, int res,
                                           std::string opt) {
@@ -432,19 +449,38 @@ TH1D* PlotUtils::InterpolateFineHistogram(TH1D* hist, int res,
 //********************************************************************
 // This interpolates the flux by a TGraph instead of requiring the flux and MC
 // flux to have the same binning
+std::vector<double> PlotUtils::GetFluxUnfoldedFactors(TH1D* plot, TH1D* fhist,
+                                                      TH1D* ehist,
+                                                      double scalefactor) {
+  //********************************************************************
+
+  double norm = FluxUnfoldedNorm(fhist, ehist, scalefactor);
+  double fluxnorm = fhist->Integral();
+  std::vector<double> factors(plot->GetSize(), norm);
+
+  // Divide by the flux PDF in each bin
+  for (int i = 0; i < plot->GetNbinsX(); i++) {
+    double Ml = plot->GetXaxis()->GetBinLowEdge(i + 1);
+    double Mh = plot->GetXaxis()->GetBinLowEdge(i + 2);
+
+    double fluxint = FluxIntegralInRange(fhist, Ml, Mh) / fluxnorm;
+    if (fluxint != 0.0) factors[i + 1] = norm / fluxint;
+  }
+
+  return factors;
+}
+
+//********************************************************************
 void PlotUtils::FluxUnfoldedScaling(TH1D* mcHist, TH1D* fhist, TH1D* ehist,
                                     double scalefactor, int nevents) {
   //********************************************************************
 
-  TH1D* eventhist = (TH1D*)ehist->Clone();
-  TH1D* fFluxHist = (TH1D*)fhist->Clone();
-
   if (FitPar::Config().GetParB("save_flux_debug")) {
     std::string name = std::string(mcHist->GetName());
 
     mcHist->Write((name + "_UNF_MC").c_str());
-    fFluxHist->Write((name + "_UNF_FLUX").c_str());
-    eventhist->Write((name + "_UNF_EVT").c_str());
+    fhist->Write((name + "_UNF_FLUX").c_str());
+    ehist->Write((name + "_UNF_EVT").c_str());
 
     TH1D* scalehist = new TH1D("scalehist", "scalehist", 1, 0.0, 1.0);
     scalehist->SetBinContent(1, scalefactor);
@@ -453,66 +489,8 @@ void PlotUtils::FluxUnfoldedScaling(TH1D* mcHist, TH1D* fhist, TH1D* ehist,
     scalehist->Write((name + "_UNF_SCALE").c_str());
   }
 
-  // Undo width integral in SF
-  mcHist->Scale(scalefactor /
-                eventhist->Integral(1, eventhist->GetNbinsX() + 1, "width"));
-
-  // Standardise The Flux
-  eventhist->Scale(1.0 / fFluxHist->Integral());
-  fFluxHist->Scale(1.0 / fFluxHist->Integral());
-
-  // Scale mcHist by eventhist integral
-  mcHist->Scale(eventhist->Integral(1, eventhist->GetNbinsX() + 1));
-
-  // Now Get a flux PDF
-  TH1D* pdfflux = (TH1D*)mcHist->Clone();
-  pdfflux->Reset();
-
-  for (int i = 0; i < mcHist->GetNbinsX(); i++) {
-    double Ml = mcHist->GetXaxis()->GetBinLowEdge(i + 1);
-    double Mh = mcHist->GetXaxis()->GetBinLowEdge(i + 2);
-    // double Mc = mcHist->GetXaxis()->GetBinCenter(i+1);
-    // double Me = mcHist->GetBinContent(i+1);
-    // double Mw = mcHist->GetBinWidth(i+1);
-    double fluxint = 0.0;
-
-    for (int j = 0; j < fFluxHist->GetNbinsX(); j++) {
-      // double Fc = fFluxHist->GetXaxis()->GetBinCenter(j+1);
-      double Fl = fFluxHist->GetXaxis()->GetBinLowEdge(j + 1);
-      double Fh = fFluxHist->GetXaxis()->GetBinLowEdge(j + 2);
-      double Fe = fFluxHist->GetBinContent(j + 1);
-      double Fw = fFluxHist->GetXaxis()->GetBinWidth(j + 1);
-
-      if (Fl >= Ml and Fh <= Mh) {
-        fluxint += Fe;
-      } else if (Fl < Ml and Fl < Mh and Fh > Ml and Fh < Mh) {
-        fluxint += Fe * (Fh - Ml) / Fw;
-      } else if (Fh > Mh and Fl < Mh and Fh > Ml and Fl > Ml) {
-        fluxint += Fe * (Mh - Fl) / Fw;
-      } else if (Ml >= Fl and Mh <= Fh) {
-        fluxint += Fe * (Mh - Ml) / Fw;
-      } else {
-        continue;
-      }
-    }
-
-    pdfflux->SetBinContent(i + 1, fluxint);
-  }
-
-  // Scale MC hist by pdfflux
-  for (int i = 0; i < mcHist->GetNbinsX(); i++) {
-    if (pdfflux->GetBinContent(i + 1) == 0.0) continue;
-
-    mcHist->SetBinContent(
-        i + 1, mcHist->GetBinContent(i + 1) / pdfflux->GetBinContent(i + 1));
-    mcHist->SetBinError(
-        i + 1, mcHist->GetBinError(i + 1) / pdfflux->GetBinContent(i + 1));
-  }
-
-  delete eventhist;
-  delete fFluxHist;
-
-  return;
+  ScaleByBinFactors(mcHist,
+                    GetFluxUnfoldedFactors(mcHist, fhist, ehist, scalefactor));
 };
 
 // MOVE TO GENERAL UTILS
@@ -145,6 +145,21 @@ void FluxUnfoldedScaling(TH1D* plot, TH1D* flux, TH1D* events = NULL,
 void FluxUnfoldedScaling(TH2D* plot, TH1D* flux, TH1D* events = NULL,
                          double scalefactor = 1.0);
 
+//! Per global bin factors FluxUnfoldedScaling multiplies contents and errors
+//! by. They only depend on the binning, flux and event rate so samples can
+//! compute them once and apply them with ScaleByBinFactors.
+std::vector<double> GetFluxUnfoldedFactors(TH1D* plot, TH1D* flux,
+                                           TH1D* events,
+                                           double scalefactor = 1.0);
+
+//! Per global bin flux unfolding factors for 2D histograms, Enu on x
+std::vector<double> GetFluxUnfoldedFactors(TH2D* plot, TH1D* flux,
+                                           TH1D* events,
+                                           double scalefactor = 1.0);
+
+//! Multiply each cell content and error by factors[global bin]
+void ScaleByBinFactors(TH1* hist, const std::vector<double>& factors);
+
 //! Fill a 2D Histogram from a text file
 void Set2DHistFromText(std::string dataFile, TH2* hist, double norm,
                        bool skipbins = false);
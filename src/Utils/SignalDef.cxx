@@ -21,8 +21,10 @@
 
 #include "SignalDef.h"
 
+// Signal definitions called by many samples on the same event are evaluated
+// once per event through the FitEvent memo, keyed by their arguments.
 
-bool SignalDef::isCCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
+static bool CalcCCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
 
   // Check for the desired PDG code
   if (!event->HasISParticle(nuPDG)) return false;
@@ -40,7 +42,14 @@ bool SignalDef::isCCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax
   return true;
 }
 
-bool SignalDef::isNCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
+bool SignalDef::isCCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
+  double memo;
+  if (event->GetMemo(kMemoCCINC, memo, nuPDG, EnuMin, EnuMax)) return memo;
+  return event->SetMemo(kMemoCCINC, CalcCCINC(event, nuPDG, EnuMin, EnuMax),
+                        nuPDG, EnuMin, EnuMax);
+}
+
+static bool CalcNCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
 
   // Check for the desired PDG code before and after the interaction
   if (!event->HasISParticle(nuPDG) ||
@@ -54,8 +63,15 @@ bool SignalDef::isNCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax
   return true;
 }
 
+bool SignalDef::isNCINC(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
+  double memo;
+  if (event->GetMemo(kMemoNCINC, memo, nuPDG, EnuMin, EnuMax)) return memo;
+  return event->SetMemo(kMemoNCINC, CalcNCINC(event, nuPDG, EnuMin, EnuMax),
+                        nuPDG, EnuMin, EnuMax);
+}
+
 
-bool SignalDef::isCC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax){
+static bool CalcCC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax){
 
   // Check it's CCINC
   if (!SignalDef::isCCINC(event, nuPDG, EnuMin, EnuMax)) return false;
@@ -69,7 +85,14 @@ bool SignalDef::isCC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax
   return true;
 }
 
-bool SignalDef::isNC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax){
+bool SignalDef::isCC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
+  double memo;
+  if (event->GetMemo(kMemoCC0pi, memo, nuPDG, EnuMin, EnuMax)) return memo;
+  return event->SetMemo(kMemoCC0pi, CalcCC0pi(event, nuPDG, EnuMin, EnuMax),
+                        nuPDG, EnuMin, EnuMax);
+}
+
+static bool CalcNC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax){
 
   // Check it's NCINC
   if (!SignalDef::isNCINC(event, nuPDG, EnuMin, EnuMax)) return false;
@@ -83,6 +106,13 @@ bool SignalDef::isNC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax
   return true;
 }
 
+bool SignalDef::isNC0pi(FitEvent *event, int nuPDG, double EnuMin, double EnuMax) {
+  double memo;
+  if (event->GetMemo(kMemoNC0pi, memo, nuPDG, EnuMin, EnuMax)) return memo;
+  return event->SetMemo(kMemoNC0pi, CalcNC0pi(event, nuPDG, EnuMin, EnuMax),
+                        nuPDG, EnuMin, EnuMax);
+}
+
 
 bool SignalDef::isCCQE(FitEvent *event, int nuPDG, double EnuMin, double EnuMax){
 
@@ -119,7 +149,7 @@ bool SignalDef::isCCQELike(FitEvent *event, int nuPDG, double EnuMin, double Enu
 }
 
 // Require one meson, one charged lepton. types specified in the arguments
-bool SignalDef::isCC1pi(FitEvent *event, int nuPDG, int piPDG,
+static bool CalcCC1pi(FitEvent *event, int nuPDG, int piPDG,
 			double EnuMin, double EnuMax){
 
   // First, make sure it's CCINC
@@ -138,9 +168,19 @@ bool SignalDef::isCC1pi(FitEvent *event, int nuPDG, int piPDG,
   return true;
 }
 
+bool SignalDef::isCC1pi(FitEvent *event, int nuPDG, int piPDG,
+			double EnuMin, double EnuMax) {
+  double memo;
+  if (event->GetMemo(kMemoCC1pi, memo, nuPDG, piPDG, EnuMin, EnuMax)) {
+    return memo;
+  }
+  return event->SetMemo(kMemoCC1pi, CalcCC1pi(event, nuPDG, piPDG, EnuMin, EnuMax),
+                        nuPDG, piPDG, EnuMin, EnuMax);
+}
+
 // Require one meson, one neutrino. Types specified as arguments
-bool SignalDef::isNC1pi(FitEvent *event, int nuPDG, int piPDG,
-                        double EnuMin, double EnuMax){
+static bool CalcNC1pi(FitEvent *event, int nuPDG, int piPDG,
+                      double EnuMin, double EnuMax){
 
   // First, make sure it's NCINC
   if (!SignalDef::isNCINC(event, nuPDG, EnuMin, EnuMax)) return false;
@@ -158,6 +198,16 @@ bool SignalDef::isNC1pi(FitEvent *event, int nuPDG, int piPDG,
   return true;
 }
 
+bool SignalDef::isNC1pi(FitEvent *event, int nuPDG, int piPDG,
+                        double EnuMin, double EnuMax) {
+  double memo;
+  if (event->GetMemo(kMemoNC1pi, memo, nuPDG, piPDG, EnuMin, EnuMax)) {
+    return memo;
+  }
+  return event->SetMemo(kMemoNC1pi, CalcNC1pi(event, nuPDG, piPDG, EnuMin, EnuMax),
+                        nuPDG, piPDG, EnuMin, EnuMax);
+}
+
 // A slightly ugly function to replace the BC 2pi channels.
 // All particles which are allowed in the final state are specified
 bool SignalDef::isCCWithFS(FitEvent *event, int nuPDG, std::vector<int> pdgs,
@@ -243,7 +293,7 @@ bool SignalDef::isNCCOH(FitEvent *event, int nuPDG, int piPDG, double EnuMin, do
 }
 
 
-bool SignalDef::HasProtonKEAboveThreshold(FitEvent* event, double threshold){
+static bool CalcProtonKEAboveThreshold(FitEvent* event, double threshold){
 
   for (uint i = 0; i < event->Npart(); i++){
     FitParticle* p = event->PartInfo(i);
@@ -256,7 +306,14 @@ bool SignalDef::HasProtonKEAboveThreshold(FitEvent* event, double threshold){
 
 }
 
-bool SignalDef::HasProtonMomAboveThreshold(FitEvent* event, double threshold){
+bool SignalDef::HasProtonKEAboveThreshold(FitEvent* event, double threshold) {
+  double memo;
+  if (event->GetMemo(kMemoProtonKEAboveThreshold, memo, threshold)) return memo;
+  return event->SetMemo(kMemoProtonKEAboveThreshold, CalcProtonKEAboveThreshold(event, threshold),
+                        threshold);
+}
+
+static bool CalcProtonMomAboveThreshold(FitEvent* event, double threshold){
 
   for (uint i = 0; i < event->Npart(); i++){
     FitParticle* p = event->PartInfo(i);
@@ -268,6 +325,15 @@ bool SignalDef::HasProtonMomAboveThreshold(FitEvent* event, double threshold){
   return false;
 }
 
+bool SignalDef::HasProtonMomAboveThreshold(FitEvent* event, double threshold) {
+  double memo;
+  if (event->GetMemo(kMemoProtonMomAboveThreshold, memo, threshold)) {
+    return memo;
+  }
+  return event->SetMemo(kMemoProtonMomAboveThreshold, CalcProtonMomAboveThreshold(event, threshold),
+                        threshold);
+}
+
 // Calculate the angle between the neutrino and an outgoing particle, apply a cut
 bool SignalDef::IsRestrictedAngle(FitEvent* event, int nuPDG, int otherPDG, double angle){
 